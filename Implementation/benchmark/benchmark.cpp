@@ -1,27 +1,39 @@
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <iomanip>
+#include <latch>
 #include <random>
 #include <string>
 #include <chrono>
+#include <filesystem>
+#include <thread>
 #include "benchmark.h"
 #include "data_structures.h"
 #include "benchmark_util.h"
+#include "key_file.h"
 
 constexpr char kUsageMsg[] =
-        "usage: %s [-h] -b benchmark -s size [-i number_iterations] [-d] [--only structure_list] [--skip structure_list] [--seed seed_number] [-v]\n";
+        "usage: %s [-h] -b benchmark (-s size | --keys file) [--lookups file] [-i number_iterations] [-d] [-t threads] [--read-ratio percent] [--single-writer] [--ops number_operations | --duration seconds] [--only structure_list] [--skip structure_list] [--seed seed_number] [-v]\n";
 constexpr char kHelpMsg[] = "This program benchmarks different indexing structures using 32 bit unsigned integers. "
         "For the specified benchmark and size the benchmark is run number_iterations times for each "
         "index structure and the min, max and average times are outputted.\n\n"
-        "usage: %s [-h] -b benchmark -s size [-i number_iterations] [-d] [--only structure_list] [--skip structure_list] [--seed seed_number] [-v]\n"
+        "usage: %s [-h] -b benchmark (-s size | --keys file) [--lookups file] [-i number_iterations] [-d] [-t threads] [--read-ratio percent] [--single-writer] [--ops number_operations | --duration seconds] [--only structure_list] [--skip structure_list] [--seed seed_number] [-v]\n"
         "\nThe parameters in detail:\n"
         "\t-h\t\t\t\t: Shows how to use the program (this text).\n"
-        "\t-b <insert/search/range_search>\t: Specifies the benchmark to run. You can either benchmark insertion, searching or searching in range.\n"
+        "\t-b <insert/search/range_search/mixed/load>\t: Specifies the benchmark to run. You can either benchmark insertion, searching, searching in range, a concurrent mix of insertions and searches or loading a saved structure from a file. Structures that can't be saved are skipped when loading.\n"
         "\t-s <1/2/3>\t\t\t: Specifies the benchmark size. Options are 1 with 65 thousand integers, 2 with 16 million integers and 3 with 256 million integers.\n"
+        "\t--keys <file>\t\t\t: Uses the keys of a binary file of 32 bit unsigned integers in native byte order (optionally prefixed by their 64 bit count like the SOSD datasets) instead of generated ones. The file is memory-mapped and every iteration copies the keys before anything is measured. Replaces -s and -d.\n"
+        "\t--lookups <file>\t\t: Uses the keys of a file in the same format as lookups for the search benchmark or as pairs of range bounds for the range_search benchmark. Otherwise lookups are drawn from the inserted keys (search) or generated (range_search).\n"
         "\t-i <number>\t\t\t: Specifies the number of iterations the benchmark is run. Default value is %u. Should be an integer between 1 and 10000 (inclusive).\n"
         "\t-d\t\t\t\t: Use a dense (from 0 up to number of elements - 1) set of integers as keys. Otherwise a sparse (uniform random 32 bit integer) set will be used.\n"
-        "\t--only <structure_list>\t\t\t: Specifies index structures to be used during this benchmark. Given as comma separated list of names (ART, ART (Exp), ART (Leis), Trie, M-Trie, H-Trie, Sorted List, Hash-Table, RB-Tree). If not set all index structures will be used.\n"
-        "\t--skip <structure_list>\t\t\t: Specifies index structures to be skipped during this benchmark. Given as comma separated list of names (ART, ART (Exp), ART (Leis), Trie, M-Trie, H-Trie, Sorted List, Hash-Table, RB-Tree).\n"
+        "\t-t <threads>\t\t\t: Specifies the number of pinned threads sharing one structure in the mixed benchmark. Default value is 1. Structures that aren't thread-safe are skipped.\n"
+        "\t--read-ratio <percent>\t\t: Specifies the percentage of searches in the mixed benchmark. The remaining operations insert new keys. Default value is %u.\n"
+        "\t--single-writer\t\t\t: Runs the mixed benchmark with a single inserting thread while all other threads only search. Structures that don't support a concurrent writer are skipped.\n"
+        "\t--ops <number>\t\t\t: Specifies the number of operations per thread in the mixed benchmark. Defaults to the number of keys divided by the number of threads.\n"
+        "\t--duration <seconds>\t\t: Runs the mixed benchmark for a fixed duration instead of a fixed number of operations.\n"
+        "\t--only <structure_list>\t\t\t: Specifies index structures to be used during this benchmark. Given as comma separated list of names (ART, ART (Exp), ART (Batch), ART (Gather), ART (Coro), ART (Parallel), ART (Locked), ART (SWMR), ART (Static), ART (Virtual), ART (Tagged), ART (Mapped), ART (Persistent), ART (Leis), Trie, M-Trie, H-Trie, Sorted List, Hash-Table, RB-Tree). If not set all index structures will be used.\n"
+        "\t--skip <structure_list>\t\t\t: Specifies index structures to be skipped during this benchmark. Given as comma separated list of names (ART, ART (Exp), ART (Batch), ART (Gather), ART (Coro), ART (Parallel), ART (Locked), ART (SWMR), ART (Static), ART (Virtual), ART (Tagged), ART (Mapped), ART (Persistent), ART (Leis), Trie, M-Trie, H-Trie, Sorted List, Hash-Table, RB-Tree).\n"
         "\t--seed <seed_number>\t\t\t: Use deterministic values by starting first benchmark iteration with a given seed and all subsequent iterations with increasing seeds. If not set all iterations will use a random seed.\n"
         "\t-v\t\t\t\t: Enable verbose logging.\n";
 
@@ -30,9 +42,18 @@ constexpr char kHelpMsg[] = "This program benchmarks different indexing structur
  * and it's own Benchmark object.
  */
 const std::vector<std::tuple<std::string, uint8_t, Benchmark*>> kIndexStructures{
-        {"ART", 2, new ArtBenchmark()},
-        {"ART (Virt)", 1, new ArtVirtBenchmark()},
-        {"ART (CRTP)", 1, new ArtCRTPBenchmark()},
+        {"ART", 2, new ArtBenchmark<>()},
+        {"ART (Batch)", 1, new ArtBatchBenchmark()},
+        {"ART (Gather)", 1, new ArtGatherBenchmark()},
+        {"ART (Coro)", 1, new ArtCoroutineBenchmark()},
+        {"ART (Parallel)", 1, new ArtParallelBenchmark()},
+        {"ART (Locked)", 1, new ArtLockedBenchmark()},
+        {"ART (SWMR)", 1, new ArtSwmrBenchmark()},
+        {"ART (Static)", 1, new ArtBenchmark<art::StaticDispatch>()},
+        {"ART (Virtual)", 1, new ArtBenchmark<art::VirtualDispatch>()},
+        {"ART (Tagged)", 1, new ArtBenchmark<art::TaggedDispatch>()},
+        {"ART (Mapped)", 1, new ArtMappedBenchmark()},
+        {"ART (Persistent)", 0, new ArtPersistentBenchmark()},
         {"ART (Leis)", 1, new ArtLeisBenchmark()},
         //{"Trie", 2, new TrieBenchmark()},
         //{"M-Trie", 2, new MTrieBenchmark()},
@@ -43,12 +64,18 @@ const std::vector<std::tuple<std::string, uint8_t, Benchmark*>> kIndexStructures
 };
 
 constexpr uint32_t kDefaultIterations{3};
+constexpr uint32_t kDefaultReadRatio{90};
+
+// number of operations between two checks of the stop flag in duration based mixed benchmarks
+constexpr uint32_t kStopCheckInterval{256};
 
 enum class BenchmarkTypes
 {
     kInsert,
     kSearch,
-    kRangeSearch
+    kRangeSearch,
+    kMixed,
+    kLoad
 };
 
 /**
@@ -63,30 +90,54 @@ bool dense = false;
 bool custom_seed = false;
 bool verbose = false;
 
+/**
+ * Keys and lookups read from files instead of being generated (--keys, --lookups).
+ */
+std::string keys_path;
+std::string lookups_path;
+KeyFile key_file;
+KeyFile lookup_file;
+
+/**
+ * Mixed Benchmark Parameters.
+ */
+uint32_t thread_count{1};
+uint32_t read_ratio{kDefaultReadRatio};
+bool single_writer = false;
+uint64_t operations = 0;
+double duration = 0.0;
+
 size_t seed = -1;
 
 #ifdef TRACK_MEMORY
 
+/**
+ * Counts the allocated and freed bytes. The counters are atomic since the structures using a thread pool (e.g.
+ * ART (Parallel)) allocate from its workers.
+ */
 struct MemoryAllocator
 {
-    uint64_t total_allocated = 0;
-    uint64_t total_freed = 0;
+    std::atomic<uint64_t> total_allocated = 0;
+    std::atomic<uint64_t> total_freed = 0;
 
     uint64_t GetMemoryUsage() const
     {
-        return total_allocated - total_freed;
+        return total_allocated.load(std::memory_order_relaxed) - total_freed.load(std::memory_order_relaxed);
     }
 
     void Reset()
     {
-        if (total_allocated - total_freed != 0)
+        const uint64_t allocated = total_allocated.load(std::memory_order_relaxed);
+        const uint64_t freed = total_freed.load(std::memory_order_relaxed);
+
+        if (allocated - freed != 0)
         {
-            std::cerr << "\033[1;31mPossible Memory Leak detected! total_allocated: " << total_allocated << ", total_freed: " << total_freed
-                    << ", Difference: " << total_allocated - total_freed << "\033[0m" << std::endl;
+            std::cerr << "\033[1;31mPossible Memory Leak detected! total_allocated: " << allocated << ", total_freed: " << freed
+                    << ", Difference: " << allocated - freed << "\033[0m" << std::endl;
         }
 
-        total_allocated = 0;
-        total_freed = 0;
+        total_allocated.store(0, std::memory_order_relaxed);
+        total_freed.store(0, std::memory_order_relaxed);
     }
 };
 
@@ -94,20 +145,46 @@ static MemoryAllocator memory_allocator;
 
 void* operator new(size_t size)
 {
-    memory_allocator.total_allocated += size;
+    memory_allocator.total_allocated.fetch_add(size, std::memory_order_relaxed);
 
     return malloc(size);
 }
 
 void operator delete(void* memory, size_t size)
 {
-    memory_allocator.total_freed += size;
+    memory_allocator.total_freed.fetch_add(size, std::memory_order_relaxed);
 
     free(memory);
 }
 
 #endif
 
+/**
+ * Describes where the keys of the benchmark come from for its start and end messages.
+ */
+std::string KeysToString()
+{
+    std::stringstream s;
+
+    if (key_file.IsOpen())
+        s << "keys from '" << keys_path << "' (" << number_elements << " keys)";
+    else
+        s << "size '" << size << "' (" << number_elements << " keys)";
+
+    return s.str();
+}
+
+std::string KeyKindToString()
+{
+    if (key_file.IsOpen())
+        return lookup_file.IsOpen() ? "'file' keys and lookups" : "'file' keys";
+
+    if (lookup_file.IsOpen())
+        return std::string(dense ? "'dense'" : "'sparse'") + " keys and lookups from '" + lookups_path + "'";
+
+    return dense ? "'dense' keys" : "'sparse' keys";
+}
+
 void GenerateRandomNumbers(std::vector<uint32_t>& numbers, std::vector<uint32_t>& search_numbers)
 {
     std::random_device rnd;
@@ -117,14 +194,37 @@ void GenerateRandomNumbers(std::vector<uint32_t>& numbers, std::vector<uint32_t>
     std::uniform_int_distribution<uint32_t> numbers_distr(0, s);
     std::uniform_int_distribution<uint32_t> search_numbers_distr(0, number_elements - 1);
 
-    numbers.reserve(number_elements);
+    if (key_file.IsOpen())
+    {
+        // copying from the mapping only reads the file the first time (afterwards it's in the page cache)
+        numbers.assign(key_file.GetKeys().begin(), key_file.GetKeys().end());
+    }
+    else
+    {
+        numbers.reserve(number_elements);
+
+        for (uint32_t i = 0; i < number_elements; ++i)
+        {
+            numbers.push_back(numbers_distr(eng));
+        }
+    }
 
-    for (uint32_t i = 0; i < number_elements; ++i)
+    if (lookup_file.IsOpen() && benchmark == BenchmarkTypes::kSearch)
     {
-        numbers.push_back(numbers_distr(eng));
+        search_numbers.assign(lookup_file.GetKeys().begin(), lookup_file.GetKeys().end());
     }
+    else if (lookup_file.IsOpen() && benchmark == BenchmarkTypes::kRangeSearch)
+    {
+        const auto lookups = lookup_file.GetKeys();
+        search_numbers.reserve(lookups.size() / 2 * 2);
 
-    if (benchmark == BenchmarkTypes::kSearch)
+        for (size_t i = 0; i + 1 < lookups.size(); i += 2)
+        {
+            search_numbers.push_back(std::min(lookups[i], lookups[i + 1]));
+            search_numbers.push_back(std::max(lookups[i], lookups[i + 1]));
+        }
+    }
+    else if (benchmark == BenchmarkTypes::kSearch)
     {
         search_numbers.reserve(number_elements);
 
@@ -216,6 +316,28 @@ auto RunBenchmarkIteration()
                 std::chrono::nanoseconds>(std::chrono::system_clock::now() - t1).count()) / 1e9;
 #endif
         }
+        else if (benchmark == BenchmarkTypes::kLoad)
+        {
+            // only reading the file into a new structure is measured
+            const auto path = std::filesystem::temp_directory_path() / "index_structure_benchmark.bin";
+            if (!structure->Save(path))
+                std::cerr << "Failed to save " << name << " to " << path << "." << std::endl;
+
+            structure->DeleteStructure();
+            structure->InitializeStructure();
+
+            t1 = std::chrono::system_clock::now();
+            if (!structure->Load(path))
+                std::cerr << "Failed to load " << name << " from " << path << "." << std::endl;
+#ifdef TRACK_MEMORY
+            memory_used = static_cast<double>(memory_allocator.GetMemoryUsage());
+#else
+            time_spent = static_cast<double>(std::chrono::duration_cast<
+                std::chrono::nanoseconds>(std::chrono::system_clock::now() - t1).count()) / 1e9;
+#endif
+
+            std::filesystem::remove(path);
+        }
 
         if (verbose)
             std::cout << "Finished " << name << " in " << std::fixed << std::setprecision(1)
@@ -235,6 +357,289 @@ auto RunBenchmarkIteration()
     return structure_times;
 }
 
+/**
+ * Single operation of the mixed benchmark.
+ */
+struct MixedOperation
+{
+    uint32_t key;
+    bool insert;
+};
+
+/**
+ * Generates the operations of every thread for the mixed benchmark.
+ *
+ * Searches look up keys of the preloaded first half of numbers while insertions add keys of the second half
+ * (distributed among the threads). In single writer mode the first thread only inserts and all others only search.
+ */
+void GenerateMixedOperations(const std::vector<uint32_t>& numbers, std::vector<std::vector<MixedOperation>>& thread_operations)
+{
+    std::mt19937_64 eng(seed);
+    std::uniform_int_distribution<uint32_t> ratio_distr(0, 99);
+    std::uniform_int_distribution<size_t> search_distr(0, numbers.size() / 2 - 1);
+
+    const size_t insert_count = numbers.size() - numbers.size() / 2;
+    const uint64_t operation_count = operations != 0 ? operations : std::max<uint64_t>(numbers.size() / thread_count, 1);
+
+    thread_operations.resize(thread_count);
+
+    for (uint32_t t = 0; t < thread_count; ++t)
+    {
+        auto& ops = thread_operations[t];
+        ops.reserve(operation_count);
+
+        const uint32_t insert_stride = single_writer ? 1 : thread_count;
+
+        size_t next_insert = single_writer ? 0 : t;
+        for (uint64_t i = 0; i < operation_count; ++i)
+        {
+            const bool search = single_writer ? t != 0 : ratio_distr(eng) < read_ratio;
+
+            if (search)
+            {
+                ops.push_back({numbers[search_distr(eng)], false});
+            }
+            else
+            {
+                ops.push_back({numbers[numbers.size() / 2 + next_insert % insert_count], true});
+                next_insert += insert_stride;
+            }
+        }
+    }
+}
+
+/**
+ * Runs the operations of all threads concurrently on a structure.
+ * Returns the aggregated M Ops/s followed by the M Ops/s of every thread.
+ */
+std::vector<double> RunMixedOperations(Benchmark* structure, const std::vector<std::vector<MixedOperation>>& thread_operations)
+{
+    std::vector<uint64_t> completed(thread_count);
+    std::vector<double> seconds(thread_count);
+    std::atomic<bool> stop{false};
+    std::latch start{thread_count + 1};
+
+    const uint32_t cpu_count = std::max(std::thread::hardware_concurrency(), 1U);
+
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count);
+
+    for (uint32_t t = 0; t < thread_count; ++t)
+    {
+        threads.emplace_back([&, t]
+        {
+            PinThread(t % cpu_count);
+
+            const auto& ops = thread_operations[t];
+            uint64_t i = 0;
+
+            start.arrive_and_wait();
+            const auto t0 = std::chrono::system_clock::now();
+
+            if (duration > 0.0)
+            {
+                // cycle through the operations until the time is up
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    for (uint32_t j = 0; j < kStopCheckInterval; ++j, ++i)
+                    {
+                        const auto& op = ops[i % ops.size()];
+                        if (op.insert)
+                            structure->ConcurrentInsert(op.key);
+                        else
+                            structure->ConcurrentSearch(op.key);
+                    }
+                }
+            }
+            else
+            {
+                for (; i < ops.size(); ++i)
+                {
+                    if (ops[i].insert)
+                        structure->ConcurrentInsert(ops[i].key);
+                    else
+                        structure->ConcurrentSearch(ops[i].key);
+                }
+            }
+
+            seconds[t] = static_cast<double>(std::chrono::duration_cast<
+                std::chrono::nanoseconds>(std::chrono::system_clock::now() - t0).count()) / 1e9;
+            completed[t] = i;
+        });
+    }
+
+    start.arrive_and_wait();
+    const auto t0 = std::chrono::system_clock::now();
+
+    if (duration > 0.0)
+    {
+        std::this_thread::sleep_for(std::chrono::duration<double>(duration));
+        stop.store(true, std::memory_order_relaxed);
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    const double wall_time = static_cast<double>(std::chrono::duration_cast<
+        std::chrono::nanoseconds>(std::chrono::system_clock::now() - t0).count()) / 1e9;
+
+    std::vector<double> results(thread_count + 1);
+    uint64_t total = 0;
+    for (uint32_t t = 0; t < thread_count; ++t)
+    {
+        total += completed[t];
+        results[t + 1] = static_cast<double>(completed[t]) / seconds[t] / 1e6;
+    }
+    results[0] = static_cast<double>(total) / wall_time / 1e6;
+
+    return results;
+}
+
+auto RunMixedBenchmarkIteration()
+{
+    std::vector<std::vector<double>> structure_results(kIndexStructures.size());
+
+    std::vector<uint32_t> numbers;
+    std::vector<uint32_t> search_numbers;
+    std::vector<std::vector<MixedOperation>> thread_operations;
+
+    GenerateRandomNumbers(numbers, search_numbers);
+    GenerateMixedOperations(numbers, thread_operations);
+
+    const std::vector preload(numbers.begin(), numbers.begin() + numbers.size() / 2);
+
+    if (verbose)
+        std::cout << "Finished allocating Memory for Numbers and Operations." << std::endl;
+
+    for (uint32_t i = 0; i < kIndexStructures.size(); ++i)
+    {
+        const auto& [name, _, structure] = kIndexStructures[i];
+
+        if (skip.contains(name)) continue;
+
+        const auto t0 = std::chrono::system_clock::now();
+
+        structure->InitializeStructure();
+        structure->Insert(preload);
+
+        structure_results[i] = RunMixedOperations(structure, thread_operations);
+
+        if (verbose)
+            std::cout << "Finished " << name << " in " << std::fixed << std::setprecision(1)
+                    << static_cast<double>(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now() - t0).count())
+                    / 60 << " minutes." << std::endl;
+
+        structure->DeleteStructure();
+    }
+
+    return structure_results;
+}
+
+void RunMixedBenchmark()
+{
+    // need at least one preloaded key to search for
+    number_elements = std::max(number_elements, 2U);
+
+    auto workload_to_string = []
+    {
+        std::stringstream s;
+        if (single_writer)
+            s << thread_count << "' threads (single writer) and ";
+        else
+            s << thread_count << "' threads, '" << read_ratio << "%' searches and ";
+        if (duration > 0.0)
+            s << "a duration of '" << duration << "' seconds";
+        else
+            s << "'" << (operations != 0 ? operations : std::max<uint64_t>(number_elements / thread_count, 1))
+                    << "' operations per thread";
+        return s.str();
+    };
+
+    const auto t1 = std::chrono::system_clock::now();
+
+    std::cout << "Starting 'mixed' benchmark with " << KeysToString() << ", '"
+            << iterations << "' iterations, '" << workload_to_string() << " and " << KeyKindToString()
+            << "." << std::endl;
+
+    // [structure][iteration][aggregate, thread 0, thread 1, ...]
+    std::vector structure_results(kIndexStructures.size(), std::vector<std::vector<double>>(iterations));
+
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        if (verbose)
+            std::cout << "\nRunning iteration " << (i + 1) << "/" << iterations << " with seed " << seed << "..." << std::endl;
+        else
+            std::cout << '\r' << "Running iteration " << (i + 1) << "/" << iterations << " with seed " << seed << "..." << std::flush;
+
+        auto results = RunMixedBenchmarkIteration();
+
+        for (uint32_t j = 0; j < kIndexStructures.size(); ++j)
+            structure_results[j][i] = std::move(results[j]);
+    }
+
+    const auto time = static_cast<double>(std::chrono::duration_cast<
+        std::chrono::seconds>(std::chrono::system_clock::now() - t1).count()) / 60;
+    std::cout << "\nFinished 'mixed' benchmark with " << KeysToString() << ", '"
+            << iterations << "' iterations, '" << workload_to_string() << " and " << KeyKindToString()
+            << " in " << std::fixed << std::setprecision(1) << time << " minutes.\n" << std::endl;
+
+    std::cout << "=================================================================================================================" <<
+            std::endl;
+    std::cout << "\t\t\t\t\tMIXED BENCHMARK RESULTS" << std::endl;
+    std::cout << "=================================================================================================================" <<
+            std::endl;
+
+    std::cout << "Index Structure\t| M Ops/s (Min)\t| M Ops/s (Max)\t| M Ops/s (Avg)\t| M Ops/s (Med)\t|" << std::endl;
+    std::cout << "-----------------------------------------------------------------------------------------------------------------" <<
+            std::endl;
+
+    auto print_statistics = [](std::vector<double> values)
+    {
+        std::ranges::sort(values);
+
+        double sum = 0.0;
+        for (const auto& v : values)
+            sum += v;
+
+        const double med = values.size() % 2 == 1
+                               ? values[values.size() / 2]
+                               : (values[values.size() / 2 - 1] + values[values.size() / 2]) / 2.0;
+
+        std::cout << "|" << FormatTime(values.front(), false) << FormatTime(values.back(), false)
+                << FormatTime(sum / values.size(), false) << FormatTime(med, false) << std::endl;
+    };
+
+    for (uint32_t i = 0; i < kIndexStructures.size(); ++i)
+    {
+        const auto& [name, spacing, structure] = kIndexStructures[i];
+
+        if (!skip.contains(name))
+        {
+            // column 0 holds the aggregated throughput, column t + 1 the one of thread t
+            for (uint32_t c = 0; c <= thread_count; ++c)
+            {
+                std::vector<double> values(iterations);
+                for (uint32_t j = 0; j < iterations; ++j)
+                    values[j] = structure_results[i][j][c];
+
+                if (c == 0)
+                {
+                    std::cout << name;
+                    for (uint8_t j = 0; j < spacing; ++j)
+                        std::cout << "\t";
+                }
+                else
+                    std::cout << "  Thread " << (c - 1) << "\t";
+
+                print_statistics(std::move(values));
+            }
+        }
+
+        // Delete Structure Benchmark
+        delete structure;
+    }
+}
+
 void RunBenchmark()
 {
     auto benchmark_to_string = []
@@ -247,6 +652,10 @@ void RunBenchmark()
                 return "search";
             case BenchmarkTypes::kRangeSearch:
                 return "range_search";
+            case BenchmarkTypes::kMixed:
+                return "mixed";
+            case BenchmarkTypes::kLoad:
+                return "load";
         }
 
         __unreachable();
@@ -261,14 +670,32 @@ void RunBenchmark()
             number_elements = 16'000'000;
             break;
         case 3:
-            number_elements = 1;
+            number_elements = 256'000'000;
+            break;
+        default:
+            // keys from a file
+            number_elements = key_file.GetKeys().size();
+    }
+
+#ifndef TRACK_MEMORY
+    // lookups from a file may differ in number from the keys
+    uint64_t number_operations = number_elements;
+    if (lookup_file.IsOpen() && benchmark == BenchmarkTypes::kSearch)
+        number_operations = lookup_file.GetKeys().size();
+    else if (lookup_file.IsOpen() && benchmark == BenchmarkTypes::kRangeSearch)
+        number_operations = lookup_file.GetKeys().size() / 2;
+#endif
+
+    if (benchmark == BenchmarkTypes::kMixed)
+    {
+        RunMixedBenchmark();
+        return;
     }
 
     const auto t1 = std::chrono::system_clock::now();
 
-    std::cout << "Starting '" << benchmark_to_string() << "' benchmark with size '" << size << "' (" << number_elements
-            << " keys), '" << iterations << "' iterations and '" << (dense ? "dense" : "sparse") << "' keys." <<
-            std::endl;
+    std::cout << "Starting '" << benchmark_to_string() << "' benchmark with " << KeysToString() << ", '" << iterations
+            << "' iterations and " << KeyKindToString() << "." << std::endl;
 
     std::vector structure_times(kIndexStructures.size(), std::vector<double>(iterations));
 
@@ -288,11 +715,9 @@ void RunBenchmark()
 
     const auto time = static_cast<double>(std::chrono::duration_cast<
         std::chrono::seconds>(std::chrono::system_clock::now() - t1).count()) / 60;
-    std::cout << "\nFinished '" << benchmark_to_string() << "' benchmark with size '" << size << "' (" << number_elements
-            << " keys), '" <<
-            iterations << "' iterations and '" << (dense ? "dense" : "sparse") << "' keys in " << std::fixed
-            << std::setprecision(1) << time << " minutes.\n"
-            << std::endl;
+    std::cout << "\nFinished '" << benchmark_to_string() << "' benchmark with " << KeysToString() << ", '" << iterations
+            << "' iterations and " << KeyKindToString() << " in " << std::fixed << std::setprecision(1) << time
+            << " minutes.\n" << std::endl;
 
 #ifdef TRACK_MEMORY
     std::cout << "=================================================================================================================" <<
@@ -346,8 +771,8 @@ void RunBenchmark()
                 << FormatMemory(static_cast<uint64_t>(avg)) << FormatMemory(static_cast<uint64_t>(med))
                 << std::endl;
 #else
-        const double avg_ops = number_elements / avg / 1e6;
-        const double med_ops = number_elements / med / 1e6;
+        const double avg_ops = number_operations / avg / 1e6;
+        const double med_ops = number_operations / med / 1e6;
 
         std::cout << "|"
                 << FormatTime(min, true) << FormatTime(max, true)
@@ -365,7 +790,7 @@ int main(int argc, char* argv[])
 {
     if (CmdArgExists(argv, argv + argc, "-h"))
     {
-        printf(kHelpMsg, argv[0], kDefaultIterations);
+        printf(kHelpMsg, argv[0], kDefaultIterations, kDefaultReadRatio);
         return EXIT_SUCCESS;
     }
 
@@ -381,15 +806,20 @@ int main(int argc, char* argv[])
     char* only_arg = GetCmdArg(argv, argv + argc, "--only");
     char* skip_arg = GetCmdArg(argv, argv + argc, "--skip");
     char* seed_arg = GetCmdArg(argv, argv + argc, "--seed");
-
-    if (benchmark_arg == nullptr || size_arg == nullptr)
+    char* threads_arg = GetCmdArg(argv, argv + argc, "-t");
+    char* read_ratio_arg = GetCmdArg(argv, argv + argc, "--read-ratio");
+    char* ops_arg = GetCmdArg(argv, argv + argc, "--ops");
+    char* duration_arg = GetCmdArg(argv, argv + argc, "--duration");
+    char* keys_arg = GetCmdArg(argv, argv + argc, "--keys");
+    char* lookups_arg = GetCmdArg(argv, argv + argc, "--lookups");
+
+    if (benchmark_arg == nullptr || (size_arg == nullptr) == (keys_arg == nullptr))
     {
         fprintf(stderr, kUsageMsg, argv[0]);
         return EXIT_FAILURE;
     }
 
     const std::string benchmark_str{benchmark_arg};
-    const std::string size_str{size_arg};
 
     /*
     const std::string benchmark_str{"insert"};
@@ -413,29 +843,78 @@ int main(int argc, char* argv[])
         skip.insert("H-Trie");
         skip.insert("Hash-Table");
     }
+    else if (benchmark_str == "mixed")
+    {
+#ifdef TRACK_MEMORY
+        std::cerr << "The 'mixed' benchmark is not supported when tracking memory." << std::endl;
+        return EXIT_FAILURE;
+#endif
+        benchmark = BenchmarkTypes::kMixed;
+    }
+    else if (benchmark_str == "load")
+    {
+        benchmark = BenchmarkTypes::kLoad;
+    }
     else
     {
         std::cerr << "Unknown 'benchmark' argument \"" << benchmark_str <<
-                R"(". Possible options are "insert", "search" and "range_search".)" << std::endl;
+                R"(". Possible options are "insert", "search", "range_search", "mixed" and "load".)" << std::endl;
         return EXIT_FAILURE;
     }
 
-    try
+    if (size_arg != nullptr)
     {
-        size = std::stoul(size_str);
+        const std::string size_str{size_arg};
+
+        try
+        {
+            size = std::stoul(size_str);
+        }
+        catch (std::logic_error&)
+        {
+            std::cerr << "Invalid 'size' argument \"" << size << R"(". Possible options are "1", "2", "3".)"
+                    << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        if (size < 1 || size > 3)
+        {
+            std::cerr << "Invalid 'size' argument \"" << size << R"(". Possible options are "1", "2", "3".)"
+                    << std::endl;
+            return EXIT_FAILURE;
+        }
     }
-    catch (std::logic_error&)
+
+    if (keys_arg != nullptr)
     {
-        std::cerr << "Invalid 'size' argument \"" << size << R"(". Possible options are "1", "2", "3".)"
-                << std::endl;
-        return EXIT_FAILURE;
+        keys_path = keys_arg;
+
+        if (!key_file.Open(keys_path) || key_file.GetKeys().size() > UINT32_MAX)
+        {
+            std::cerr << "Invalid 'keys' argument \"" << keys_path
+                    << "\". Expected a non-empty file of at most 2^32 - 1 32 bit unsigned integers." << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        if (CmdArgExists(argv, argv + argc, "-d"))
+        {
+            std::cerr << "The '-d' option can't be combined with keys from a file." << std::endl;
+            return EXIT_FAILURE;
+        }
     }
 
-    if (size < 1 || size > 3)
+    if (lookups_arg != nullptr)
     {
-        std::cerr << "Invalid 'size' argument \"" << size << R"(". Possible options are "1", "2", "3".)"
-                << std::endl;
-        return EXIT_FAILURE;
+        lookups_path = lookups_arg;
+
+        if (!lookup_file.Open(lookups_path) ||
+            (benchmark == BenchmarkTypes::kRangeSearch && lookup_file.GetKeys().size() < 2))
+        {
+            std::cerr << "Invalid 'lookups' argument \"" << lookups_path
+                    << "\". Expected a non-empty file of 32 bit unsigned integers (at least a pair for range_search)."
+                    << std::endl;
+            return EXIT_FAILURE;
+        }
     }
 
     if (iterations_arg != nullptr)
@@ -523,8 +1002,125 @@ int main(int argc, char* argv[])
         seed--;
     }
 
+    if (threads_arg != nullptr)
+    {
+        const std::string threads_str{threads_arg};
+
+        try
+        {
+            thread_count = std::stoul(threads_str);
+        }
+        catch (std::logic_error&)
+        {
+            std::cerr << "Invalid 'threads' argument \"" << threads_str
+                    << "\". Expected integer between 1 and 1024 (inclusive)." << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        if (thread_count < 1 || thread_count > 1024)
+        {
+            std::cerr << "Invalid 'threads' argument \"" << threads_str
+                    << "\". Expected integer between 1 and 1024 (inclusive)." << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (read_ratio_arg != nullptr)
+    {
+        const std::string read_ratio_str{read_ratio_arg};
+
+        try
+        {
+            read_ratio = std::stoul(read_ratio_str);
+        }
+        catch (std::logic_error&)
+        {
+            std::cerr << "Invalid 'read-ratio' argument \"" << read_ratio_str
+                    << "\". Expected integer between 0 and 100 (inclusive)." << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        if (read_ratio > 100)
+        {
+            std::cerr << "Invalid 'read-ratio' argument \"" << read_ratio_str
+                    << "\". Expected integer between 0 and 100 (inclusive)." << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (ops_arg != nullptr)
+    {
+        const std::string ops_str{ops_arg};
+
+        try
+        {
+            operations = std::stoull(ops_str);
+        }
+        catch (std::logic_error&)
+        {
+            std::cerr << "Invalid 'ops' argument \"" << ops_str << "\". Expected positive integer." << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        if (operations < 1)
+        {
+            std::cerr << "Invalid 'ops' argument \"" << ops_str << "\". Expected positive integer." << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (duration_arg != nullptr)
+    {
+        const std::string duration_str{duration_arg};
+
+        try
+        {
+            duration = std::stod(duration_str);
+        }
+        catch (std::logic_error&)
+        {
+            std::cerr << "Invalid 'duration' argument \"" << duration_str << "\". Expected positive number of seconds." << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        if (duration <= 0.0)
+        {
+            std::cerr << "Invalid 'duration' argument \"" << duration_str << "\". Expected positive number of seconds." << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
     dense = CmdArgExists(argv, argv + argc, "-d");
     verbose = CmdArgExists(argv, argv + argc, "-v");
+    single_writer = CmdArgExists(argv, argv + argc, "--single-writer");
+
+    if (benchmark == BenchmarkTypes::kMixed)
+    {
+        // skip structures not supporting the requested concurrent access
+        for (const auto& [name, _, structure] : kIndexStructures)
+        {
+            if (single_writer ? structure->IsSingleWriterSafe() : structure->IsThreadSafe()) continue;
+
+            skip.insert(name);
+
+            if (verbose)
+                std::cout << "Skipping " << name << " since it doesn't support " << (single_writer ? "a concurrent writer." : "concurrent writers.")
+                        << std::endl;
+        }
+    }
+    else if (benchmark == BenchmarkTypes::kLoad)
+    {
+        // skip structures that can't be written to a file
+        for (const auto& [name, _, structure] : kIndexStructures)
+        {
+            if (structure->IsPersistent()) continue;
+
+            skip.insert(name);
+
+            if (verbose)
+                std::cout << "Skipping " << name << " since it can't be saved to a file." << std::endl;
+        }
+    }
 
     /*
     dense = false;
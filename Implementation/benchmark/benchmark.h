@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <string>
 #include <vector>
 
 class Benchmark
@@ -16,4 +18,62 @@ public:
     virtual void Search(const std::vector<uint32_t>& numbers) = 0;
 
     virtual void RangeSearch(const std::vector<uint32_t>& numbers) = 0;
+
+    /**
+     * Returns true if the structure supports concurrent ConcurrentInsert and ConcurrentSearch calls from multiple
+     * threads. Structures which are not thread-safe are skipped in the mixed benchmark.
+     */
+    virtual bool IsThreadSafe() const
+    {
+        return false;
+    }
+
+    /**
+     * Returns true if a single thread calling ConcurrentInsert may run concurrently to any number of threads calling
+     * ConcurrentSearch. Only these structures are benchmarked in the single writer mode of the mixed benchmark.
+     */
+    virtual bool IsSingleWriterSafe() const
+    {
+        return IsThreadSafe();
+    }
+
+    /**
+     * Inserts a single key. Only called concurrently if IsThreadSafe (or IsSingleWriterSafe) returns true.
+     */
+    virtual void ConcurrentInsert(uint32_t)
+    {
+    }
+
+    /**
+     * Searches a single key. Only called concurrently if IsThreadSafe (or IsSingleWriterSafe) returns true.
+     */
+    virtual bool ConcurrentSearch(uint32_t)
+    {
+        return false;
+    }
+
+    /**
+     * Returns true if the structure can be written to and read from a file. Structures which are not persistent are
+     * skipped in the load benchmark.
+     */
+    virtual bool IsPersistent() const
+    {
+        return false;
+    }
+
+    /**
+     * Writes the structure to a file. Only called if IsPersistent returns true.
+     */
+    virtual bool Save(const std::string&)
+    {
+        return false;
+    }
+
+    /**
+     * Replaces the (empty) structure by the one written to the file by Save. Only called if IsPersistent returns true.
+     */
+    virtual bool Load(const std::string&)
+    {
+        return false;
+    }
 };
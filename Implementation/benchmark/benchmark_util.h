@@ -4,6 +4,14 @@
 #include <iomanip>
 #include <string>
 #include <cmath>
+#include <cstdint>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#endif
 
 inline std::string FormatTime(const double n, const bool unit)
 {
@@ -55,3 +63,18 @@ inline bool CmdArgExists(char** begin, char** end, const std::string& arg)
 {
     return std::find(begin, end, arg) != end;
 }
+
+/**
+ * Pins the calling thread to a logical CPU (no-op on platforms without affinity support).
+ */
+inline void PinThread(const uint32_t cpu)
+{
+#ifdef _WIN32
+    SetThreadAffinityMask(GetCurrentThread(), 1ULL << (cpu % 64));
+#elif defined(__linux__)
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu % CPU_SETSIZE, &cpu_set);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+#endif
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * Read-only memory mapping of a binary file of 32 bit unsigned integers in native byte order, either a plain array or
+ * prefixed by their 64 bit count like the SOSD datasets. Pages are read on demand, so opening even large files is
+ * cheap and the keys are only read when copied out of the mapping.
+ */
+class KeyFile
+{
+public:
+    KeyFile() = default;
+
+    ~KeyFile()
+    {
+        if (data_ != nullptr)
+            munmap(data_, size_);
+    }
+
+    KeyFile(const KeyFile&) = delete;
+
+    KeyFile& operator=(const KeyFile&) = delete;
+
+    /**
+     * Maps the file. Returns false if it couldn't be mapped or its size isn't a multiple of 4 bytes (after the
+     * optional count).
+     */
+    bool Open(const std::string& path)
+    {
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+            return false;
+
+        struct stat status{};
+        if (fstat(fd, &status) != 0 || status.st_size == 0)
+        {
+            close(fd);
+            return false;
+        }
+
+        size_ = status.st_size;
+        void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+
+        if (data == MAP_FAILED)
+            return false;
+
+        data_ = data;
+        madvise(data_, size_, MADV_SEQUENTIAL);
+
+        // a SOSD file starts with the number of keys following it
+        uint64_t count = 0;
+        if (size_ >= sizeof(count))
+            memcpy(&count, data_, sizeof(count));
+
+        const size_t offset = size_ >= sizeof(count) && (size_ - sizeof(count)) % sizeof(uint32_t) == 0 &&
+                              count == (size_ - sizeof(count)) / sizeof(uint32_t)
+                                  ? sizeof(count)
+                                  : 0;
+
+        if ((size_ - offset) % sizeof(uint32_t) != 0)
+            return false;
+
+        keys_ = {reinterpret_cast<const uint32_t*>(static_cast<const char*>(data_) + offset),
+                 (size_ - offset) / sizeof(uint32_t)};
+
+        return true;
+    }
+
+    bool IsOpen() const
+    {
+        return !keys_.empty();
+    }
+
+    std::span<const uint32_t> GetKeys() const
+    {
+        return keys_;
+    }
+
+private:
+    void* data_ = nullptr;
+    size_t size_ = 0;
+    std::span<const uint32_t> keys_;
+};
@@ -0,0 +1,980 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "benchmark_util.h"
+#include "../data_structures/art/art.h"
+#include "../data_structures/art/durable_art.h"
+#include "../data_structures/art/paged_art.h"
+#include "../data_structures/art/node/node.h"
+#include "../data_structures/art/node/simd.h"
+
+constexpr uint32_t kDefaultIterations{10};
+
+// small enough for all nodes to stay cache resident so only the node kernels are measured
+constexpr uint32_t kNodeCount{1024};
+constexpr uint32_t kQueryCount{1 << 22};
+
+// number of distinct 16 bit dictionary codes stored by the key width benchmark
+constexpr uint32_t kCodeCount{1 << 15};
+
+// number of keys inserted by the durability benchmark (small since every insert may be flushed to disk)
+constexpr uint32_t kDurableKeyCount{1 << 16};
+
+// keys in the tree when the checkpoint of the checkpoint benchmark starts and keys inserted afterward
+constexpr uint32_t kCheckpointTreeKeyCount{1 << 22};
+constexpr uint32_t kCheckpointInsertCount{1 << 21};
+
+// keys of the paged tree and lookups per memory budget (few since most of them read a page from disk)
+constexpr uint32_t kPagedKeyCount{1 << 22};
+constexpr uint32_t kPagedLookupCount{1 << 15};
+
+// keys of the trees saved and exported by the export benchmark
+constexpr uint32_t kExportKeyCount{1 << 22};
+
+// keys inserted by the change feed benchmark and changes read per call by its consumer
+constexpr uint32_t kFeedKeyCount{1 << 22};
+constexpr uint32_t kFeedBatchSize{1024};
+
+// nodes of the default tree configuration
+using Config = art::TreeConfig<uint32_t, art::SwitchDispatch>;
+using Node = art::Node<Config>;
+using Node16 = art::Node16<Config>;
+
+constexpr auto kUsageMsg = "usage: %s [-h] [-i number_iterations] [--seed seed_number]\n";
+constexpr auto kHelpMsg =
+        "usage: %s [-h] [-i number_iterations] [--seed seed_number]\n"
+        "This program benchmarks the node level kernels of the ART (lookups of every node type, Node4 SWAR, Node16 SIMD comparisons Node48/Node256 child enumeration, tree traversals per key width, the cost of logging inserts per sync policy, insert latencies during checkpoints, lookups in paged trees per memory budget, the size and speed of key exports compared to tree images and the cost of recording inserts in a change feed) for every variant supported by the CPU and outputs the median throughput.\n"
+        "\nThe parameters in detail:\n"
+        "\t-h\t\t\t\t: Shows how to use the program (this text).\n"
+        "\t-i <number>\t\t\t: Specifies the number of iterations every kernel is run. Default value is %u. Should be an integer between 1 and 10000 (inclusive).\n"
+        "\t--seed <seed_number>\t\t: Use deterministic node keys and queries. If not set a random seed will be used.\n";
+
+/**
+ * Benchmark Parameters.
+ */
+uint32_t iterations{kDefaultIterations};
+size_t seed = -1;
+
+// keeps the compiler from optimizing the measured kernels away
+volatile uint64_t sink;
+
+struct Query
+{
+    uint32_t node;
+    uint8_t partial_key;
+};
+
+/**
+ * Measures op over all queries and returns the throughput in M Ops/s.
+ */
+template <class Q, class Op>
+double Measure(const std::vector<Q>& queries, Op&& op)
+{
+    uint64_t checksum = 0;
+
+    const auto t0 = std::chrono::high_resolution_clock::now();
+
+    for (const auto& query : queries)
+        checksum += op(query);
+
+    const auto t1 = std::chrono::high_resolution_clock::now();
+
+    sink = sink + checksum;
+
+    const double seconds = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()) / 1e9;
+    return static_cast<double>(queries.size()) / seconds / 1e6;
+}
+
+/**
+ * Runs every operation for every variant and prints the median throughput.
+ * prepare(variant, operation) returns the measurement or nothing if the variant isn't supported
+ * (e.g. an instruction set the CPU lacks).
+ */
+void RunOperations(const std::string& title, const std::vector<std::string>& variants, const std::vector<std::string>& operations,
+                   const std::function<std::function<double()>(size_t, size_t)>& prepare)
+{
+    std::cout << "=================================================================================================================" <<
+            std::endl;
+    std::cout << "\t\t\t\t" << title << " (M Ops/s)" << std::endl;
+    std::cout << "=================================================================================================================" <<
+            std::endl;
+
+    std::cout << "Operation\t\t|";
+    for (const auto& variant : variants)
+        std::cout << " " << variant << (variant.size() < 6 ? "\t\t|" : "\t|");
+    std::cout << std::endl;
+    std::cout << "-----------------------------------------------------------------------------------------------------------------" <<
+            std::endl;
+
+    for (size_t o = 0; o < operations.size(); ++o)
+    {
+        const auto& name = operations[o];
+        std::cout << name << (name.size() < 8 ? "\t\t\t|" : name.size() < 16 ? "\t\t|" : "\t|");
+
+        for (size_t v = 0; v < variants.size(); ++v)
+        {
+            const auto measure = prepare(v, o);
+
+            if (!measure)
+            {
+                std::cout << "       -\t|";
+                continue;
+            }
+
+            std::vector<double> results(iterations);
+            for (auto& result : results)
+                result = measure();
+
+            std::ranges::sort(results);
+            const double med = results.size() % 2 == 1
+                                   ? results[results.size() / 2]
+                                   : (results[results.size() / 2 - 1] + results[results.size() / 2]) / 2.0;
+
+            std::cout << FormatTime(med, false);
+        }
+
+        std::cout << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+/**
+ * Returns count distinct random partial keys in ascending order.
+ */
+std::vector<uint8_t> CreateKeys(std::mt19937_64& eng, const uint16_t count)
+{
+    std::vector<uint8_t> keys(256);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::ranges::shuffle(keys, eng);
+
+    keys.resize(count);
+    std::ranges::sort(keys);
+
+    return keys;
+}
+
+/**
+ * Returns a node of the smallest type holding a random number of children between min_count and max_count.
+ */
+Node* CreateNode(std::mt19937_64& eng, const uint16_t min_count, const uint16_t max_count)
+{
+    std::uniform_int_distribution<uint16_t> count_distr(min_count, max_count);
+
+    Node* node = Node::Create(0);
+
+    for (const uint8_t key : CreateKeys(eng, count_distr(eng)))
+    {
+        Node* new_node = node->Insert(key, Node::CreateLazyExpansion(key));
+        if (new_node != node)
+        {
+            node->Delete();
+            node = new_node;
+        }
+    }
+
+    return node;
+}
+
+std::vector<Query> CreateQueries(std::mt19937_64& eng, const uint32_t count = kQueryCount)
+{
+    std::vector<Query> queries(count);
+
+    std::uniform_int_distribution<uint32_t> node_distr(0, kNodeCount - 1);
+    std::uniform_int_distribution<uint32_t> key_distr(0, 255);
+
+    for (auto& query : queries)
+        query = {node_distr(eng), static_cast<uint8_t>(key_distr(eng))};
+
+    return queries;
+}
+
+/**
+ * Lookups for every node type.
+ */
+void RunNodeTypeBenchmark(std::mt19937_64& eng)
+{
+    // number of children of every node type (between the capacity of the next smaller type and its own)
+    constexpr std::pair<uint16_t, uint16_t> kChildCounts[]{{1, 4}, {5, 16}, {17, 48}, {49, 256}};
+
+    std::vector<std::vector<Node*>> nodes;
+    for (const auto& [min_count, max_count] : kChildCounts)
+    {
+        auto& type_nodes = nodes.emplace_back(kNodeCount);
+        for (auto& node : type_nodes)
+            node = CreateNode(eng, min_count, max_count);
+    }
+
+    const auto queries = CreateQueries(eng);
+
+    RunOperations("NODE TYPE MICROBENCHMARK", {"Node4", "Node16", "Node48", "Node256"}, {"Find Child", "Range Start"},
+                  [&](const size_t v, const size_t o) -> std::function<double()>
+                  {
+                      const auto& type_nodes = nodes[v];
+
+                      if (o == 0)
+                          return [&]
+                          {
+                              return Measure(queries, [&](const Query& q)
+                              {
+                                  return reinterpret_cast<uint64_t>(type_nodes[q.node]->FindChild(q.partial_key));
+                              });
+                          };
+
+                      return [&]
+                      {
+                          return Measure(queries, [&](const Query& q)
+                          {
+                              return reinterpret_cast<uint64_t>(type_nodes[q.node]->GetFirstChild(q.partial_key));
+                          });
+                      };
+                  });
+
+    for (const auto& type_nodes : nodes)
+        for (const auto node : type_nodes)
+            node->Destruct();
+}
+
+/**
+ * Node4 SWAR kernels (see simd.h) compared to scanning the keys one by one.
+ */
+void RunNode4Benchmark(std::mt19937_64& eng)
+{
+    std::vector<std::array<uint8_t, 4>> keys(kNodeCount);
+    std::vector<uint8_t> counts(kNodeCount);
+
+    std::uniform_int_distribution<uint16_t> count_distr(1, 4);
+
+    for (uint32_t n = 0; n < kNodeCount; ++n)
+    {
+        const auto node_keys = CreateKeys(eng, count_distr(eng));
+        counts[n] = node_keys.size();
+        keys[n] = {};
+        std::copy_n(node_keys.begin(), counts[n], keys[n].begin());
+    }
+
+    const auto queries = CreateQueries(eng);
+
+    // all operations return the position of the first matching key (or the key count if there is none)
+    const std::function<double()> measurements[2][3]{
+        {
+            // scalar loops
+            [&]
+            {
+                return Measure(queries, [&](const Query& q)
+                {
+                    uint8_t i = 0;
+                    for (; i < counts[q.node] && keys[q.node][i] != q.partial_key; ++i);
+                    return i;
+                });
+            },
+            [&]
+            {
+                return Measure(queries, [&](const Query& q)
+                {
+                    uint8_t i = 0;
+                    for (; keys[q.node][i] < q.partial_key && i < counts[q.node]; ++i);
+                    return i;
+                });
+            },
+            [&]
+            {
+                return Measure(queries, [&](const Query& q)
+                {
+                    uint8_t i = 0;
+                    for (; i < counts[q.node] && keys[q.node][i] < q.partial_key; ++i);
+                    return i;
+                });
+            }
+        },
+        {
+            // SWAR
+            [&]
+            {
+                return Measure(queries, [&](const Query& q)
+                {
+                    const uint32_t cmp_mask = art::simd::Node4Equal(keys[q.node].data(), q.partial_key, counts[q.node]);
+                    return cmp_mask ? __ctz(cmp_mask) >> 3 : counts[q.node];
+                });
+            },
+            [&]
+            {
+                return Measure(queries, [&](const Query& q)
+                {
+                    const uint32_t cmp_mask = art::simd::Node4Greater(keys[q.node].data(), q.partial_key, counts[q.node]);
+                    return cmp_mask ? __ctz(cmp_mask) >> 3 : counts[q.node];
+                });
+            },
+            [&]
+            {
+                return Measure(queries, [&](const Query& q)
+                {
+                    const uint32_t cmp_mask = art::simd::Node4GreaterEqual(keys[q.node].data(), q.partial_key,
+                                                                           counts[q.node]);
+                    return cmp_mask ? __ctz(cmp_mask) >> 3 : counts[q.node];
+                });
+            }
+        }
+    };
+
+    RunOperations("NODE4 MICROBENCHMARK", {"Scalar", "SWAR"}, {"Find Child", "Insert Position", "Range Start"},
+                  [&](const size_t v, const size_t o)
+                  {
+                      return measurements[v][o];
+                  });
+}
+
+/**
+ * Child enumeration of Node48 and Node256 via occupancy bitmaps for every instruction set level (see simd.h).
+ */
+void RunScanBenchmark(std::mt19937_64& eng)
+{
+    using art::simd::Isa;
+
+    const std::vector isa_levels{Isa::kSse2, Isa::kAvx2, Isa::kAvx512};
+
+    std::vector<Node*> node48s(kNodeCount);
+    std::vector<Node*> node256s(kNodeCount);
+    for (auto& node : node48s)
+        node = CreateNode(eng, 17, 48);
+    for (auto& node : node256s)
+        node = CreateNode(eng, 49, 256);
+
+    // every scan returns all children of a node
+    const auto queries = CreateQueries(eng, kQueryCount / 64);
+
+    std::vector<std::string> variants;
+    for (const auto isa : isa_levels)
+        variants.emplace_back(art::simd::GetIsaName(isa));
+
+    const Isa detected = art::simd::DetectIsa();
+
+    RunOperations("SCAN MICROBENCHMARK", variants, {"Node48 Full Range", "Node256 Full Range"},
+                  [&](const size_t v, const size_t o) -> std::function<double()>
+                  {
+                      if (!art::simd::SelectIsa(isa_levels[v]))
+                          return {};
+
+                      const auto& nodes = o == 0 ? node48s : node256s;
+
+                      return [&]
+                      {
+                          return Measure(queries, [&](const Query& q)
+                          {
+                              return nodes[q.node]->GetFullRange().size();
+                          });
+                      };
+                  });
+
+    art::simd::SelectIsa(detected);
+
+    for (const auto node : node48s)
+        node->Destruct();
+    for (const auto node : node256s)
+        node->Destruct();
+}
+
+/**
+ * Node16 kernels for every instruction set level (see simd.h).
+ */
+void RunNode16Benchmark(std::mt19937_64& eng)
+{
+    using art::simd::Isa;
+
+    const std::vector isa_levels{Isa::kSse2, Isa::kAvx2, Isa::kAvx512};
+
+    // nodes with 5 to 16 random sorted keys (and the same keys as raw arrays for the insert position kernel)
+    std::vector<Node16*> nodes(kNodeCount);
+    std::vector<std::array<uint8_t, 16>> keys(kNodeCount);
+    std::vector<uint8_t> counts(kNodeCount);
+
+    std::uniform_int_distribution<uint16_t> count_distr(5, 16);
+
+    for (uint32_t n = 0; n < kNodeCount; ++n)
+    {
+        const auto node_keys = CreateKeys(eng, count_distr(eng));
+        counts[n] = node_keys.size();
+
+        nodes[n] = Node::Allocate<Node16>();
+        for (const uint8_t key : node_keys)
+            nodes[n]->Insert(key, Node::CreateLazyExpansion(key));
+
+        keys[n] = {};
+        std::copy_n(node_keys.begin(), counts[n], keys[n].begin());
+    }
+
+    const auto queries = CreateQueries(eng);
+
+    std::vector<std::string> variants;
+    for (const auto isa : isa_levels)
+        variants.emplace_back(art::simd::GetIsaName(isa));
+
+    const Isa detected = art::simd::DetectIsa();
+
+    RunOperations("NODE16 MICROBENCHMARK", variants, {"Find Child", "Insert Position", "Range Start"},
+                  [&](const size_t v, const size_t o) -> std::function<double()>
+                  {
+                      if (!art::simd::SelectIsa(isa_levels[v]))
+                          return {};
+
+                      if (o == 0)
+                          return [&]
+                          {
+                              return Measure(queries, [&](const Query& q)
+                              {
+                                  return reinterpret_cast<uint64_t>(nodes[q.node]->FindChild(q.partial_key));
+                              });
+                          };
+
+                      if (o == 1)
+                          return [&]
+                          {
+                              return Measure(queries, [&](const Query& q)
+                              {
+                                  return art::simd::node16_kernels.greater(keys[q.node].data(), q.partial_key, counts[q.node]);
+                              });
+                          };
+
+                      return [&]
+                      {
+                          return Measure(queries, [&](const Query& q)
+                          {
+                              return reinterpret_cast<uint64_t>(nodes[q.node]->GetFirstChild(q.partial_key));
+                          });
+                      };
+                  });
+
+    art::simd::SelectIsa(detected);
+
+    for (const auto node : nodes)
+        node->Delete();
+}
+
+/**
+ * Tree traversals for the same 16 bit dictionary codes stored with every key width.
+ * The depth is a compile-time constant so narrower keys need fewer (unrolled) levels.
+ */
+void RunKeyWidthBenchmark(std::mt19937_64& eng)
+{
+    std::vector<uint16_t> codes(1 << 16);
+    std::iota(codes.begin(), codes.end(), 0);
+    std::ranges::shuffle(codes, eng);
+    codes.resize(kCodeCount);
+
+    std::vector<uint16_t> queries(kQueryCount);
+    std::uniform_int_distribution<uint32_t> code_distr(0, 0xFFFF);
+    for (auto& query : queries)
+        query = static_cast<uint16_t>(code_distr(eng));
+
+    art::Art<uint16_t> art16;
+    art::Art<uint32_t> art32;
+    art::Art<uint64_t> art64;
+    for (const uint16_t code : codes)
+    {
+        art16.Insert(code);
+        art32.Insert(code);
+        art64.Insert(code);
+    }
+
+    const auto prepare = [&](auto& art, const size_t o) -> std::function<double()>
+    {
+        using Art = std::remove_reference_t<decltype(art)>;
+
+        if (o == 0)
+            return [&]
+            {
+                // measures building a new tree
+                Art tree;
+                return Measure(codes, [&](const uint16_t code)
+                {
+                    tree.Insert(code);
+                    return 0;
+                });
+            };
+
+        return [&]
+        {
+            return Measure(queries, [&](const uint16_t code)
+            {
+                return art.Find(code);
+            });
+        };
+    };
+
+    RunOperations("KEY WIDTH MICROBENCHMARK", {"uint16_t", "uint32_t", "uint64_t"}, {"Insert", "Find"},
+                  [&](const size_t v, const size_t o) -> std::function<double()>
+                  {
+                      if (v == 0)
+                          return prepare(art16, o);
+                      if (v == 1)
+                          return prepare(art32, o);
+                      return prepare(art64, o);
+                  });
+}
+
+/**
+ * Inserts into a DurableArt for every sync policy compared to a tree without a log, and recovery of the tree by
+ * replaying the log.
+ */
+void RunDurabilityBenchmark(std::mt19937_64& eng)
+{
+    std::vector<uint32_t> keys(kDurableKeyCount);
+    for (auto& key : keys)
+        key = static_cast<uint32_t>(eng());
+
+    const auto directory = std::filesystem::temp_directory_path() / "art_durability_benchmark";
+
+    const std::vector<std::pair<std::string, art::DurabilityOptions>> policies{
+            {"No sync", {art::SyncPolicy::kNone, 1024}},
+            {"Batch 64", {art::SyncPolicy::kBatch, 64}},
+            {"Batch 4096", {art::SyncPolicy::kBatch, 4096}},
+            {"Always", {art::SyncPolicy::kAlways}},
+    };
+
+    std::vector<std::string> variants{"No log"};
+    for (const auto& [name, _] : policies)
+        variants.push_back(name);
+
+    RunOperations("DURABILITY MICROBENCHMARK", variants, {"Insert", "Recover"},
+                  [&](const size_t v, const size_t o) -> std::function<double()>
+                  {
+                      if (v == 0)
+                      {
+                          if (o == 1)
+                              return {};
+
+                          return [&]
+                          {
+                              art::Art<> tree;
+                              return Measure(keys, [&](const uint32_t key)
+                              {
+                                  tree.Insert(key);
+                                  return 0;
+                              });
+                          };
+                      }
+
+                      const auto& options = policies[v - 1].second;
+
+                      if (o == 0)
+                          return [&]
+                          {
+                              std::filesystem::remove_all(directory);
+
+                              art::DurableArt<> tree;
+                              tree.Open(directory, options);
+                              return Measure(keys, [&](const uint32_t key)
+                              {
+                                  return tree.Insert(key);
+                              });
+                          };
+
+                      // measures replaying the log left by the last insert measurement
+                      return [&]
+                      {
+                          const auto t0 = std::chrono::high_resolution_clock::now();
+
+                          art::DurableArt<> tree;
+                          tree.Open(directory, options);
+
+                          const auto t1 = std::chrono::high_resolution_clock::now();
+
+                          sink = sink + tree.Find(keys[0]);
+
+                          const double seconds = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()) / 1e9;
+                          return static_cast<double>(keys.size()) / seconds / 1e6;
+                      };
+                  });
+
+    std::filesystem::remove_all(directory);
+}
+
+/**
+ * Insert latencies of a DurableArt while a checkpoint is written, blocking inserts or from a forked child process.
+ * Every mode is run once since the percentiles already summarize all inserts.
+ */
+void RunCheckpointBenchmark(std::mt19937_64& eng)
+{
+    std::vector<uint32_t> keys(kCheckpointTreeKeyCount + kCheckpointInsertCount);
+    for (auto& key : keys)
+        key = static_cast<uint32_t>(eng());
+
+    const auto directory = std::filesystem::temp_directory_path() / "art_checkpoint_benchmark";
+
+    std::cout << "=================================================================================================================" <<
+            std::endl;
+    std::cout << "\t\t\t\tCHECKPOINT MICROBENCHMARK (Insert latency in us)" << std::endl;
+    std::cout << "=================================================================================================================" <<
+            std::endl;
+    std::cout << "Mode\t\t| p50\t\t| p99\t\t| p99.9\t\t| Max\t\t| M Ops/s\t| Durable (s)\t|" << std::endl;
+    std::cout << "-----------------------------------------------------------------------------------------------------------------" <<
+            std::endl;
+
+    for (const auto mode : {art::CheckpointMode::kBlocking, art::CheckpointMode::kFork})
+    {
+        std::filesystem::remove_all(directory);
+
+        art::DurableArt<> tree;
+        tree.Open(directory, {art::SyncPolicy::kNone, 4096, 0, mode});
+        for (uint32_t i = 0; i < kCheckpointTreeKeyCount; ++i)
+            tree.Insert(keys[i]);
+
+        std::vector<double> latencies(kCheckpointInsertCount);
+        double durable = 0.0;
+
+        const auto t0 = std::chrono::high_resolution_clock::now();
+        const auto seconds = [&](const auto t)
+        {
+            return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(t - t0).count()) / 1e9;
+        };
+
+        // latencies[0] is the duration of the Checkpoint call itself (the whole write in blocking mode)
+        tree.Checkpoint();
+        if (mode == art::CheckpointMode::kBlocking)
+            durable = seconds(std::chrono::high_resolution_clock::now());
+
+        auto t1 = std::chrono::high_resolution_clock::now();
+        latencies[0] = seconds(t1) * 1e6;
+
+        for (uint32_t i = 1; i < kCheckpointInsertCount; ++i)
+        {
+            tree.Insert(keys[kCheckpointTreeKeyCount + i]);
+
+            const auto t2 = std::chrono::high_resolution_clock::now();
+            latencies[i] = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count()) / 1e3;
+            t1 = t2;
+
+            if (durable == 0.0 && i % 4096 == 0 && !tree.IsCheckpointRunning())
+                durable = seconds(t2);
+        }
+
+        const double total = seconds(t1);
+
+        if (durable == 0.0)
+        {
+            tree.WaitForCheckpoint();
+            durable = seconds(std::chrono::high_resolution_clock::now());
+        }
+
+        std::ranges::sort(latencies);
+        const auto percentile = [&](const double p)
+        {
+            return latencies[static_cast<size_t>(p * static_cast<double>(latencies.size() - 1))];
+        };
+
+        std::cout << (mode == art::CheckpointMode::kBlocking ? "Blocking\t|" : "Fork\t\t|")
+                << FormatTime(percentile(0.5), false) << FormatTime(percentile(0.99), false)
+                << FormatTime(percentile(0.999), false) << FormatTime(latencies.back(), false)
+                << FormatTime(kCheckpointInsertCount / total / 1e6, false) << FormatTime(durable, false) << std::endl;
+    }
+
+    std::cout << std::endl;
+
+    std::filesystem::remove_all(directory);
+}
+
+/**
+ * Lookups in a PagedArt whose buffer pool holds a shrinking share of its pages, compared to the tree in memory. Pages
+ * are read with direct I/O where the file system supports it, so every miss goes to the disk. Every budget is measured
+ * once after warming up the pool with other lookups.
+ */
+void RunPagedBenchmark(std::mt19937_64& eng)
+{
+    std::vector<uint32_t> keys(kPagedKeyCount);
+    for (auto& key : keys)
+        key = static_cast<uint32_t>(eng());
+    std::ranges::sort(keys);
+    keys.erase(std::ranges::unique(keys).begin(), keys.end());
+
+    std::vector<uint32_t> warm_up(kPagedLookupCount);
+    std::vector<uint32_t> lookups(kPagedLookupCount);
+    for (auto& key : warm_up)
+        key = keys[eng() % keys.size()];
+    for (auto& key : lookups)
+        key = keys[eng() % keys.size()];
+
+    const auto path = std::filesystem::temp_directory_path() / "art_paged_benchmark.pages";
+
+    std::cout << "=================================================================================================================" <<
+            std::endl;
+    std::cout << "\t\t\t\tPAGED MICROBENCHMARK (" << keys.size() << " keys)" << std::endl;
+    std::cout << "=================================================================================================================" <<
+            std::endl;
+    std::cout << "Budget\t\t| Pool (MiB)\t| Pages (MiB)\t| Hit ratio\t| K Ops/s\t| Reads/Op\t|" << std::endl;
+    std::cout << "-----------------------------------------------------------------------------------------------------------------" <<
+            std::endl;
+
+    {
+        art::Art<> tree;
+        for (const auto key : keys)
+            tree.Insert(key);
+
+        const double ops = Measure(lookups, [&](const uint32_t key) { return tree.Find(key); });
+        std::cout << "In memory\t|       -\t|       -\t|       -\t|" << FormatTime(ops * 1e3, false) << "       -\t|" <<
+                std::endl;
+    }
+
+    // size of all pages, measured with the smallest pool
+    size_t pages_size;
+    {
+        art::PagedArt<> tree;
+        if (!tree.Open(path, 0) || !tree.Build(keys))
+        {
+            std::cerr << "Couldn't write the pages to " << path << std::endl;
+            return;
+        }
+        pages_size = tree.GetPageCount() * art::PagedArt<>::kPageSize;
+    }
+
+    for (const uint32_t share : {100, 50, 25, 10, 1})
+    {
+        art::PagedArt<> tree;
+        if (!tree.Open(path, pages_size * share / 100))
+        {
+            std::cerr << "Couldn't create " << path << std::endl;
+            return;
+        }
+        if (!tree.Build(keys))
+        {
+            std::cerr << "Couldn't write the pages to " << path << std::endl;
+            return;
+        }
+
+        for (const auto key : warm_up)
+            sink = sink + tree.Find(key).value_or(false);
+
+        const uint64_t reads = tree.GetStatistics().page_reads;
+        const double ops = Measure(lookups, [&](const uint32_t key) { return tree.Find(key).value_or(false); });
+        const double reads_per_op = static_cast<double>(tree.GetStatistics().page_reads - reads) / lookups.size();
+
+        std::cout << share << "%\t\t|"
+                << FormatTime(static_cast<double>(pages_size * share / 100) / (1 << 20), false)
+                << FormatTime(static_cast<double>(pages_size) / (1 << 20), false)
+                << FormatTime(1.0 - reads_per_op, false) << FormatTime(ops * 1e3, false)
+                << FormatTime(reads_per_op, false) << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+/**
+ * File size and throughput of Export and Import compared to Save and Load, for random and for consecutive keys. Every
+ * format is written and read once, the throughput is given in keys per second.
+ */
+void RunExportBenchmark(std::mt19937_64& eng)
+{
+    std::vector<uint32_t> sparse(kExportKeyCount);
+    for (auto& key : sparse)
+        key = static_cast<uint32_t>(eng());
+    std::ranges::sort(sparse);
+    sparse.erase(std::ranges::unique(sparse).begin(), sparse.end());
+
+    std::vector<uint32_t> dense(kExportKeyCount);
+    std::iota(dense.begin(), dense.end(), static_cast<uint32_t>(eng()) >> 1);
+
+    const auto path = (std::filesystem::temp_directory_path() / "art_export_benchmark.bin").string();
+
+    std::cout << "=================================================================================================================" <<
+            std::endl;
+    std::cout << "\t\t\t\tEXPORT MICROBENCHMARK (" << kExportKeyCount << " keys)" << std::endl;
+    std::cout << "=================================================================================================================" <<
+            std::endl;
+    std::cout << "Keys\t| Format\t| File (MiB)\t| Bytes/Key\t| Write M/s\t| Read M/s\t|" << std::endl;
+    std::cout << "-----------------------------------------------------------------------------------------------------------------" <<
+            std::endl;
+
+    for (const auto& [name, keys] : {std::pair{"Random", &sparse}, std::pair{"Dense", &dense}})
+    {
+        art::Art<> tree;
+        for (const auto key : *keys)
+            tree.Insert(key);
+
+        const std::vector<std::tuple<std::string, bool (art::Art<>::*)(const std::string&) const,
+                                     bool (art::Art<>::*)(const std::string&)>> formats{
+                {"Save/Load", &art::Art<>::Save, &art::Art<>::Load},
+                {"Export", &art::Art<>::Export, &art::Art<>::Import},
+        };
+
+        for (const auto& [format, write, read] : formats)
+        {
+            const auto t0 = std::chrono::high_resolution_clock::now();
+            const bool written = (tree.*write)(path);
+            const auto t1 = std::chrono::high_resolution_clock::now();
+
+            art::Art<> copy;
+            const bool read_ok = (copy.*read)(path);
+            const auto t2 = std::chrono::high_resolution_clock::now();
+
+            if (!written || !read_ok)
+            {
+                std::cerr << "Couldn't write and read " << path << std::endl;
+                return;
+            }
+
+            sink = sink + copy.Find((*keys)[0]);
+
+            const auto file_size = std::filesystem::file_size(path);
+            const auto seconds = [](const auto from, const auto to)
+            {
+                return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count()) / 1e9;
+            };
+
+            std::cout << name << "\t| " << format << "\t|"
+                    << FormatTime(static_cast<double>(file_size) / (1 << 20), false)
+                    << FormatTime(static_cast<double>(file_size) / keys->size(), false)
+                    << FormatTime(static_cast<double>(keys->size()) / seconds(t0, t1) / 1e6, false)
+                    << FormatTime(static_cast<double>(keys->size()) / seconds(t1, t2) / 1e6, false) << std::endl;
+        }
+    }
+
+    std::filesystem::remove(path);
+    std::cout << std::endl;
+}
+
+/**
+ * Inserts into a tree recording them in change feeds of different capacities compared to a tree without a feed, and
+ * a consumer tailing the changes retained by the feed in batches.
+ */
+void RunChangeFeedBenchmark(std::mt19937_64& eng)
+{
+    std::vector<uint32_t> keys(kFeedKeyCount);
+    for (auto& key : keys)
+        key = static_cast<uint32_t>(eng());
+
+    const std::vector<std::pair<std::string, size_t>> feeds{{"No feed", 0}, {"Feed 4K", 1 << 12}, {"Feed 1M", 1 << 20}};
+
+    std::vector<std::string> variants;
+    for (const auto& [name, _] : feeds)
+        variants.push_back(name);
+
+    RunOperations("CHANGE FEED MICROBENCHMARK", variants, {"Insert", "Tail"},
+                  [&](const size_t v, const size_t o) -> std::function<double()>
+                  {
+                      const size_t capacity = feeds[v].second;
+
+                      if (o == 0)
+                          return [&keys, capacity]
+                          {
+                              art::Art<> tree;
+                              if (capacity != 0)
+                                  tree.EnableChangeFeed(capacity);
+
+                              return Measure(keys, [&](const uint32_t key)
+                              {
+                                  tree.Insert(key);
+                                  return 0;
+                              });
+                          };
+
+                      if (capacity == 0)
+                          return {};
+
+                      // reads the retained changes over and over until as many changes as keys were read
+                      return [&keys, capacity]
+                      {
+                          art::Art<> tree;
+                          tree.EnableChangeFeed(capacity);
+                          for (const auto key : keys)
+                              tree.Insert(key);
+
+                          const art::ChangeFeed<uint32_t>& feed = *tree.GetChangeFeed();
+                          const uint64_t first = feed.GetSequence() - feed.GetCapacity();
+
+                          std::vector<art::Change<uint32_t>> changes;
+                          changes.reserve(kFeedBatchSize);
+
+                          uint64_t checksum = 0;
+                          const auto t0 = std::chrono::high_resolution_clock::now();
+
+                          for (uint64_t read = 0; read < keys.size(); read += kFeedBatchSize)
+                          {
+                              changes.clear();
+                              feed.Read(first + read % feed.GetCapacity(), changes, kFeedBatchSize);
+                              checksum += changes.back().key;
+                          }
+
+                          const auto t1 = std::chrono::high_resolution_clock::now();
+                          sink = sink + checksum;
+
+                          const double seconds = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()) / 1e9;
+                          return static_cast<double>(keys.size()) / seconds / 1e6;
+                      };
+                  });
+}
+
+int main(int argc, char* argv[])
+{
+    if (CmdArgExists(argv, argv + argc, "-h"))
+    {
+        printf(kHelpMsg, argv[0], kDefaultIterations);
+        return EXIT_SUCCESS;
+    }
+
+    char* iterations_arg = GetCmdArg(argv, argv + argc, "-i");
+    char* seed_arg = GetCmdArg(argv, argv + argc, "--seed");
+
+    if (iterations_arg != nullptr)
+    {
+        const std::string iterations_str{iterations_arg};
+
+        try
+        {
+            iterations = std::stoul(iterations_str);
+        }
+        catch (std::logic_error&)
+        {
+            fprintf(stderr, kUsageMsg, argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        if (iterations < 1 || iterations > 10000)
+        {
+            std::cerr << "Invalid 'iterations' argument \"" << iterations_str <<
+                    "\". Expected integer between 1 and 10000 (inclusive)." << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (seed_arg != nullptr)
+    {
+        const std::string seed_str{seed_arg};
+
+        try
+        {
+            seed = std::stoull(seed_str);
+        }
+        catch (std::logic_error&)
+        {
+            std::cerr << "Invalid 'seed' argument \"" << seed_str << "\". Expected positive integer." << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    else
+        seed = std::random_device()();
+
+    std::cout << "Running node microbenchmarks with '" << iterations << "' iterations and seed " << seed << " (detected '"
+            << art::simd::GetIsaName(art::simd::DetectIsa()) << "').\n" << std::endl;
+
+    std::mt19937_64 eng(seed);
+
+    RunNodeTypeBenchmark(eng);
+    RunNode4Benchmark(eng);
+    RunNode16Benchmark(eng);
+    RunScanBenchmark(eng);
+    RunKeyWidthBenchmark(eng);
+    RunDurabilityBenchmark(eng);
+    RunCheckpointBenchmark(eng);
+    RunPagedBenchmark(eng);
+    RunExportBenchmark(eng);
+    RunChangeFeedBenchmark(eng);
+
+    return EXIT_SUCCESS;
+}
@@ -1,19 +1,23 @@
 #pragma once
 
-#include "../../data_structures/art_virt/art.h"
+#include <memory>
+#include "../../data_structures/art/art.h"
 #include "../benchmark.h"
 
-class ArtVirtBenchmark : public Benchmark
+/**
+ * ART searching all keys with a single batched lookup (see Art::FindBatch).
+ */
+class ArtBatchBenchmark : public Benchmark
 {
 public:
-    ~ArtVirtBenchmark() override
+    ~ArtBatchBenchmark() override
     {
         delete art_;
     }
 
     void InitializeStructure() override
     {
-        art_ = new art_virt::Art();
+        art_ = new art::Art<>();
     }
 
     void DeleteStructure() override
@@ -30,8 +34,8 @@ public:
 
     void Search(const std::vector<uint32_t>& numbers) override
     {
-        for (uint32_t i = 0; i < numbers.size(); ++i)
-            art_->Find(numbers[i]);
+        const auto results = std::make_unique<bool[]>(numbers.size());
+        art_->FindBatch(numbers, results.get());
     }
 
     void RangeSearch(const std::vector<uint32_t>& numbers) override
@@ -41,5 +45,5 @@ public:
     }
 
 private:
-    art_virt::Art* art_ = nullptr;
+    art::Art<>* art_ = nullptr;
 };
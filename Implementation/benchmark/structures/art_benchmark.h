@@ -3,6 +3,10 @@
 #include "../../data_structures/art/art.h"
 #include "../benchmark.h"
 
+/**
+ * Dispatch is the dispatch policy of the tree (see policy.h).
+ */
+template <class Dispatch = art::SwitchDispatch>
 class ArtBenchmark : public Benchmark
 {
 public:
@@ -13,7 +17,7 @@ public:
 
     void InitializeStructure() override
     {
-        art_ = new art::Art();
+        art_ = new art::Art<uint32_t, Dispatch>();
     }
 
     void DeleteStructure() override
@@ -40,6 +44,21 @@ public:
             art_->FindRange(numbers[i], numbers[i + 1]);
     }
 
+    bool IsPersistent() const override
+    {
+        return true;
+    }
+
+    bool Save(const std::string& path) override
+    {
+        return art_->Save(path);
+    }
+
+    bool Load(const std::string& path) override
+    {
+        return art_->Load(path);
+    }
+
 private:
-    art::Art* art_ = nullptr;
+    art::Art<uint32_t, Dispatch>* art_ = nullptr;
 };
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "../../data_structures/art/art.h"
+#include "../benchmark.h"
+
+/**
+ * ART interleaving coroutine lookups with a round-robin scheduler (see Art::FindCoroutine).
+ */
+class ArtCoroutineBenchmark : public Benchmark
+{
+public:
+    ~ArtCoroutineBenchmark() override
+    {
+        delete art_;
+    }
+
+    void InitializeStructure() override
+    {
+        art_ = new art::Art<>();
+    }
+
+    void DeleteStructure() override
+    {
+        delete art_;
+        art_ = nullptr;
+    }
+
+    void Insert(const std::vector<uint32_t>& numbers) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+            art_->Insert(numbers[i]);
+    }
+
+    void Search(const std::vector<uint32_t>& numbers) override
+    {
+        art::RunInterleaved<bool>(numbers.size(), kGroupSize,
+                                  [this, &numbers](const size_t i) { return art_->FindCoroutine(numbers[i]); },
+                                  [](size_t, bool) {});
+    }
+
+    void RangeSearch(const std::vector<uint32_t>& numbers) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); i += 2)
+            art_->FindRange(numbers[i], numbers[i + 1]);
+    }
+
+private:
+    // number of lookups in flight
+    static constexpr size_t kGroupSize = 16;
+
+    art::Art<>* art_ = nullptr;
+};
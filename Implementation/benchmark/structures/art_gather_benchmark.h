@@ -0,0 +1,50 @@
+#pragma once
+
+#include <memory>
+#include "../../data_structures/art/art.h"
+#include "../benchmark.h"
+
+/**
+ * ART searching all keys with a single batched lookup advancing 16 lookups in lockstep with AVX2 gathers
+ * (see Art::FindBatchGather).
+ */
+class ArtGatherBenchmark : public Benchmark
+{
+public:
+    ~ArtGatherBenchmark() override
+    {
+        delete art_;
+    }
+
+    void InitializeStructure() override
+    {
+        art_ = new art::Art<uint32_t, art::TaggedDispatch>();
+    }
+
+    void DeleteStructure() override
+    {
+        delete art_;
+        art_ = nullptr;
+    }
+
+    void Insert(const std::vector<uint32_t>& numbers) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+            art_->Insert(numbers[i]);
+    }
+
+    void Search(const std::vector<uint32_t>& numbers) override
+    {
+        const auto results = std::make_unique<bool[]>(numbers.size());
+        art_->FindBatchGather(numbers, results.get());
+    }
+
+    void RangeSearch(const std::vector<uint32_t>& numbers) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); i += 2)
+            art_->FindRange(numbers[i], numbers[i + 1]);
+    }
+
+private:
+    art::Art<uint32_t, art::TaggedDispatch>* art_ = nullptr;
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <mutex>
+#include <shared_mutex>
+#include "../../data_structures/art/art.h"
+#include "../benchmark.h"
+
+/**
+ * ART guarded by a single reader-writer lock.
+ * Serves as the baseline for concurrent access in the mixed benchmark.
+ */
+class ArtLockedBenchmark : public Benchmark
+{
+public:
+    ~ArtLockedBenchmark() override
+    {
+        delete art_;
+    }
+
+    void InitializeStructure() override
+    {
+        art_ = new art::Art<>();
+    }
+
+    void DeleteStructure() override
+    {
+        delete art_;
+        art_ = nullptr;
+    }
+
+    void Insert(const std::vector<uint32_t>& numbers) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+            ConcurrentInsert(numbers[i]);
+    }
+
+    void Search(const std::vector<uint32_t>& numbers) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+            ConcurrentSearch(numbers[i]);
+    }
+
+    void RangeSearch(const std::vector<uint32_t>& numbers) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); i += 2)
+        {
+            std::shared_lock lock(mutex_);
+            art_->FindRange(numbers[i], numbers[i + 1]);
+        }
+    }
+
+    bool IsThreadSafe() const override
+    {
+        return true;
+    }
+
+    void ConcurrentInsert(const uint32_t key) override
+    {
+        std::unique_lock lock(mutex_);
+        art_->Insert(key);
+    }
+
+    bool ConcurrentSearch(const uint32_t key) override
+    {
+        std::shared_lock lock(mutex_);
+        return art_->Find(key);
+    }
+
+private:
+    art::Art<>* art_ = nullptr;
+    std::shared_mutex mutex_;
+};
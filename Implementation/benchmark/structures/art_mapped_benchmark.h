@@ -0,0 +1,75 @@
+#pragma once
+
+#include <algorithm>
+#include <filesystem>
+#include "../../data_structures/art/mapped_art.h"
+#include "../benchmark.h"
+
+/**
+ * Read-only ART served from a memory-mapped image (see MappedArt). Inserting writes the image of all keys to a
+ * temporary file and maps it.
+ */
+class ArtMappedBenchmark : public Benchmark
+{
+public:
+    ~ArtMappedBenchmark() override
+    {
+        DeleteStructure();
+    }
+
+    void InitializeStructure() override
+    {
+        art_ = new art::MappedArt<uint32_t>();
+    }
+
+    void DeleteStructure() override
+    {
+        delete art_;
+        art_ = nullptr;
+
+        std::error_code error;
+        std::filesystem::remove(path_, error);
+    }
+
+    void Insert(const std::vector<uint32_t>& numbers) override
+    {
+        std::vector<uint32_t> keys(numbers);
+        std::ranges::sort(keys);
+        keys.erase(std::ranges::unique(keys).begin(), keys.end());
+
+        art::MappedArt<uint32_t>::Write(path_, keys);
+        art_->Open(path_);
+    }
+
+    void Search(const std::vector<uint32_t>& numbers) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+            art_->Find(numbers[i]);
+    }
+
+    void RangeSearch(const std::vector<uint32_t>& numbers) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); i += 2)
+            art_->FindRange(numbers[i], numbers[i + 1]);
+    }
+
+    bool IsPersistent() const override
+    {
+        return true;
+    }
+
+    bool Save(const std::string& path) override
+    {
+        std::error_code error;
+        return std::filesystem::copy_file(path_, path, std::filesystem::copy_options::overwrite_existing, error);
+    }
+
+    bool Load(const std::string& path) override
+    {
+        return art_->Open(path);
+    }
+
+private:
+    art::MappedArt<uint32_t>* art_ = nullptr;
+    const std::string path_ = std::filesystem::temp_directory_path() / "art_mapped_benchmark.bin";
+};
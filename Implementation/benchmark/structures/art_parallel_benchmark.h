@@ -1,19 +1,19 @@
 #pragma once
 
-#include "../../data_structures/art_crtp/art.h"
+#include "../../data_structures/art/art.h"
 #include "../benchmark.h"
 
-class ArtCRTPBenchmark : public Benchmark
+class ArtParallelBenchmark : public Benchmark
 {
 public:
-    ~ArtCRTPBenchmark() override
+    ~ArtParallelBenchmark() override
     {
         delete art_;
     }
 
     void InitializeStructure() override
     {
-        art_ = new art_crtp::Art();
+        art_ = nullptr;
     }
 
     void DeleteStructure() override
@@ -24,8 +24,7 @@ public:
 
     void Insert(const std::vector<uint32_t>& numbers) override
     {
-        for (uint32_t i = 0; i < numbers.size(); ++i)
-            art_->Insert(numbers[i]);
+        art_ = new art::Art<>(numbers, pool_);
     }
 
     void Search(const std::vector<uint32_t>& numbers) override
@@ -37,9 +36,10 @@ public:
     void RangeSearch(const std::vector<uint32_t>& numbers) override
     {
         for (uint32_t i = 0; i < numbers.size(); i += 2)
-            art_->FindRange(numbers[i], numbers[i + 1]);
+            art_->FindRangeParallel(numbers[i], numbers[i + 1], pool_);
     }
 
 private:
-    art_crtp::Art* art_ = nullptr;
+    art::Art<>* art_ = nullptr;
+    art::ThreadPool pool_;
 };
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <filesystem>
+#include "../../data_structures/art/persistent_art.h"
+#include "../benchmark.h"
+
+/**
+ * ART whose nodes live in a memory-mapped file (see PersistentArt). Inserts modify a temporary file and loading only
+ * maps a copy of it.
+ */
+class ArtPersistentBenchmark : public Benchmark
+{
+public:
+    ~ArtPersistentBenchmark() override
+    {
+        DeleteStructure();
+    }
+
+    void InitializeStructure() override
+    {
+        art_ = new art::PersistentArt<uint32_t>();
+    }
+
+    void DeleteStructure() override
+    {
+        delete art_;
+        art_ = nullptr;
+
+        std::error_code error;
+        std::filesystem::remove(path_, error);
+    }
+
+    void Insert(const std::vector<uint32_t>& numbers) override
+    {
+        if (!art_->IsOpen())
+        {
+            std::error_code error;
+            std::filesystem::remove(path_, error);
+            art_->Open(path_);
+        }
+
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+            art_->Insert(numbers[i]);
+    }
+
+    void Search(const std::vector<uint32_t>& numbers) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+            art_->Find(numbers[i]);
+    }
+
+    void RangeSearch(const std::vector<uint32_t>& numbers) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); i += 2)
+            art_->FindRange(numbers[i], numbers[i + 1]);
+    }
+
+    bool IsPersistent() const override
+    {
+        return true;
+    }
+
+    bool Save(const std::string& path) override
+    {
+        std::error_code error;
+        return art_->Sync() &&
+            std::filesystem::copy_file(path_, path, std::filesystem::copy_options::overwrite_existing, error);
+    }
+
+    bool Load(const std::string& path) override
+    {
+        return art_->Open(path);
+    }
+
+private:
+    art::PersistentArt<uint32_t>* art_ = nullptr;
+    const std::string path_ = std::filesystem::temp_directory_path() / "art_persistent_benchmark.bin";
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "../../data_structures/art/art.h"
+#include "../benchmark.h"
+
+/**
+ * ART in single-writer/multi-reader mode (lock-free readers, see Art::InsertConcurrent).
+ */
+class ArtSwmrBenchmark : public Benchmark
+{
+public:
+    ~ArtSwmrBenchmark() override
+    {
+        delete art_;
+    }
+
+    void InitializeStructure() override
+    {
+        art_ = new art::Art<>();
+    }
+
+    void DeleteStructure() override
+    {
+        delete art_;
+        art_ = nullptr;
+    }
+
+    void Insert(const std::vector<uint32_t>& numbers) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+            art_->InsertConcurrent(numbers[i]);
+    }
+
+    void Search(const std::vector<uint32_t>& numbers) override
+    {
+        const art::EpochGuard session;
+
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+            art_->FindConcurrent(numbers[i], session);
+    }
+
+    void RangeSearch(const std::vector<uint32_t>& numbers) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); i += 2)
+            art_->FindRange(numbers[i], numbers[i + 1]);
+    }
+
+    bool IsSingleWriterSafe() const override
+    {
+        return true;
+    }
+
+    void ConcurrentInsert(const uint32_t key) override
+    {
+        art_->InsertConcurrent(key);
+    }
+
+    bool ConcurrentSearch(const uint32_t key) override
+    {
+        // every reader thread keeps its session pinned and only re-pins it every few lookups (quiescent state)
+        thread_local art::EpochGuard session;
+        thread_local uint32_t lookups = 0;
+
+        if (++lookups % kSessionRefreshInterval == 0)
+            session.Refresh();
+
+        return art_->FindConcurrent(key, session);
+    }
+
+private:
+    // number of lookups after which a reader session is re-pinned
+    static constexpr uint32_t kSessionRefreshInterval = 1024;
+
+    art::Art<>* art_ = nullptr;
+};
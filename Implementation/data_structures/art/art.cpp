@@ -1,57 +1,60 @@
 #include "art.h"
 
+#include <algorithm>
 #include <functional>
 
 namespace art
 {
-    void Art::Insert(const uint32_t value)
+    template <class Key, class Dispatch, class Allocator>
+    void Art<Key, Dispatch, Allocator>::Insert(const Key value)
     {
-        std::reference_wrapper<Node*> node_ref = std::ref(root_);
+        InsertAt<Traits::kRootOffset>(root_, value);
 
-        for (int offset = 24; offset >= 0; offset -= 8)
-        {
-            // get next 8 bit of value as partial key
-            uint8_t partial_key = value >> offset & 0xFF;
+        if (feed_)
+            feed_->Append(ChangeOperation::kInsert, value);
+    }
 
-            // check if partial key already exists
-            Node*& child_node_ref = node_ref.get()->FindChild(partial_key);
+    template <class Key, class Dispatch, class Allocator>
+    template <int offset>
+    void Art<Key, Dispatch, Allocator>::InsertAt(Node*& node_ref, const Key value)
+    {
+        // get next 8 bit of value as partial key
+        const uint8_t partial_key = value >> offset & 0xFF;
 
-            /**
-             * Case 1:  Partial key does not exist in the node.
-             *          -> Insert full key lazy expanded via combined value/pointer slots.
-             */
-            if (child_node_ref == null_node)
-            {
-                const auto tagged_pointer_value = reinterpret_cast<Node*>(static_cast<uint64_t>(value) << 32 | 0x7);
+        Node* node = Node::Untag(node_ref);
 
-                Node* new_node = node_ref.get()->Insert(partial_key, tagged_pointer_value);
+        // check if partial key already exists
+        Node*& child_node_ref = node->FindChild(partial_key);
 
-                if (new_node != node_ref.get())
-                {
-                    // node has changed
-                    // -> delete old child and update parent pointer
-                    switch (node_ref.get()->type_)
-                    {
-                        case kNode4:
-                            delete static_cast<Node4*>(node_ref.get());
-                            break;
-                        case kNode16:
-                            delete static_cast<Node16*>(node_ref.get());
-                            break;
-                        case kNode48:
-                            delete static_cast<Node48*>(node_ref.get());
-                            break;
-                        case kNode256:
-                            delete static_cast<Node256*>(node_ref.get());
-                            break;
-                    }
-
-                    node_ref.get() = new_node;
-                }
+        /**
+         * Case 1:  Partial key does not exist in the node.
+         *          -> Insert full key lazy expanded via combined value/pointer slots.
+         */
+        if (child_node_ref == Node::null_node)
+        {
+            const auto tagged_pointer_value = Node::CreateLazyExpansion(value);
 
-                return;
+            Node* new_node = node->Insert(partial_key, tagged_pointer_value);
+
+            if (new_node != node)
+            {
+                // node has changed
+                // -> delete old child and update parent pointer
+                node->Delete();
+                node_ref = Node::Tag(new_node);
             }
 
+            return;
+        }
+
+        if constexpr (offset == 0)
+        {
+            // the last level only stores full keys and all partial keys matched
+            // -> value has already been inserted
+            return;
+        }
+        else
+        {
             /**
              * Case 2:  Partial key exists and stores a full key (combined value/pointer slots).
              *          -> Either the full key matches or we expand the two different keys until they differ.
@@ -64,12 +67,12 @@ namespace art
 
                 // there is already the same partial key for a different full key
                 // -> create and add new child nodes until keys differ and then insert them as tagged pointers
-                const auto address_value = reinterpret_cast<uint64_t>(child_node_ref);
+                const Key stored_value = Node::GetLazyExpansion(child_node_ref);
 
-                const auto new_child_node = new Node4();
-                child_node_ref = new_child_node;
+                const auto new_child_node = Node::Create(2);
+                child_node_ref = Node::Tag(new_child_node);
 
-                ExpandLazyExpansion(value, address_value >> 32, offset - 8, new_child_node);
+                ExpandLazyExpansion(value, stored_value, offset - 8, new_child_node);
 
                 return;
             }
@@ -78,23 +81,33 @@ namespace art
              * Case 3:  Partial key exists and stores a pointer to a child node.
              *          -> Insert at child node at next depth.
              */
-            node_ref = std::ref(child_node_ref);
+            InsertAt<offset - 8>(child_node_ref, value);
         }
-
-        __unreachable();
     }
 
-    bool Art::Find(const uint32_t value) const
+    template <class Key, class Dispatch, class Allocator>
+    bool Art<Key, Dispatch, Allocator>::Find(const Key value) const
     {
-        Node* node = root_;
+        return FindAt<Traits::kRootOffset>(root_, value);
+    }
 
-        for (int offset = 24; offset >= 0; offset -= 8)
-        {
-            // get next 8 bit of value as partial key
-            const uint8_t partial_key = value >> offset & 0xFF;
+    template <class Key, class Dispatch, class Allocator>
+    template <int offset>
+    bool Art<Key, Dispatch, Allocator>::FindAt(Node* node, const Key value)
+    {
+        // get next 8 bit of value as partial key
+        const uint8_t partial_key = value >> offset & 0xFF;
 
-            Node* child_node = node->FindChild(partial_key);
+        Node* child_node = Node::FindChildOf(node, partial_key);
 
+        if constexpr (offset == 0)
+        {
+            // the last level only stores full keys and all partial keys matched so it exists if there is a child
+            // (since this ART has no path compression, leaf nodes are not needed)
+            return child_node != nullptr;
+        }
+        else
+        {
             // check if we have a child
             if (child_node == nullptr)
                 // since we don't have path compression we know the keys does not exist
@@ -105,26 +118,214 @@ namespace art
                 return Node::CmpLazyExpansion(child_node, value) == 0;
 
             // go to next node
+            return FindAt<offset - 8>(child_node, value);
+        }
+    }
+
+    template <class Key, class Dispatch, class Allocator>
+    void Art<Key, Dispatch, Allocator>::FindBatch(const std::span<const Key> keys, bool* out) const
+    {
+        // number of lookups in flight (enough to cover the memory latency without thrashing the L1)
+        constexpr size_t kGroupSize = 16;
+
+        struct Lookup
+        {
+            Node* node;
+            size_t index;
+            int offset;
+        };
+
+        Lookup group[kGroupSize];
+        size_t active = std::min(kGroupSize, keys.size());
+        size_t next = active;
+
+        for (size_t i = 0; i < active; ++i)
+            group[i] = {root_, i, Traits::kRootOffset};
+
+        while (active != 0)
+        {
+            for (size_t i = 0; i < active;)
+            {
+                auto& [node, index, offset] = group[i];
+                const Key value = keys[index];
+
+                // get next 8 bit of value as partial key
+                const uint8_t partial_key = value >> offset & 0xFF;
+
+                Node* child_node = Node::FindChildOf(node, partial_key);
+
+                bool done = true;
+                if (child_node == nullptr)
+                    out[index] = false;
+                else if (Node::IsLazyExpanded(child_node))
+                    out[index] = Node::CmpLazyExpansion(child_node, value) == 0;
+                else if (offset == 0)
+                    out[index] = true;
+                else
+                {
+                    // go to next node and fetch it while the other lookups advance
+                    Node::Prefetch(child_node, value >> (offset - 8) & 0xFF);
+
+                    node = child_node;
+                    offset -= 8;
+                    done = false;
+                }
+
+                if (!done)
+                {
+                    ++i;
+                    continue;
+                }
+
+                // replace the finished lookup with the next key or shrink the group
+                if (next < keys.size())
+                {
+                    group[i] = {root_, next++, Traits::kRootOffset};
+                    ++i;
+                }
+                else
+                    group[i] = group[--active];
+            }
+        }
+    }
+
+    template <class Key, class Dispatch, class Allocator>
+    std::optional<Key> Art<Key, Dispatch, Allocator>::LowerBound(const Key value) const
+    {
+        // nodes on the path of value (the lower bound is below the deepest one with a greater child)
+        Node* path[Traits::kLevels];
+        int depth = 0;
+
+        Node* node = root_;
+
+        for (int offset = Traits::kRootOffset; offset >= 0; offset -= 8, ++depth)
+        {
+            // get next 8 bit of value as partial key
+            const uint8_t partial_key = value >> offset & 0xFF;
+
+            path[depth] = node;
+
+            Node* child_node = Node::FindChildOf(node, partial_key);
+
+            if (child_node == nullptr)
+                break;
+
+            if (Node::IsLazyExpanded(child_node))
+            {
+                if (Node::CmpLazyExpansion(child_node, value) <= 0)
+                    return GetKey(child_node, value >> Traits::kRootOffset);
+                break;
+            }
+
+            if (offset == 0)
+                return value;
+
             node = child_node;
         }
 
-        // compared full value so it exists
-        // (since this ART is only for storing 32 bit keys without path compression
-        //  or lazy expansion, leaf nodes are not needed)
-        return true;
+        // find the deepest node on the path with a child greater than the path's partial key
+        Node* subtree = nullptr;
+        for (; depth >= 0 && subtree == nullptr; --depth)
+        {
+            const uint8_t partial_key = value >> (Traits::kRootOffset - depth * 8) & 0xFF;
+            if (partial_key != 0xFF)
+                subtree = Node::Untag(path[depth])->GetFirstChild(partial_key + 1);
+        }
+
+        if (subtree == nullptr)
+            return std::nullopt;
+
+        // the lower bound is the smallest value of that subtree
+        while (!Node::IsLazyExpanded(subtree))
+            subtree = Node::Untag(subtree)->GetFirstChild(0);
+
+        return GetKey(subtree, GetLowerBoundRootKey(value, depth));
     }
 
-    std::vector<uint32_t> Art::FindRange(const uint32_t from, const uint32_t to) const
+    template <class Key, class Dispatch, class Allocator>
+    std::vector<Key> Art<Key, Dispatch, Allocator>::FindRange(const Key from, const Key to) const
     {
-        return root_->GetRange(from, to, 24);
+        if constexpr (kStoresFullKeys)
+            return Node::Untag(root_)->GetRange(from, to, Traits::kRootOffset);
+        else
+        {
+            // the keys below a root child don't contain its partial key
+            // -> scan every child of the root in range separately and add it
+            std::vector<Key> res;
+            if (from > to)
+                return res;
+
+            const uint8_t from_key = from >> Traits::kRootOffset & 0xFF;
+            const uint8_t to_key = to >> Traits::kRootOffset & 0xFF;
+            constexpr int offset = Traits::kRootOffset - 8;
+
+            for (const auto& [partial_key, child_node] : Node::Untag(root_)->GetChildren(from_key, to_key))
+            {
+                std::vector<Key> keys;
+
+                if (Node::IsLazyExpanded(child_node))
+                {
+                    if ((partial_key != from_key || Node::CmpLazyExpansion(child_node, from) <= 0) &&
+                        (partial_key != to_key || Node::CmpLazyExpansion(child_node, to) >= 0))
+                        keys.push_back(Node::GetLazyExpansion(child_node));
+                }
+                else if (partial_key == from_key && partial_key == to_key)
+                    keys = Node::Untag(child_node)->GetRange(from, to, offset);
+                else if (partial_key == from_key)
+                    keys = Node::Untag(child_node)->GetLowerRange(from, offset);
+                else if (partial_key == to_key)
+                    keys = Node::Untag(child_node)->GetUpperRange(to, offset);
+                else
+                    keys = Node::Untag(child_node)->GetFullRange();
+
+                for (const Key key : keys)
+                    res.push_back(key | static_cast<Key>(partial_key) << Traits::kRootOffset);
+            }
+
+            return res;
+        }
     }
 
-    void Art::PrintTree() const
+    template <class Key, class Dispatch, class Allocator>
+    void Art<Key, Dispatch, Allocator>::PrintTree() const
     {
-        root_->PrintTree(0);
+        Node::Untag(root_)->PrintTree(0);
     }
 
-    void Art::ExpandLazyExpansion(const uint32_t value1, const uint32_t value2, const int depth, Node* node)
+    template <class Key, class Dispatch, class Allocator>
+    auto Art<Key, Dispatch, Allocator>::BuildSubtree(const Key* begin, const Key* end, const int offset) -> Node*
+    {
+        // a single key is stored using combined value/pointer slots
+        if (end - begin == 1)
+            return Node::CreateLazyExpansion(*begin);
+
+        // count distinct partial keys to allocate an exactly sized node
+        uint16_t child_count = 1;
+        for (auto it = begin + 1; it != end; ++it)
+            if ((*it >> offset & 0xFF) != (*(it - 1) >> offset & 0xFF))
+                ++child_count;
+
+        Node* node = Node::Create(child_count);
+
+        for (auto group_begin = begin; group_begin != end;)
+        {
+            const uint8_t partial_key = *group_begin >> offset & 0xFF;
+
+            auto group_end = group_begin + 1;
+            for (; group_end != end && (*group_end >> offset & 0xFF) == partial_key; ++group_end);
+
+            // node is exactly sized so it never grows
+            node->Insert(partial_key, BuildSubtree(group_begin, group_end, offset - 8));
+
+            group_begin = group_end;
+        }
+
+        return Node::Tag(node);
+    }
+
+    template <class Key, class Dispatch, class Allocator>
+    void Art<Key, Dispatch, Allocator>::ExpandLazyExpansion(const Key value1, const Key value2, const int depth,
+                                                            Node* node)
     {
         Node* n = node;
 
@@ -139,8 +340,8 @@ namespace art
                 // partial keys differ
                 // -> insert both full keys as multi value leaves
 
-                const auto tagged_pointer_value1 = reinterpret_cast<Node*>(static_cast<uint64_t>(value1) << 32 | 0x7);
-                const auto tagged_pointer_value2 = reinterpret_cast<Node*>(static_cast<uint64_t>(value2) << 32 | 0x7);
+                const auto tagged_pointer_value1 = Node::CreateLazyExpansion(value1);
+                const auto tagged_pointer_value2 = Node::CreateLazyExpansion(value2);
 
                 n->Insert(partial_key1, tagged_pointer_value1);
                 n->Insert(partial_key2, tagged_pointer_value2);
@@ -151,11 +352,27 @@ namespace art
 
             // partial keys are still the same
             // -> insert another new node and go to next depth
-            const auto new_child_node = new Node4();
-            n->Insert(partial_key1, new_child_node);
+            const auto new_child_node = Node::Create(1);
+            n->Insert(partial_key1, Node::Tag(new_child_node));
             n = new_child_node;
         }
 
         __unreachable();
     }
+
+    template <class Key, class Dispatch, class Allocator>
+    Key Art<Key, Dispatch, Allocator>::GetLowerBoundRootKey(const Key value, const int depth) const
+    {
+        const uint8_t partial_key = value >> Traits::kRootOffset & 0xFF;
+
+        if constexpr (kStoresFullKeys)
+            return partial_key;
+        else
+            // the lower bound might be below a greater child of the root than the one on the path
+            return depth >= 0 ? partial_key : Node::Untag(root_)->GetChildren(partial_key + 1, 0xFF).front().first;
+    }
+
+#define ART_INSTANTIATE_TREE(Key, Dispatch) template class Art<Key, Dispatch>;
+
+    ART_FOR_EACH_CONFIG(ART_INSTANTIATE_TREE)
 }
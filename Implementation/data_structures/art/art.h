@@ -1,38 +1,289 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
 #include <vector>
+#include "change_feed.h"
+#include "epoch.h"
+#include "lookup.h"
 #include "node/node.h"
+#include "thread_pool.h"
 
 namespace art
 {
+    /**
+     * ART for keys of type Key (16, 32 or 64 bit, see KeyTraits) whose nodes are allocated using Allocator.
+     * Dispatch selects how operations reach the actual node types (SwitchDispatch, StaticDispatch,
+     * VirtualDispatch or TaggedDispatch, see policy.h). Supported combinations are listed in ART_FOR_EACH_CONFIG.
+     *
+     * The parallel build and scans partition by the two most significant bytes and are only available for 32 bit
+     * keys.
+     */
+    template <class Key = uint32_t, class Dispatch = SwitchDispatch, class Allocator = std::allocator<std::byte>>
     class Art
     {
+        using Config = TreeConfig<Key, Dispatch, Allocator>;
+        using Traits = KeyTraits<Key>;
+        using Node = art::Node<Config>;
+
     public:
-        Art() : root_{new Node4()}
+        Art() : root_{Node::Tag(Node::Create(0))}
         {
         }
 
+        /**
+         * Builds the tree from a set of (unsorted and possibly duplicate) keys in parallel.
+         *
+         * The keys are radix partitioned by their two most significant bytes. The subtrees below the second level
+         * are then built bottom-up with exactly sized nodes as independent tasks on the pool and finally stitched
+         * together under the root.
+         */
+        Art(const std::vector<Key>& values, ThreadPool& pool) requires (sizeof(Key) == 4);
+
         ~Art()
         {
-            root_->Destruct();
+            Node::Untag(root_)->Destruct();
         }
 
-        void Insert(uint32_t value);
+        void Insert(Key value);
+
+        /**
+         * Inserts a batch of (unsorted and possibly duplicate) keys in parallel.
+         * No other operation may run on the tree concurrently.
+         *
+         * The batch is radix partitioned by the two most significant bytes. The few insertions into the root and
+         * second level nodes (including their growths) are done serially so that afterwards every partition owns a
+         * child slot below the second level. The partitions are then inserted as independent tasks on the pool
+         * without any synchronization. Subtrees that didn't exist before are built bottom-up with exactly sized nodes.
+         */
+        void InsertBatchParallel(const std::vector<Key>& values, ThreadPool& pool) requires (sizeof(Key) == 4);
+
+        bool Find(Key value) const;
+
+        /**
+         * Finds multiple values and stores for every key whether it exists in out (out[i] for keys[i]).
+         *
+         * Keeps a small group of lookups in flight and advances them round-robin one level at a time. The next node
+         * of every lookup is prefetched so the cache misses of the group overlap instead of being serialized
+         * (asynchronous memory access chaining).
+         */
+        void FindBatch(std::span<const Key> keys, bool* out) const;
+
+        /**
+         * Same as FindBatch but advances groups of 16 lookups in lockstep using AVX2 while they are in Node48 or
+         * Node256 (the upper levels for sparse keys). The partial keys of all lanes are extracted, their child
+         * pointers gathered and checked with vector compares. Lanes reaching other node types are finished one by
+         * one with scalar lookups.
+         *
+         * Falls back to FindBatch if the CPU doesn't support AVX2 (or for VirtualDispatch).
+         */
+        void FindBatchGather(std::span<const Key> keys, bool* out) const;
+
+        /**
+         * Returns the smallest value greater or equal to value (or nothing if there is none).
+         */
+        std::optional<Key> LowerBound(Key value) const;
+
+        /**
+         * Coroutine versions of Find and LowerBound which prefetch the next node and suspend at every tree level.
+         * Many of them can be interleaved using RunInterleaved (see lookup.h) to overlap their cache misses.
+         */
+        Lookup<bool> FindCoroutine(Key value) const;
+
+        Lookup<std::optional<Key>> LowerBoundCoroutine(Key value) const;
 
-        bool Find(uint32_t value) const;
+        std::vector<Key> FindRange(Key from, Key to) const;
 
-        std::vector<uint32_t> FindRange(uint32_t from, uint32_t to) const;
+        /**
+         * Inserts a value while other threads might concurrently search via FindConcurrent
+         * (single-writer/multi-reader mode).
+         *
+         * Only a single thread may insert at a time and Insert must not be used concurrently. New subtrees and grown
+         * nodes are built completely before being published with a release store. Replaced nodes are freed once no
+         * reader can still access them (epoch based reclamation).
+         */
+        void InsertConcurrent(Key value);
+
+        /**
+         * Finds a value while a single writer might concurrently insert via InsertConcurrent.
+         *
+         * The caller pins the epoch once for a whole reader session with an EpochGuard (see epoch.h) and passes it
+         * to every lookup, so a lookup itself only does plain loads. Lookups in Node4 and Node16 are validated
+         * against the node's version and retried if they overlapped with an insertion into that node.
+         */
+        bool FindConcurrent(Key value, const EpochGuard& session) const;
+
+        /**
+         * Finds all values in a given range (inclusive) in parallel.
+         *
+         * The range is split into subtree tasks at the root and second level which are run on the pool.
+         * Every task returns an ordered chunk and the chunks are returned in ascending key order.
+         */
+        std::vector<std::vector<Key>> FindRangeParallel(Key from, Key to, ThreadPool& pool) const
+            requires (sizeof(Key) == 4);
+
+        /**
+         * Scans all values in a given range (inclusive) in parallel and passes every non-empty chunk to callback.
+         *
+         * If ordered is true the callback is invoked by the calling thread in ascending key order as soon as the
+         * next chunk is ready. Otherwise it is invoked concurrently by the pool threads in completion order.
+         */
+        void ScanParallel(Key from, Key to, ThreadPool& pool,
+                          const std::function<void(const std::vector<Key>&)>& callback, bool ordered) const
+            requires (sizeof(Key) == 4);
 
         /**
          * Prints the Tree in pre-order.
          */
         void PrintTree() const;
 
+        /**
+         * Writes the tree to a file as a compact pre-order stream of node types, partial keys and full keys
+         * (see art_serialization.cpp for the format). Returns false if the file couldn't be written.
+         */
+        bool Save(const std::string& path) const;
+
+        /**
+         * Replaces the tree by one written by Save in a single sequential pass over the file building exactly sized
+         * nodes. Returns false (leaving the tree unchanged) if the file couldn't be read or wasn't written by a tree
+         * with the same key type.
+         */
+        bool Load(const std::string& path);
+
+        /**
+         * Writes all keys in ascending order as chunks of delta encoded varints (see key_stream.h) while walking the
+         * tree. Returns false if the file couldn't be written.
+         */
+        bool Export(const std::string& path) const;
+
+        /**
+         * Replaces the tree by the keys written by Export, building exactly sized nodes bottom-up while the keys
+         * stream through a buffer of a single chunk. Returns false (leaving the tree unchanged) if the file couldn't
+         * be read or is malformed.
+         */
+        bool Import(const std::string& path);
+
+        /**
+         * Records all following insertions in a change feed keeping the latest capacity of them (see change_feed.h),
+         * replacing a previous feed. Replicas tail the feed and insert its changes instead of reloading the tree.
+         */
+        void EnableChangeFeed(const size_t capacity)
+        {
+            feed_ = std::make_unique<ChangeFeed<Key>>(capacity);
+        }
+
+        /**
+         * Returns the change feed (nullptr unless enabled).
+         */
+        const ChangeFeed<Key>* GetChangeFeed() const
+        {
+            return feed_.get();
+        }
+
+        /**
+         * Exports the keys (see Export) for a replica which fell behind the change feed and returns the sequence
+         * number of the latest change they include, from which the replica continues tailing. Returns nothing if the
+         * feed is disabled or the file couldn't be written.
+         */
+        std::optional<uint64_t> ExportSnapshot(const std::string& path) const;
+
     private:
-        void ExpandLazyExpansion(uint32_t value1, uint32_t value2, int depth, Node* node);
+        // false if tagged pointers don't store the partial key of the root (see KeyTraits)
+        static constexpr bool kStoresFullKeys = Node::kLazyExpansionMask == static_cast<Key>(~Key{0});
+
+        /**
+         * Insert and Find below the node at a given offset.
+         * Every level is a separate instantiation so the traversal is unrolled and the last level (offset 0) knows
+         * that it only stores full keys.
+         */
+        template <int offset>
+        void InsertAt(Node*& node_ref, Key value);
+
+        template <int offset>
+        static bool FindAt(Node* node, Key value);
+
+        /**
+         * Finds a value below the node a child pointer points to at a given offset.
+         */
+        static bool FindFrom(Node* node_ptr, Key value, int offset);
+
+        void FindBatchGatherAvx2(std::span<const Key> keys, bool* out) const;
+
+        /**
+         * Returns the full key stored at a tagged pointer below the child of the root with partial key root_key
+         * (which is only used if tagged pointers don't store it).
+         */
+        static Key GetKey(Node* node_ptr, const uint8_t root_key)
+        {
+            if constexpr (kStoresFullKeys)
+                return Node::GetLazyExpansion(node_ptr);
+            else
+                return Node::GetLazyExpansion(node_ptr) | static_cast<Key>(root_key) << Traits::kRootOffset;
+        }
+
+        /**
+         * Returns the partial key of the root above the lower bound of value found in the subtree of a child at
+         * depth + 1 on the path of value (only needed if tagged pointers don't store it).
+         */
+        Key GetLowerBoundRootKey(Key value, int depth) const;
+
+        /**
+         * Writes the record of a node and its subtree (see Save) or reads it and returns the tagged pointer to the
+         * rebuilt node (or nullptr if the stream is malformed).
+         */
+        template <class Writer>
+        static void SaveNode(Writer& writer, const Node* node);
+
+        template <class Reader>
+        static Node* LoadNode(Reader& reader, int offset);
+
+        /**
+         * Writes the keys of the subtree of node below the child of the root with partial key root_key (see Export).
+         */
+        template <class Writer>
+        static void ExportNode(Writer& writer, const Node* node, uint8_t root_key);
+
+        void ExpandLazyExpansion(Key value1, Key value2, int depth, Node* node);
+
+        /**
+         * Builds the subtree for sorted unique keys sharing all partial keys above offset and returns a pointer to
+         * its root (or the lazy expanded key if there is only a single one).
+         */
+        static Node* BuildSubtree(const Key* begin, const Key* end, int offset);
+
+        /**
+         * Subtree of a parallel scan below the root or second level.
+         * Bounded tasks contain the from (lower) or to (upper) key of the scanned range.
+         */
+        struct ScanTask
+        {
+            Node* node;
+            int offset;
+            bool lower_bounded;
+            bool upper_bounded;
+        };
+
+        /**
+         * Splits the range into subtree tasks at the root and second level in ascending key order.
+         */
+        std::vector<ScanTask> GetScanTasks(Key from, Key to) const;
+
+        /**
+         * Finds all values in a given range (inclusive) of a contiguous group of scan tasks.
+         */
+        static std::vector<Key> ScanSubtrees(const ScanTask* begin, const ScanTask* end, Key from, Key to);
 
     private:
+        // tagged like a child pointer (see TaggedDispatch)
         Node* root_;
+        // nodes replaced by InsertConcurrent which readers might still access
+        RetireList retired_;
+        // latest insertions for replicas (nullptr unless enabled)
+        std::unique_ptr<ChangeFeed<Key>> feed_;
     };
 }
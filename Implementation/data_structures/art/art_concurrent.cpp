@@ -0,0 +1,106 @@
+#include "art.h"
+
+#include <atomic>
+
+namespace art
+{
+    template <class Key, class Dispatch, class Allocator>
+    void Art<Key, Dispatch, Allocator>::InsertConcurrent(const Key value)
+    {
+        // replicas apply changes idempotently, so the change may be published before the key
+        if (feed_)
+            feed_->Append(ChangeOperation::kInsert, value);
+
+        // only the writer modifies the tree so it can traverse with plain loads
+        Node** node_ref = &root_;
+
+        for (int offset = Traits::kRootOffset; offset >= 0; offset -= 8)
+        {
+            // get next 8 bit of value as partial key
+            const uint8_t partial_key = value >> offset & 0xFF;
+
+            Node* node = Node::Untag(*node_ref);
+            Node*& child_node_ref = node->FindChild(partial_key);
+
+            /**
+             * Case 1:  Partial key does not exist in the node.
+             *          -> Insert full key lazy expanded via combined value/pointer slots.
+             */
+            if (child_node_ref == Node::null_node)
+            {
+                Node* new_node = node->InsertConcurrent(partial_key, Node::CreateLazyExpansion(value));
+
+                if (new_node != node)
+                {
+                    // node has grown
+                    // -> publish the new node and retire the old one since readers might still traverse it
+                    std::atomic_ref(*node_ref).store(Node::Tag(new_node), std::memory_order_release);
+                    retired_.Retire(node, [](void* n) { static_cast<Node*>(n)->Delete(); });
+                }
+
+                return;
+            }
+
+            /**
+             * Case 2:  Partial key exists and stores a full key (combined value/pointer slots).
+             *          -> Either the full key matches or we expand the two different keys until they differ.
+             */
+            if (Node::IsLazyExpanded(child_node_ref))
+            {
+                if (Node::CmpLazyExpansion(child_node_ref, value) == 0)
+                    // value has already been inserted
+                    return;
+
+                // build the expanded subtree first and then replace the stored key with it
+                const auto new_child_node = Node::Create(2);
+                ExpandLazyExpansion(value, Node::GetLazyExpansion(child_node_ref), offset - 8, new_child_node);
+
+                std::atomic_ref(child_node_ref).store(Node::Tag(new_child_node), std::memory_order_release);
+
+                return;
+            }
+
+            /**
+             * Case 3:  Partial key exists and stores a pointer to a child node.
+             *          -> Insert at child node at next depth.
+             */
+            node_ref = &child_node_ref;
+        }
+
+        __unreachable();
+    }
+
+    template <class Key, class Dispatch, class Allocator>
+    bool Art<Key, Dispatch, Allocator>::FindConcurrent(const Key value, const EpochGuard&) const
+    {
+        // nodes replaced by the writer stay valid while the session is pinned
+        // the root is only replaced by the writer
+        Node* node = Node::Untag(std::atomic_ref(const_cast<Node*&>(root_)).load(std::memory_order_acquire));
+
+        for (int offset = Traits::kRootOffset; offset >= 0; offset -= 8)
+        {
+            // get next 8 bit of value as partial key
+            const uint8_t partial_key = value >> offset & 0xFF;
+
+            Node* child_node = node->FindChildConcurrent(partial_key);
+
+            if (child_node == nullptr)
+                return false;
+
+            // handle lazy expansion
+            if (Node::IsLazyExpanded(child_node))
+                return Node::CmpLazyExpansion(child_node, value) == 0;
+
+            // go to next node
+            node = Node::Untag(child_node);
+        }
+
+        return true;
+    }
+
+#define ART_INSTANTIATE_CONCURRENT(Key, Dispatch) \
+    template void Art<Key, Dispatch>::InsertConcurrent(Key); \
+    template bool Art<Key, Dispatch>::FindConcurrent(Key, const EpochGuard&) const;
+
+    ART_FOR_EACH_CONFIG(ART_INSTANTIATE_CONCURRENT)
+}
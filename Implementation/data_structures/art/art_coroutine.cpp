@@ -0,0 +1,100 @@
+#include "art.h"
+
+namespace art
+{
+    template <class Key, class Dispatch, class Allocator>
+    Lookup<bool> Art<Key, Dispatch, Allocator>::FindCoroutine(const Key value) const
+    {
+        Node* node = root_;
+
+        for (int offset = Traits::kRootOffset; offset >= 0; offset -= 8)
+        {
+            // get next 8 bit of value as partial key
+            const uint8_t partial_key = value >> offset & 0xFF;
+
+            Node* child_node = Node::FindChildOf(node, partial_key);
+
+            if (child_node == nullptr)
+                co_return false;
+
+            if (Node::IsLazyExpanded(child_node))
+                co_return Node::CmpLazyExpansion(child_node, value) == 0;
+
+            if (offset == 0)
+                co_return true;
+
+            // fetch the next node while other lookups run
+            Node::Prefetch(child_node, value >> (offset - 8) & 0xFF);
+            co_await std::suspend_always{};
+
+            node = child_node;
+        }
+
+        co_return true;
+    }
+
+    template <class Key, class Dispatch, class Allocator>
+    Lookup<std::optional<Key>> Art<Key, Dispatch, Allocator>::LowerBoundCoroutine(const Key value) const
+    {
+        // same as LowerBound but suspending after every prefetch
+        Node* path[Traits::kLevels];
+        int depth = 0;
+
+        Node* node = root_;
+
+        for (int offset = Traits::kRootOffset; offset >= 0; offset -= 8, ++depth)
+        {
+            const uint8_t partial_key = value >> offset & 0xFF;
+
+            path[depth] = node;
+
+            Node* child_node = Node::FindChildOf(node, partial_key);
+
+            if (child_node == nullptr)
+                break;
+
+            if (Node::IsLazyExpanded(child_node))
+            {
+                if (Node::CmpLazyExpansion(child_node, value) <= 0)
+                    co_return GetKey(child_node, value >> Traits::kRootOffset);
+                break;
+            }
+
+            if (offset == 0)
+                co_return value;
+
+            Node::Prefetch(child_node, value >> (offset - 8) & 0xFF);
+            co_await std::suspend_always{};
+
+            node = child_node;
+        }
+
+        // the nodes on the path have been visited already so backtracking doesn't miss the cache
+        Node* subtree = nullptr;
+        for (; depth >= 0 && subtree == nullptr; --depth)
+        {
+            const uint8_t partial_key = value >> (Traits::kRootOffset - depth * 8) & 0xFF;
+            if (partial_key != 0xFF)
+                subtree = Node::Untag(path[depth])->GetFirstChild(partial_key + 1);
+        }
+
+        if (subtree == nullptr)
+            co_return std::nullopt;
+
+        while (!Node::IsLazyExpanded(subtree))
+        {
+            Node::Prefetch(subtree, 0);
+            co_await std::suspend_always{};
+
+            subtree = Node::Untag(subtree)->GetFirstChild(0);
+        }
+
+        co_return GetKey(subtree, GetLowerBoundRootKey(value, depth));
+    }
+
+#define ART_INSTANTIATE_COROUTINE(Key, Dispatch) \
+    template Lookup<bool> Art<Key, Dispatch>::FindCoroutine(Key) const; \
+    template Lookup<std::optional<Key>> Art<Key, Dispatch>::LowerBoundCoroutine(Key) const;
+
+    ART_FOR_EACH_CONFIG(ART_INSTANTIATE_COROUTINE)
+}
@@ -0,0 +1,211 @@
+#include "art.h"
+
+#include "node/simd.h"
+
+namespace art
+{
+    namespace
+    {
+        // lookups advanced in lockstep (as many as FindBatch keeps in flight to cover the memory latency)
+        constexpr size_t kLanes = 16;
+        // registers of 4 lanes with 64 bit each
+        constexpr size_t kRegisters = kLanes / 4;
+
+        /**
+         * Returns a vector with all bits set in the lanes of register r whose bit is set in lanes.
+         */
+        __target("avx2") __m256i LaneMask(const uint32_t lanes, const size_t r)
+        {
+            const __m256i bits = _mm256_setr_epi64x(1, 2, 4, 8);
+            const __m256i register_lanes = _mm256_set1_epi64x(lanes >> r * 4 & 0xF);
+            return _mm256_cmpeq_epi64(_mm256_and_si256(register_lanes, bits), bits);
+        }
+
+        /**
+         * Returns a bitmask with bit i set if lane i of v has all bits set.
+         */
+        __target("avx2") uint32_t MoveMask(const __m256i v)
+        {
+            return _mm256_movemask_pd(_mm256_castsi256_pd(v));
+        }
+
+        /**
+         * Loads the 8 bytes at the address in every lane of mask (and 0 in all other lanes).
+         */
+        __target("avx2") __m256i Gather(const __m256i addresses, const __m256i mask)
+        {
+            return _mm256_mask_i64gather_epi64(_mm256_setzero_si256(), nullptr, addresses, mask, 1);
+        }
+    }
+
+    template <class Key, class Dispatch, class Allocator>
+    void Art<Key, Dispatch, Allocator>::FindBatchGather(const std::span<const Key> keys, bool* out) const
+    {
+        // the gathers rely on the node layout without a vtable pointer
+        if constexpr (Dispatch::kVirtual)
+            FindBatch(keys, out);
+        else if (simd::GetIsa() >= simd::Isa::kAvx2)
+            FindBatchGatherAvx2(keys, out);
+        else
+            FindBatch(keys, out);
+    }
+
+    template <class Key, class Dispatch, class Allocator>
+    bool Art<Key, Dispatch, Allocator>::FindFrom(Node* node_ptr, const Key value, int offset)
+    {
+        for (; offset >= 0; offset -= 8)
+        {
+            // get next 8 bit of value as partial key
+            const uint8_t partial_key = value >> offset & 0xFF;
+
+            Node* child_node = Node::FindChildOf(node_ptr, partial_key);
+
+            if (child_node == nullptr)
+                return false;
+
+            if (Node::IsLazyExpanded(child_node))
+                return Node::CmpLazyExpansion(child_node, value) == 0;
+
+            node_ptr = child_node;
+        }
+
+        return true;
+    }
+
+    template <class Key, class Dispatch, class Allocator>
+    __target("avx2") void Art<Key, Dispatch, Allocator>::FindBatchGatherAvx2(const std::span<const Key> keys,
+                                                                             bool* out) const
+    {
+        using Node48 = art::Node48<Config>;
+        using Node256 = art::Node256<Config>;
+
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i byte_mask = _mm256_set1_epi64x(0xFF);
+        const __m256i tag_mask = _mm256_set1_epi64x(0x7);
+
+        size_t i = 0;
+        for (; i + kLanes <= keys.size(); i += kLanes)
+        {
+            __m256i values[kRegisters];
+            __m256i expected[kRegisters];
+            __m256i nodes[kRegisters];
+
+            for (size_t r = 0; r < kRegisters; ++r)
+            {
+                const Key* k = keys.data() + i + r * 4;
+                values[r] = _mm256_setr_epi64x(k[0], k[1], k[2], k[3]);
+
+                // a lane found its key once its child is the key stored using combined value/pointer slots
+                const __m256i shifted = _mm256_slli_epi64(values[r], KeyTraits<Key>::kLazyExpansionShift);
+                expected[r] = _mm256_or_si256(shifted, tag_mask);
+
+                nodes[r] = _mm256_set1_epi64x(reinterpret_cast<int64_t>(root_));
+            }
+
+            // lanes still traversing in lockstep
+            uint32_t active = (1 << kLanes) - 1;
+
+            for (int offset = Traits::kRootOffset; active != 0; offset -= 8)
+            {
+                __m256i addresses[kRegisters];
+                __m256i is_node48[kRegisters];
+                uint32_t gatherable = 0;
+
+                for (size_t r = 0; r < kRegisters; ++r)
+                {
+                    // node type from the pointer tags (type + 1) or the first byte of the headers
+                    __m256i types;
+                    if constexpr (Dispatch::kTaggedChildren)
+                    {
+                        addresses[r] = _mm256_andnot_si256(tag_mask, nodes[r]);
+                        types = _mm256_sub_epi64(_mm256_and_si256(nodes[r], tag_mask), _mm256_set1_epi64x(1));
+                    }
+                    else
+                    {
+                        addresses[r] = nodes[r];
+                        types = _mm256_and_si256(Gather(addresses[r], LaneMask(active, r)), byte_mask);
+                    }
+
+                    is_node48[r] = _mm256_cmpeq_epi64(types, _mm256_set1_epi64x(kNode48));
+                    const __m256i is_node256 = _mm256_cmpeq_epi64(types, _mm256_set1_epi64x(kNode256));
+
+                    gatherable |= MoveMask(_mm256_or_si256(is_node48[r], is_node256)) << r * 4;
+                }
+
+                // lanes in a Node4 or Node16 continue one by one
+                if (const uint32_t scalar = active & ~gatherable)
+                {
+                    alignas(32) Node* lane_nodes[kLanes];
+                    for (size_t r = 0; r < kRegisters; ++r)
+                        _mm256_store_si256(reinterpret_cast<__m256i*>(lane_nodes + r * 4), nodes[r]);
+
+                    for (uint32_t lanes = scalar; lanes != 0; lanes &= lanes - 1)
+                    {
+                        const uint32_t lane = __ctz(lanes);
+                        out[i + lane] = FindFrom(lane_nodes[lane], keys[i + lane], offset);
+                    }
+
+                    active &= gatherable;
+                    if (active == 0)
+                        break;
+                }
+
+                // get next 8 bit of every value as partial key
+                const __m128i shift = _mm_cvtsi32_si128(offset);
+
+                uint32_t found = 0;
+                uint32_t done = 0;
+
+                for (size_t r = 0; r < kRegisters; ++r)
+                {
+                    const __m256i mask = LaneMask(active, r);
+                    const __m256i partial_keys = _mm256_and_si256(_mm256_srl_epi64(values[r], shift), byte_mask);
+
+                    // Node48 lanes first gather the index of their child
+                    const __m256i node48_mask = _mm256_and_si256(mask, is_node48[r]);
+                    const __m256i key_addresses = _mm256_add_epi64(
+                        addresses[r], _mm256_add_epi64(partial_keys, _mm256_set1_epi64x(Node48::kKeysOffset)));
+                    const __m256i indices = _mm256_and_si256(Gather(key_addresses, node48_mask), byte_mask);
+
+                    const __m256i free = _mm256_and_si256(
+                        node48_mask, _mm256_cmpeq_epi64(indices, _mm256_set1_epi64x(Node48::kFreeMarker)));
+
+                    // gather the child pointers (lanes without a child get nullptr)
+                    const __m256i node48_slots = _mm256_add_epi64(
+                        addresses[r], _mm256_add_epi64(_mm256_slli_epi64(indices, 3),
+                                                       _mm256_set1_epi64x(Node48::kChildrenOffset)));
+                    const __m256i node256_slots = _mm256_add_epi64(
+                        addresses[r], _mm256_add_epi64(_mm256_slli_epi64(partial_keys, 3),
+                                                       _mm256_set1_epi64x(Node256::kChildrenOffset)));
+                    const __m256i slots = _mm256_blendv_epi8(node256_slots, node48_slots, is_node48[r]);
+
+                    nodes[r] = Gather(slots, _mm256_andnot_si256(free, mask));
+
+                    // lanes are done once they reach nullptr or a full key (always the case at the last level)
+                    const __m256i is_null = _mm256_cmpeq_epi64(nodes[r], zero);
+                    const __m256i is_key = _mm256_cmpeq_epi64(_mm256_and_si256(nodes[r], tag_mask), tag_mask);
+
+                    found |= MoveMask(_mm256_cmpeq_epi64(nodes[r], expected[r])) << r * 4;
+                    done |= MoveMask(_mm256_or_si256(is_null, is_key)) << r * 4;
+                }
+
+                for (uint32_t lanes = active & done; lanes != 0; lanes &= lanes - 1)
+                {
+                    const uint32_t lane = __ctz(lanes);
+                    out[i + lane] = found >> lane & 1;
+                }
+
+                active &= ~done;
+            }
+        }
+
+        // remaining keys not filling a whole group
+        for (; i < keys.size(); ++i)
+            out[i] = Find(keys[i]);
+    }
+
+#define ART_INSTANTIATE_GATHER(Key, Dispatch) \
+    template void Art<Key, Dispatch>::FindBatchGather(std::span<const Key>, bool*) const;
+
+    ART_FOR_EACH_CONFIG(ART_INSTANTIATE_GATHER)
+}
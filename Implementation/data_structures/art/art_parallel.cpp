@@ -0,0 +1,505 @@
+#include "art.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace art
+{
+    namespace
+    {
+        // keys are partitioned by their two most significant bytes (root and second level partial keys)
+        constexpr uint32_t kPartitionBits = 16;
+        constexpr uint32_t kPartitionCount = 1 << kPartitionBits;
+
+        // minimum number of keys per partitioning chunk (amortizes the per chunk histogram)
+        constexpr size_t kMinChunkSize = 4 * kPartitionCount;
+
+        // approximate number of keys handled by a single subtree building task
+        constexpr size_t kBuildTaskSize = 1 << 14;
+
+        // number of scan task groups per pool thread (smaller groups balance uneven subtree sizes)
+        constexpr size_t kScanGroupsPerThread = 8;
+
+        /**
+         * Splits task_count scan tasks into contiguous groups.
+         * Afterwards group g consists of the tasks [bounds[g], bounds[g + 1]).
+         */
+        std::vector<size_t> GetScanGroupBounds(const size_t task_count, const ThreadPool& pool)
+        {
+            const size_t group_count = std::min(task_count, kScanGroupsPerThread * pool.GetThreadCount());
+
+            std::vector<size_t> bounds(group_count + 1);
+            for (size_t g = 1; g <= group_count; ++g)
+                bounds[g] = g * task_count / group_count;
+
+            return bounds;
+        }
+
+        /**
+         * Scatters values into partitions by their two most significant bytes.
+         * Afterwards partition p is stored in partitioned at [offsets[p], offsets[p + 1]).
+         */
+        void RadixPartition(const std::vector<uint32_t>& values, ThreadPool& pool,
+                            std::vector<uint32_t>& partitioned, std::vector<size_t>& offsets)
+        {
+            const size_t chunk_count = std::clamp<size_t>(values.size() / kMinChunkSize, 1, pool.GetThreadCount());
+            const size_t chunk_size = (values.size() + chunk_count - 1) / chunk_count;
+
+            std::vector histograms(chunk_count, std::vector<size_t>(kPartitionCount));
+
+            // count partition sizes per chunk
+            for (size_t c = 0; c < chunk_count; ++c)
+            {
+                pool.Submit([&values, &histograms, c, chunk_size]
+                {
+                    auto& histogram = histograms[c];
+                    const size_t end = std::min(values.size(), (c + 1) * chunk_size);
+
+                    for (size_t i = c * chunk_size; i < end; ++i)
+                        ++histogram[values[i] >> (32 - kPartitionBits)];
+                });
+            }
+            pool.Wait();
+
+            // exclusive prefix sum over partitions and chunks turns the counts into write positions
+            offsets.assign(kPartitionCount + 1, 0);
+            size_t sum = 0;
+            for (uint32_t p = 0; p < kPartitionCount; ++p)
+            {
+                offsets[p] = sum;
+                for (auto& histogram : histograms)
+                {
+                    const size_t count = histogram[p];
+                    histogram[p] = sum;
+                    sum += count;
+                }
+            }
+            offsets[kPartitionCount] = sum;
+
+            partitioned.resize(values.size());
+
+            // scatter values to their partitions
+            for (size_t c = 0; c < chunk_count; ++c)
+            {
+                pool.Submit([&values, &histograms, &partitioned, c, chunk_size]
+                {
+                    auto& positions = histograms[c];
+                    const size_t end = std::min(values.size(), (c + 1) * chunk_size);
+
+                    for (size_t i = c * chunk_size; i < end; ++i)
+                        partitioned[positions[values[i] >> (32 - kPartitionBits)]++] = values[i];
+                });
+            }
+            pool.Wait();
+        }
+
+        /**
+         * Runs task for every partition with keys.
+         * Consecutive partitions are grouped into a single pool task so small partitions don't end up as tiny tasks.
+         */
+        void ForEachPartition(const std::vector<size_t>& offsets, ThreadPool& pool, const std::function<void(uint32_t)>& task)
+        {
+            uint32_t first = 0;
+            for (uint32_t last = 1; last <= kPartitionCount; ++last)
+            {
+                if (last < kPartitionCount && offsets[last] - offsets[first] < kBuildTaskSize)
+                    continue;
+
+                pool.Submit([&offsets, &task, first, last]
+                {
+                    for (uint32_t p = first; p < last; ++p)
+                        if (offsets[p] != offsets[p + 1])
+                            task(p);
+                });
+
+                first = last;
+            }
+            pool.Wait();
+        }
+    }
+
+    template <class Key, class Dispatch, class Allocator>
+    Art<Key, Dispatch, Allocator>::Art(const std::vector<Key>& values, ThreadPool& pool)
+        requires (sizeof(Key) == 4)
+    {
+        std::vector<uint32_t> partitioned;
+        std::vector<size_t> offsets;
+
+        RadixPartition(values, pool, partitioned, offsets);
+
+        // build the subtrees below the second level
+        std::vector<Node*> subtrees(kPartitionCount, nullptr);
+
+        ForEachPartition(offsets, pool, [&partitioned, &offsets, &subtrees](const uint32_t p)
+        {
+            uint32_t* begin = partitioned.data() + offsets[p];
+            uint32_t* end = partitioned.data() + offsets[p + 1];
+
+            std::sort(begin, end);
+            end = std::unique(begin, end);
+
+            subtrees[p] = BuildSubtree(begin, end, 8);
+        });
+
+        /**
+         * Stitch the subtrees together under the second level nodes and the root.
+         * Only a few hundred exactly sized nodes are created here so this is done sequentially.
+         */
+        std::vector<std::pair<uint8_t, Node*>> root_children;
+
+        for (uint32_t partial_key = 0; partial_key < 256; ++partial_key)
+        {
+            Node** children = subtrees.data() + (partial_key << 8);
+
+            uint16_t child_count = 0;
+            Node* last_child = nullptr;
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                if (children[i] == nullptr) continue;
+                ++child_count;
+                last_child = children[i];
+            }
+
+            if (child_count == 0)
+                continue;
+
+            // a single key below this partial key stays lazy expanded at the root
+            if (child_count == 1 && Node::IsLazyExpanded(last_child))
+            {
+                root_children.emplace_back(partial_key, last_child);
+                continue;
+            }
+
+            Node* node = Node::Create(child_count);
+            for (uint32_t i = 0; i < 256; ++i)
+                if (children[i] != nullptr)
+                    node->Insert(i, children[i]);
+
+            root_children.emplace_back(partial_key, Node::Tag(node));
+        }
+
+        Node* root = Node::Create(static_cast<uint16_t>(root_children.size()));
+        for (const auto& [partial_key, child] : root_children)
+            root->Insert(partial_key, child);
+
+        root_ = Node::Tag(root);
+    }
+
+    template <class Key, class Dispatch, class Allocator>
+    void Art<Key, Dispatch, Allocator>::InsertBatchParallel(const std::vector<Key>& values, ThreadPool& pool)
+        requires (sizeof(Key) == 4)
+    {
+        if (values.empty())
+            return;
+
+        std::vector<uint32_t> partitioned;
+        std::vector<size_t> offsets;
+
+        RadixPartition(values, pool, partitioned, offsets);
+
+        // the partitions are inserted concurrently, so their keys are appended to the change feed serially afterward
+        auto feed = std::move(feed_);
+
+        // sort and deduplicate every partition, afterwards partition p is stored at [offsets[p], ends[p])
+        std::vector<size_t> ends(offsets.begin(), offsets.end() - 1);
+
+        ForEachPartition(offsets, pool, [&partitioned, &offsets, &ends](const uint32_t p)
+        {
+            uint32_t* begin = partitioned.data() + offsets[p];
+            uint32_t* end = partitioned.data() + offsets[p + 1];
+
+            std::sort(begin, end);
+            ends[p] = std::unique(begin, end) - partitioned.data();
+        });
+
+        /**
+         * Prepare the root and second level serially so that afterwards every partition owns a child slot in its
+         * second level node. Missing slots are filled with the partition's first key (lazy expanded) which the
+         * partition task later merges with the remaining keys.
+         */
+        const auto insert_into_root = [this](const uint8_t partial_key, Node* child)
+        {
+            Node* root = Node::Untag(root_);
+            Node* new_root = root->Insert(partial_key, child);
+            if (new_root != root)
+            {
+                root->Delete();
+                root_ = Node::Tag(new_root);
+            }
+        };
+
+        for (uint32_t partial_key = 0; partial_key < 256; ++partial_key)
+        {
+            const uint32_t first = partial_key << 8;
+
+            size_t key_count = 0;
+            uint16_t child_count = 0;
+            for (uint32_t p = first; p < first + 256; ++p)
+            {
+                key_count += ends[p] - offsets[p];
+                child_count += ends[p] != offsets[p];
+            }
+
+            if (key_count == 0)
+                continue;
+
+            Node* child = Node::Untag(root_)->FindChild(partial_key);
+            Node* node;
+
+            if (child == nullptr)
+            {
+                // a single new key stays lazy expanded at the root
+                if (key_count == 1)
+                {
+                    uint32_t p = first;
+                    for (; ends[p] == offsets[p]; ++p);
+
+                    insert_into_root(partial_key, Node::CreateLazyExpansion(partitioned[offsets[p]]));
+                    continue;
+                }
+
+                node = Node::Create(child_count);
+            }
+            else if (Node::IsLazyExpanded(child))
+            {
+                const uint32_t key = Node::GetLazyExpansion(child);
+                const uint32_t p = key >> 16;
+
+                if (key_count == 1 && ends[p] != offsets[p] && partitioned[offsets[p]] == key)
+                    // key already exists
+                    continue;
+
+                // expand the stored key into a second level node
+                node = Node::Create(child_count + (ends[p] == offsets[p]));
+                node->Insert(key >> 16 & 0xFF, child);
+            }
+            else
+                node = Node::Untag(child);
+
+            for (uint32_t p = first; p < first + 256; ++p)
+            {
+                if (ends[p] == offsets[p] || node->FindChild(p & 0xFF) != Node::null_node)
+                    continue;
+
+                Node* new_node = node->Insert(p & 0xFF, Node::CreateLazyExpansion(partitioned[offsets[p]]));
+                if (new_node != node)
+                {
+                    node->Delete();
+                    node = new_node;
+                }
+            }
+
+            if (child == nullptr)
+                insert_into_root(partial_key, Node::Tag(node));
+            else
+                Node::Untag(root_)->FindChild(partial_key) = Node::Tag(node);
+        }
+
+        /**
+         * Insert the partitions into their subtrees.
+         * Every task only writes to the child slots of its own partitions so no synchronization is needed.
+         */
+        ForEachPartition(offsets, pool, [this, &partitioned, &offsets, &ends](const uint32_t p)
+        {
+            Node* child = Node::Untag(root_)->FindChild(p >> 8);
+
+            // already inserted at the root
+            if (Node::IsLazyExpanded(child))
+                return;
+
+            Node*& slot = Node::Untag(child)->FindChild(p & 0xFF);
+
+            const uint32_t* begin = partitioned.data() + offsets[p];
+            const uint32_t* end = partitioned.data() + ends[p];
+
+            if (!Node::IsLazyExpanded(slot))
+            {
+                for (auto it = begin; it != end; ++it)
+                    Insert(*it);
+                return;
+            }
+
+            // a single key is stored at the slot -> build the whole subtree bottom-up
+            const uint32_t key = Node::GetLazyExpansion(slot);
+
+            if (std::binary_search(begin, end, key))
+            {
+                slot = BuildSubtree(begin, end, 8);
+                return;
+            }
+
+            std::vector<uint32_t> merged;
+            merged.reserve(end - begin + 1);
+            merged.insert(merged.end(), begin, end);
+            merged.insert(std::lower_bound(merged.begin(), merged.end(), key), key);
+
+            slot = BuildSubtree(merged.data(), merged.data() + merged.size(), 8);
+        });
+
+        feed_ = std::move(feed);
+
+        if (feed_)
+            for (uint32_t p = 0; p + 1 < offsets.size(); ++p)
+                for (size_t i = offsets[p]; i < ends[p]; ++i)
+                    feed_->Append(ChangeOperation::kInsert, partitioned[i]);
+    }
+
+    template <class Key, class Dispatch, class Allocator>
+    std::vector<std::vector<Key>> Art<Key, Dispatch, Allocator>::FindRangeParallel(const Key from, const Key to,
+                                                                                   ThreadPool& pool) const
+        requires (sizeof(Key) == 4)
+    {
+        const auto tasks = GetScanTasks(from, to);
+        const auto bounds = GetScanGroupBounds(tasks.size(), pool);
+
+        std::vector<std::vector<Key>> chunks(bounds.size() - 1);
+
+        for (size_t g = 0; g < chunks.size(); ++g)
+        {
+            pool.Submit([&tasks, &bounds, &chunks, g, from, to]
+            {
+                chunks[g] = ScanSubtrees(tasks.data() + bounds[g], tasks.data() + bounds[g + 1], from, to);
+            });
+        }
+        pool.Wait();
+
+        std::erase_if(chunks, [](const auto& chunk) { return chunk.empty(); });
+
+        return chunks;
+    }
+
+    template <class Key, class Dispatch, class Allocator>
+    void Art<Key, Dispatch, Allocator>::ScanParallel(const Key from, const Key to, ThreadPool& pool,
+                                                     const std::function<void(const std::vector<Key>&)>& callback,
+                                                     const bool ordered) const
+        requires (sizeof(Key) == 4)
+    {
+        const auto tasks = GetScanTasks(from, to);
+        const auto bounds = GetScanGroupBounds(tasks.size(), pool);
+        const size_t group_count = bounds.size() - 1;
+
+        if (!ordered)
+        {
+            for (size_t g = 0; g < group_count; ++g)
+            {
+                pool.Submit([&tasks, &bounds, &callback, g, from, to]
+                {
+                    const auto chunk = ScanSubtrees(tasks.data() + bounds[g], tasks.data() + bounds[g + 1], from, to);
+                    if (!chunk.empty())
+                        callback(chunk);
+                });
+            }
+            pool.Wait();
+
+            return;
+        }
+
+        // groups are submitted in ascending order and complete roughly in that order
+        // -> hand out each chunk as soon as all chunks before it have been handed out
+        std::vector<std::vector<Key>> chunks(group_count);
+        std::vector<std::atomic<bool>> ready(group_count);
+
+        for (size_t g = 0; g < group_count; ++g)
+        {
+            pool.Submit([&tasks, &bounds, &chunks, &ready, g, from, to]
+            {
+                chunks[g] = ScanSubtrees(tasks.data() + bounds[g], tasks.data() + bounds[g + 1], from, to);
+
+                ready[g].store(true, std::memory_order_release);
+                ready[g].notify_one();
+            });
+        }
+
+        for (size_t g = 0; g < group_count; ++g)
+        {
+            ready[g].wait(false, std::memory_order_acquire);
+
+            if (!chunks[g].empty())
+                callback(chunks[g]);
+
+            // release the chunk right away to bound the memory of large scans
+            std::vector<Key>().swap(chunks[g]);
+        }
+        pool.Wait();
+    }
+
+    template <class Key, class Dispatch, class Allocator>
+    auto Art<Key, Dispatch, Allocator>::GetScanTasks(const Key from, const Key to) const -> std::vector<ScanTask>
+    {
+        std::vector<ScanTask> tasks;
+
+        if (from > to)
+            return tasks;
+
+        const uint8_t from_key = from >> 24 & 0xFF;
+        const uint8_t to_key = to >> 24 & 0xFF;
+
+        for (const auto& [partial_key, child] : Node::Untag(root_)->GetChildren(from_key, to_key))
+        {
+            const bool lower_bounded = partial_key == from_key;
+            const bool upper_bounded = partial_key == to_key;
+
+            if (Node::IsLazyExpanded(child))
+            {
+                tasks.push_back({child, 16, lower_bounded, upper_bounded});
+                continue;
+            }
+
+            // split again at the second level
+            const uint8_t child_from_key = lower_bounded ? from >> 16 & 0xFF : 0x00;
+            const uint8_t child_to_key = upper_bounded ? to >> 16 & 0xFF : 0xFF;
+
+            for (const auto& [child_partial_key, grandchild] : Node::Untag(child)->GetChildren(child_from_key, child_to_key))
+            {
+                tasks.push_back({
+                    grandchild, 8,
+                    lower_bounded && child_partial_key == child_from_key,
+                    upper_bounded && child_partial_key == child_to_key
+                });
+            }
+        }
+
+        return tasks;
+    }
+
+    template <class Key, class Dispatch, class Allocator>
+    std::vector<Key> Art<Key, Dispatch, Allocator>::ScanSubtrees(const ScanTask* begin, const ScanTask* end,
+                                                                 const Key from, const Key to)
+    {
+        std::vector<Key> res;
+
+        for (auto task = begin; task != end; ++task)
+        {
+            if (Node::IsLazyExpanded(task->node))
+            {
+                if (Node::CmpLazyExpansion(task->node, from) <= 0 && Node::CmpLazyExpansion(task->node, to) >= 0)
+                    res.push_back(Node::GetLazyExpansion(task->node));
+                continue;
+            }
+
+            std::vector<Key> p;
+            const Node* node = Node::Untag(task->node);
+            if (task->lower_bounded && task->upper_bounded)
+                p = node->GetRange(from, to, task->offset);
+            else if (task->lower_bounded)
+                p = node->GetLowerRange(from, task->offset);
+            else if (task->upper_bounded)
+                p = node->GetUpperRange(to, task->offset);
+            else
+                p = node->GetFullRange();
+
+            res.insert(res.end(), p.begin(), p.end());
+        }
+
+        return res;
+    }
+
+#define ART_INSTANTIATE_PARALLEL(Key, Dispatch) \
+    template Art<Key, Dispatch>::Art(const std::vector<Key>&, ThreadPool&); \
+    template void Art<Key, Dispatch>::InsertBatchParallel(const std::vector<Key>&, ThreadPool&); \
+    template std::vector<std::vector<Key>> Art<Key, Dispatch>::FindRangeParallel(Key, Key, ThreadPool&) const; \
+    template void Art<Key, Dispatch>::ScanParallel(Key, Key, ThreadPool&, \
+                                                   const std::function<void(const std::vector<Key>&)>&, bool) const;
+
+    ART_FOR_EACH_DISPATCH(ART_INSTANTIATE_PARALLEL, uint32_t)
+}
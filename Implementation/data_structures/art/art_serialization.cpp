@@ -0,0 +1,364 @@
+#include "art.h"
+
+#include <cstring>
+#include "file_io.h"
+#include "key_stream.h"
+
+/**
+ * File format written by Art::Save:
+ *
+ *  header:     "ARTS" | format version (1 byte) | key size in bytes (1 byte)
+ *  node:       node type (1 byte) | child count (1 byte, 0 for a full Node256)
+ *              | partial keys of the children in ascending order (1 byte each)
+ *              | bitmap with bit i set if child i is a full key ((child count + 7) / 8 bytes)
+ *              | children in the same order, either a full key (key size bytes, native byte order) or a node
+ *
+ * The root node directly follows the header and its subtree is stored in pre-order, so the tree is rebuilt in a single
+ * sequential pass. Full keys are stored like in combined value/pointer slots (without the partial key of the root for
+ * 64 bit keys, see KeyTraits).
+ *
+ * Art::Export writes only the keys instead (see key_stream.h), which Art::Import builds a tree from.
+ */
+namespace art
+{
+    namespace
+    {
+        constexpr char kMagic[4]{'A', 'R', 'T', 'S'};
+        constexpr uint8_t kFormatVersion = 1;
+
+        /**
+         * Builds a tree bottom-up from strictly ascending keys without holding them (see Art::Import).
+         *
+         * Only the nodes on the path of the last key are open, every level collects the children of its open node.
+         * Once a key leaves the subtree of an open node, the node is created exactly sized from its children and
+         * becomes a child of the level above. Like in Art::BuildSubtree, a subtree of a single key is stored as the
+         * key itself.
+         */
+        template <class Node, class Key>
+        class SortedBuilder
+        {
+            using Traits = KeyTraits<Key>;
+
+        public:
+            SortedBuilder() = default;
+
+            ~SortedBuilder()
+            {
+                // only subtrees of an unfinished build are left
+                for (Level& level : levels_)
+                    for (uint16_t i = 0; i < level.child_count; ++i)
+                        if (!Node::IsLazyExpanded(level.children[i]))
+                            Node::Untag(level.children[i])->Destruct();
+            }
+
+            SortedBuilder(const SortedBuilder&) = delete;
+
+            SortedBuilder& operator=(const SortedBuilder&) = delete;
+
+            /**
+             * Adds a key greater than all keys added before.
+             */
+            void Add(const Key key)
+            {
+                if (key_count_ != 0)
+                {
+                    // the open nodes below the first level at which key leaves the path of the last key are complete
+                    int depth = 0;
+                    while (PartialKey(key, depth) == PartialKey(previous_, depth))
+                        ++depth;
+
+                    CloseLevels(depth);
+                }
+
+                AddChild(Traits::kLevels - 1, key & 0xFF, Node::CreateLazyExpansion(key));
+
+                previous_ = key;
+                ++key_count_;
+            }
+
+            /**
+             * Returns the tagged root of all keys added (an empty node if there are none).
+             */
+            Node* Finish()
+            {
+                if (key_count_ != 0)
+                    CloseLevels(0);
+
+                // the root is always a node
+                Level& root = levels_[0];
+                Node* node = Node::Create(root.child_count);
+                for (uint16_t i = 0; i < root.child_count; ++i)
+                    node->Insert(root.partial_keys[i], root.children[i]);
+                root.child_count = 0;
+
+                return Node::Tag(node);
+            }
+
+        private:
+            struct Level
+            {
+                uint8_t partial_keys[256];
+                Node* children[256];
+                uint16_t child_count = 0;
+            };
+
+            static uint8_t PartialKey(const Key key, const int depth)
+            {
+                return key >> (Traits::kRootOffset - 8 * depth) & 0xFF;
+            }
+
+            void AddChild(const int depth, const uint8_t partial_key, Node* child)
+            {
+                Level& level = levels_[depth];
+                level.partial_keys[level.child_count] = partial_key;
+                level.children[level.child_count++] = child;
+            }
+
+            /**
+             * Creates the open nodes below depth (deepest first) and adds each to its parent.
+             */
+            void CloseLevels(const int depth)
+            {
+                for (int d = Traits::kLevels - 1; d > depth; --d)
+                {
+                    Level& level = levels_[d];
+
+                    Node* child;
+                    if (level.child_count == 1 && Node::IsLazyExpanded(level.children[0]))
+                    {
+                        child = level.children[0];
+                    }
+                    else
+                    {
+                        // node is exactly sized so it never grows
+                        Node* node = Node::Create(level.child_count);
+                        for (uint16_t i = 0; i < level.child_count; ++i)
+                            node->Insert(level.partial_keys[i], level.children[i]);
+                        child = Node::Tag(node);
+                    }
+
+                    level.child_count = 0;
+                    AddChild(d - 1, PartialKey(previous_, d - 1), child);
+                }
+            }
+
+            Level levels_[Traits::kLevels];
+            Key previous_{};
+            uint64_t key_count_ = 0;
+        };
+    }
+
+    template <class Key, class Dispatch, class Allocator>
+    bool Art<Key, Dispatch, Allocator>::Save(const std::string& path) const
+    {
+        FileWriter writer(path);
+        if (!writer.IsOpen())
+            return false;
+
+        writer.Write(kMagic, sizeof(kMagic));
+        writer.Write(kFormatVersion);
+        writer.Write(static_cast<uint8_t>(sizeof(Key)));
+
+        SaveNode(writer, Node::Untag(root_));
+
+        return writer.Close();
+    }
+
+    template <class Key, class Dispatch, class Allocator>
+    template <class Writer>
+    void Art<Key, Dispatch, Allocator>::SaveNode(Writer& writer, const Node* node)
+    {
+        const auto children = node->GetChildren(0x00, 0xFF);
+
+        writer.Write(node->type_);
+        writer.Write(static_cast<uint8_t>(children.size()));
+
+        uint8_t key_flags[256 / 8]{};
+        for (size_t i = 0; i < children.size(); ++i)
+        {
+            writer.Write(children[i].first);
+            if (Node::IsLazyExpanded(children[i].second))
+                key_flags[i / 8] |= 1 << i % 8;
+        }
+        writer.Write(key_flags, (children.size() + 7) / 8);
+
+        for (const auto& [_, child] : children)
+        {
+            if (Node::IsLazyExpanded(child))
+                writer.Write(Node::GetLazyExpansion(child));
+            else
+                SaveNode(writer, Node::Untag(child));
+        }
+    }
+
+    template <class Key, class Dispatch, class Allocator>
+    bool Art<Key, Dispatch, Allocator>::Load(const std::string& path)
+    {
+        FileReader reader(path);
+        if (!reader.IsOpen())
+            return false;
+
+        char magic[sizeof(kMagic)];
+        uint8_t version;
+        uint8_t key_size;
+        if (!reader.Read(magic, sizeof(magic)) || !reader.Read(version) || !reader.Read(key_size))
+            return false;
+
+        if (memcmp(magic, kMagic, sizeof(kMagic)) != 0 || version != kFormatVersion || key_size != sizeof(Key))
+            return false;
+
+        Node* root = LoadNode(reader, Traits::kRootOffset);
+        if (root == nullptr)
+            return false;
+
+        if (!reader.AtEnd())
+        {
+            Node::Untag(root)->Destruct();
+            return false;
+        }
+
+        Node::Untag(root_)->Destruct();
+        root_ = root;
+
+        if (feed_)
+            feed_->Reset();
+
+        return true;
+    }
+
+    template <class Key, class Dispatch, class Allocator>
+    template <class Reader>
+    auto Art<Key, Dispatch, Allocator>::LoadNode(Reader& reader, const int offset) -> Node*
+    {
+        uint8_t type;
+        uint8_t count;
+        if (!reader.Read(type) || !reader.Read(count))
+            return nullptr;
+
+        const uint16_t child_count = type == kNode256 && count == 0 ? 256 : count;
+
+        uint8_t partial_keys[256];
+        uint8_t key_flags[256 / 8];
+        if (!reader.Read(partial_keys, child_count) || !reader.Read(key_flags, (child_count + 7) / 8))
+            return nullptr;
+
+        // nodes are written exactly sized (only an empty root has no children)
+        Node* node = Node::Create(child_count);
+
+        bool valid = node->type_ == type;
+        for (uint16_t i = 0; valid && i < child_count; ++i)
+        {
+            if (i != 0 && partial_keys[i] <= partial_keys[i - 1])
+            {
+                valid = false;
+                break;
+            }
+
+            Node* child;
+            if (key_flags[i / 8] >> i % 8 & 1)
+            {
+                Key key;
+                valid = reader.Read(key);
+                child = Node::CreateLazyExpansion(key);
+            }
+            else
+            {
+                // the last level only stores full keys
+                child = offset > 0 ? LoadNode(reader, offset - 8) : nullptr;
+                valid = child != nullptr;
+            }
+
+            // node is exactly sized so it never grows
+            if (valid)
+                node->Insert(partial_keys[i], child);
+        }
+
+        if (!valid)
+        {
+            node->Destruct();
+            return nullptr;
+        }
+
+        return Node::Tag(node);
+    }
+
+    template <class Key, class Dispatch, class Allocator>
+    bool Art<Key, Dispatch, Allocator>::Export(const std::string& path) const
+    {
+        KeyStreamWriter<Key> writer(path);
+        if (!writer.IsOpen())
+            return false;
+
+        for (const auto& [partial_key, child] : Node::Untag(root_)->GetChildren(0x00, 0xFF))
+        {
+            if (Node::IsLazyExpanded(child))
+                writer.Write(GetKey(child, partial_key));
+            else
+                ExportNode(writer, Node::Untag(child), partial_key);
+        }
+
+        return writer.Close();
+    }
+
+    template <class Key, class Dispatch, class Allocator>
+    template <class Writer>
+    void Art<Key, Dispatch, Allocator>::ExportNode(Writer& writer, const Node* node, const uint8_t root_key)
+    {
+        for (const auto& [_, child] : node->GetChildren(0x00, 0xFF))
+        {
+            if (Node::IsLazyExpanded(child))
+                writer.Write(GetKey(child, root_key));
+            else
+                ExportNode(writer, Node::Untag(child), root_key);
+        }
+    }
+
+    template <class Key, class Dispatch, class Allocator>
+    bool Art<Key, Dispatch, Allocator>::Import(const std::string& path)
+    {
+        KeyStreamReader<Key> reader(path);
+        if (!reader.IsOpen())
+            return false;
+
+        SortedBuilder<Node, Key> builder;
+
+        Key keys[kKeyStreamChunkSize];
+        for (size_t count; (count = reader.Read(keys, kKeyStreamChunkSize)) != 0;)
+            for (size_t i = 0; i < count; ++i)
+                builder.Add(keys[i]);
+
+        if (reader.Failed())
+            return false;
+
+        Node::Untag(root_)->Destruct();
+        root_ = builder.Finish();
+
+        if (feed_)
+            feed_->Reset();
+
+        return true;
+    }
+
+    template <class Key, class Dispatch, class Allocator>
+    std::optional<uint64_t> Art<Key, Dispatch, Allocator>::ExportSnapshot(const std::string& path) const
+    {
+        if (!feed_)
+            return {};
+
+        // no insertion runs concurrently so the keys include exactly the changes up to the current sequence number
+        const uint64_t sequence = feed_->GetSequence();
+        if (!Export(path))
+            return {};
+
+        return sequence;
+    }
+
+#define ART_INSTANTIATE_SERIALIZATION(Key, Dispatch) \
+    template bool Art<Key, Dispatch>::Save(const std::string&) const; \
+    template bool Art<Key, Dispatch>::Load(const std::string&); \
+    template bool Art<Key, Dispatch>::Export(const std::string&) const; \
+    template bool Art<Key, Dispatch>::Import(const std::string&); \
+    template std::optional<uint64_t> Art<Key, Dispatch>::ExportSnapshot(const std::string&) const;
+
+    ART_FOR_EACH_CONFIG(ART_INSTANTIATE_SERIALIZATION)
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace art
+{
+    enum class ChangeOperation : uint8_t
+    {
+        kInsert,
+    };
+
+    template <class Key>
+    struct Change
+    {
+        uint64_t sequence;
+        ChangeOperation operation;
+        Key key;
+    };
+
+    /**
+     * Bounded log of the latest changes of a tree (see Art::EnableChangeFeed) which consumers tail from the sequence
+     * number of the last change they applied. Sequence numbers start at 1 and increase by one per change
+     * (and per Reset).
+     *
+     * A single writer appends while any number of consumers read concurrently without locks: every slot is a seqlock
+     * holding the sequence number of its change, which the writer clears while it overwrites the slot. Consumers
+     * falling behind by more than the capacity lose changes and have to continue from a snapshot instead (see
+     * Art::ExportSnapshot):
+     *
+     *  1. Import the snapshot and continue at the sequence number it was taken at.
+     *  2. Read the changes after the last applied one and insert them (e.g. as a batch).
+     *  3. Go back to 1. if Read reports that the changes were overwritten.
+     */
+    template <class Key>
+    class ChangeFeed
+    {
+    public:
+        /**
+         * Keeps the last capacity (rounded up to a power of two) changes.
+         */
+        explicit ChangeFeed(const size_t capacity) : capacity_{std::bit_ceil(std::max<size_t>(capacity, 1))},
+                                                     slots_{std::make_unique<Slot[]>(capacity_)}
+        {
+        }
+
+        /**
+         * Returns the sequence number of the latest change (0 if there is none).
+         */
+        uint64_t GetSequence() const
+        {
+            return sequence_.load(std::memory_order_acquire);
+        }
+
+        size_t GetCapacity() const
+        {
+            return capacity_;
+        }
+
+        void Append(const ChangeOperation operation, const Key key)
+        {
+            const uint64_t sequence = sequence_.load(std::memory_order_relaxed) + 1;
+            Slot& slot = slots_[sequence & (capacity_ - 1)];
+
+            // readers still copying the overwritten change see the cleared sequence number
+            slot.sequence.store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            slot.operation.store(operation, std::memory_order_relaxed);
+            slot.key.store(key, std::memory_order_relaxed);
+            slot.sequence.store(sequence, std::memory_order_release);
+
+            sequence_.store(sequence, std::memory_order_release);
+        }
+
+        /**
+         * Appends up to max_count of the changes following the change with sequence number from to out. Returns
+         * false (leaving out unchanged) if some of them were already overwritten or the tree was replaced (see Reset),
+         * so the consumer has to continue from a snapshot.
+         */
+        bool Read(const uint64_t from, std::vector<Change<Key>>& out, const size_t max_count = SIZE_MAX) const
+        {
+            if (from < first_.load(std::memory_order_acquire))
+                return false;
+
+            const uint64_t to = std::min(GetSequence(), from + std::min<uint64_t>(max_count, capacity_));
+            const size_t size = out.size();
+
+            for (uint64_t sequence = from + 1; sequence <= to; ++sequence)
+            {
+                const Slot& slot = slots_[sequence & (capacity_ - 1)];
+
+                if (slot.sequence.load(std::memory_order_acquire) != sequence)
+                    break;
+
+                const Change<Key> change{sequence, slot.operation.load(std::memory_order_relaxed),
+                                         slot.key.load(std::memory_order_relaxed)};
+
+                // the change is only valid if the writer didn't start overwriting it meanwhile
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+                    break;
+
+                out.push_back(change);
+            }
+
+            if (out.size() - size == to - std::min(from, to))
+                return true;
+
+            out.resize(size);
+            return false;
+        }
+
+        /**
+         * Marks all changes up to now as unusable for tailing since the tree was replaced as a whole (e.g. by Load).
+         * Consumers have to continue from a snapshot taken afterward.
+         *
+         * The reset takes a sequence number of its own (without a change) so that even consumers which applied all
+         * changes before it are behind the snapshots taken after it.
+         */
+        void Reset()
+        {
+            const uint64_t sequence = sequence_.load(std::memory_order_relaxed) + 1;
+
+            first_.store(sequence, std::memory_order_release);
+            sequence_.store(sequence, std::memory_order_release);
+        }
+
+    private:
+        struct Slot
+        {
+            // 0 while the slot is empty or being overwritten
+            std::atomic<uint64_t> sequence{0};
+            std::atomic<ChangeOperation> operation{ChangeOperation::kInsert};
+            std::atomic<Key> key{0};
+        };
+
+        const size_t capacity_;
+        std::unique_ptr<Slot[]> slots_;
+        std::atomic<uint64_t> sequence_{0};
+        // sequence number of the first snapshot consumers may tail from
+        std::atomic<uint64_t> first_{0};
+    };
+}
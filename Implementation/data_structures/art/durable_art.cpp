@@ -0,0 +1,450 @@
+#include "durable_art.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "file_io.h"
+
+/**
+ * Log segment format (native byte order), segments are named wal.<generation>.log:
+ *
+ *  header:     "ARTW" | format version (1 byte) | key size in bytes (1 byte) | 2 bytes padding
+ *  group:      key count (4 byte) | checksum of the keys (4 byte) | keys
+ *
+ * A group is appended with a single write. A crash can leave a partially written last group which is detected by its
+ * size or checksum and cut off when the log is opened again.
+ */
+namespace art
+{
+    namespace
+    {
+        constexpr char kLogMagic[4]{'A', 'R', 'T', 'W'};
+        constexpr uint8_t kLogVersion = 1;
+        constexpr size_t kLogHeaderSize = 8;
+
+        constexpr char kCheckpointFile[] = "checkpoint.art";
+        constexpr char kCheckpointTempFile[] = "checkpoint.art.tmp";
+        constexpr std::string_view kLogPrefix = "wal.";
+        constexpr std::string_view kLogSuffix = ".log";
+
+        struct GroupHeader
+        {
+            uint32_t count;
+            uint32_t checksum;
+        };
+
+        /**
+         * 32 bit FNV-1a hash.
+         */
+        uint32_t Checksum(const void* data, const size_t size)
+        {
+            auto bytes = static_cast<const uint8_t*>(data);
+
+            uint32_t hash = 2166136261u;
+            for (size_t i = 0; i < size; ++i)
+                hash = (hash ^ bytes[i]) * 16777619u;
+
+            return hash;
+        }
+
+        bool WriteAll(const int fd, const void* data, size_t size)
+        {
+            auto bytes = static_cast<const char*>(data);
+
+            while (size != 0)
+            {
+                const ssize_t n = write(fd, bytes, size);
+                if (n < 0)
+                    return false;
+
+                bytes += n;
+                size -= n;
+            }
+
+            return true;
+        }
+
+        /**
+         * Flushes a file (or the entries of a directory) to stable storage.
+         */
+        bool SyncPath(const std::string& path, const int flags)
+        {
+            const int fd = open(path.c_str(), O_RDONLY | flags);
+            if (fd < 0)
+                return false;
+
+            const bool ok = fsync(fd) == 0;
+            close(fd);
+
+            return ok;
+        }
+
+        /**
+         * Returns the generations of all log segments in a directory in ascending order.
+         */
+        std::vector<uint64_t> GetLogGenerations(const std::string& directory)
+        {
+            std::vector<uint64_t> generations;
+
+            std::error_code error;
+            for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+            {
+                const std::string name = entry.path().filename();
+                if (name.size() <= kLogPrefix.size() + kLogSuffix.size() || !name.starts_with(kLogPrefix) ||
+                    !name.ends_with(kLogSuffix))
+                    continue;
+
+                const char* first = name.data() + kLogPrefix.size();
+                const char* last = name.data() + name.size() - kLogSuffix.size();
+
+                uint64_t generation;
+                if (const auto [end, ec] = std::from_chars(first, last, generation); ec == std::errc{} && end == last)
+                    generations.push_back(generation);
+            }
+
+            std::ranges::sort(generations);
+
+            return generations;
+        }
+    }
+
+    template <class Key, class Dispatch>
+    DurableArt<Key, Dispatch>::~DurableArt()
+    {
+        Close();
+    }
+
+    template <class Key, class Dispatch>
+    bool DurableArt<Key, Dispatch>::Open(const std::string& directory, const DurabilityOptions& options)
+    {
+        Close();
+        tree_.reset();
+        directory_.clear();
+
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error)
+            return false;
+
+        // a partially recovered tree must not answer lookups
+        const auto fail = [this]
+        {
+            Close();
+            tree_.reset();
+            directory_.clear();
+            return false;
+        };
+
+        directory_ = directory;
+        options_ = options;
+        tree_ = std::make_unique<Tree>();
+        inserts_since_checkpoint_ = 0;
+
+        const std::filesystem::path root{directory};
+
+        // a checkpoint that was never renamed is incomplete
+        std::filesystem::remove(root / kCheckpointTempFile, error);
+
+        if (std::filesystem::exists(root / kCheckpointFile) && !tree_->Load(root / kCheckpointFile))
+            return fail();
+
+        const auto generations = GetLogGenerations(directory_);
+
+        int64_t log_size = 0;
+        for (const uint64_t generation : generations)
+        {
+            log_size = ReplayLog(GetLogPath(generation));
+            if (log_size < 0)
+                return fail();
+        }
+
+        // continue the last segment (or restart it if its header was never completely written)
+        const uint64_t generation = generations.empty() ? 0 : generations.back();
+        if (log_size == 0)
+            return StartLogSegment(generation) || fail();
+
+        log_generation_ = generation;
+        log_fd_ = open(GetLogPath(generation).c_str(), O_WRONLY | O_APPEND);
+
+        // cut off a partially written group so new groups follow the last complete one
+        if (log_fd_ < 0 || ftruncate(log_fd_, log_size) != 0)
+            return fail();
+
+        return true;
+    }
+
+    template <class Key, class Dispatch>
+    std::string DurableArt<Key, Dispatch>::GetLogPath(const uint64_t generation) const
+    {
+        return std::filesystem::path(directory_) /
+               (std::string(kLogPrefix) + std::to_string(generation) + std::string(kLogSuffix));
+    }
+
+    template <class Key, class Dispatch>
+    bool DurableArt<Key, Dispatch>::StartLogSegment(const uint64_t generation)
+    {
+        if (log_fd_ >= 0)
+        {
+            // Sync only flushes the current segment, so the groups of the sealed one have to be durable before
+            const bool synced = fdatasync(log_fd_) == 0;
+            close(log_fd_);
+            log_fd_ = -1;
+
+            if (!synced)
+                return false;
+        }
+
+        log_generation_ = generation;
+        log_fd_ = open(GetLogPath(generation).c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+        if (log_fd_ < 0)
+            return false;
+
+        uint8_t header[kLogHeaderSize]{};
+        memcpy(header, kLogMagic, sizeof(kLogMagic));
+        header[4] = kLogVersion;
+        header[5] = sizeof(Key);
+
+        if (!WriteAll(log_fd_, header, sizeof(header)) || fsync(log_fd_) != 0 || !SyncPath(directory_, O_DIRECTORY))
+        {
+            Close();
+            return false;
+        }
+
+        return true;
+    }
+
+    template <class Key, class Dispatch>
+    int64_t DurableArt<Key, Dispatch>::ReplayLog(const std::string& path)
+    {
+        FileReader reader(path);
+        if (!reader.IsOpen())
+            return 0;
+
+        uint8_t header[kLogHeaderSize];
+        if (!reader.Read(header, sizeof(header)))
+            return 0;
+
+        if (memcmp(header, kLogMagic, sizeof(kLogMagic)) != 0 || header[4] != kLogVersion || header[5] != sizeof(Key))
+            return -1;
+
+        const uint64_t file_size = std::filesystem::file_size(path);
+
+        int64_t size = kLogHeaderSize;
+        std::vector<Key> keys;
+
+        GroupHeader group;
+        while (reader.Read(group))
+        {
+            // a torn group might claim more keys than the log holds
+            if (group.count > (file_size - size - sizeof(group)) / sizeof(Key))
+                break;
+
+            keys.resize(group.count);
+            if (!reader.Read(keys.data(), keys.size() * sizeof(Key)) ||
+                Checksum(keys.data(), keys.size() * sizeof(Key)) != group.checksum)
+                break;
+
+            for (const Key key : keys)
+                tree_->Insert(key);
+
+            size += sizeof(GroupHeader) + keys.size() * sizeof(Key);
+        }
+
+        return size;
+    }
+
+    template <class Key, class Dispatch>
+    void DurableArt<Key, Dispatch>::Close()
+    {
+        FinishCheckpoint(true);
+
+        if (log_fd_ >= 0)
+        {
+            Commit(options_.sync_policy != SyncPolicy::kNone);
+            close(log_fd_);
+            log_fd_ = -1;
+        }
+
+        pending_.clear();
+    }
+
+    template <class Key, class Dispatch>
+    bool DurableArt<Key, Dispatch>::Insert(const Key value)
+    {
+        tree_->Insert(value);
+        pending_.push_back(value);
+
+        if (options_.sync_policy == SyncPolicy::kAlways || pending_.size() >= options_.batch_size)
+        {
+            if (!Commit(options_.sync_policy != SyncPolicy::kNone))
+                return false;
+
+            FinishCheckpoint(false);
+        }
+
+        // automatic checkpoints are delayed while a forked one is running
+        if (options_.checkpoint_interval != 0 && ++inserts_since_checkpoint_ >= options_.checkpoint_interval &&
+            checkpoint_pid_ < 0)
+            return Checkpoint();
+
+        return true;
+    }
+
+    template <class Key, class Dispatch>
+    bool DurableArt<Key, Dispatch>::Sync()
+    {
+        return Commit(true);
+    }
+
+    template <class Key, class Dispatch>
+    bool DurableArt<Key, Dispatch>::Commit(const bool sync)
+    {
+        if (!pending_.empty())
+        {
+            const size_t keys_size = pending_.size() * sizeof(Key);
+            const GroupHeader header{static_cast<uint32_t>(pending_.size()), Checksum(pending_.data(), keys_size)};
+
+            group_.resize(sizeof(header) + keys_size);
+            memcpy(group_.data(), &header, sizeof(header));
+            memcpy(group_.data() + sizeof(header), pending_.data(), keys_size);
+
+            pending_.clear();
+
+            if (!WriteAll(log_fd_, group_.data(), group_.size()))
+                return false;
+        }
+
+        return !sync || fdatasync(log_fd_) == 0;
+    }
+
+    template <class Key, class Dispatch>
+    bool DurableArt<Key, Dispatch>::Checkpoint()
+    {
+        FinishCheckpoint(true);
+
+        // the checkpoint contains all inserts logged before the new segment
+        const uint64_t generation = log_generation_ + 1;
+        if (!Commit(false) || !StartLogSegment(generation))
+            return false;
+
+        inserts_since_checkpoint_ = 0;
+
+        if (options_.checkpoint_mode == CheckpointMode::kBlocking)
+        {
+            if (!WriteCheckpoint())
+                return false;
+
+            RemoveLogSegments(generation);
+            return true;
+        }
+
+        int fds[2];
+        if (pipe(fds) != 0)
+            return false;
+
+        const pid_t pid = fork();
+        if (pid < 0)
+        {
+            close(fds[0]);
+            close(fds[1]);
+            return false;
+        }
+
+        if (pid == 0)
+        {
+            // the child sees the tree as of the fork while the parent continues inserting (copy-on-write)
+            close(fds[0]);
+
+            const uint8_t ok = WriteCheckpoint();
+            WriteAll(fds[1], &ok, sizeof(ok));
+
+            // skips destructors and exit handlers of the parent's state
+            _exit(ok ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+
+        close(fds[1]);
+
+        checkpoint_pid_ = pid;
+        checkpoint_pipe_ = fds[0];
+        checkpoint_generation_ = generation;
+        checkpoint_failed_ = false;
+
+        return true;
+    }
+
+    template <class Key, class Dispatch>
+    bool DurableArt<Key, Dispatch>::IsCheckpointRunning()
+    {
+        FinishCheckpoint(false);
+        return checkpoint_pid_ >= 0;
+    }
+
+    template <class Key, class Dispatch>
+    bool DurableArt<Key, Dispatch>::WaitForCheckpoint()
+    {
+        FinishCheckpoint(true);
+        return !checkpoint_failed_;
+    }
+
+    template <class Key, class Dispatch>
+    void DurableArt<Key, Dispatch>::FinishCheckpoint(const bool block)
+    {
+        if (checkpoint_pid_ < 0)
+            return;
+
+        if (!block)
+        {
+            pollfd fd{checkpoint_pipe_, POLLIN, 0};
+            if (poll(&fd, 1, 0) == 0)
+                return;
+        }
+
+        // the child writes its result once the checkpoint is durable (or closes the pipe without it if it crashed)
+        uint8_t ok = 0;
+        while (read(checkpoint_pipe_, &ok, sizeof(ok)) < 0 && errno == EINTR)
+        {
+        }
+
+        close(checkpoint_pipe_);
+        waitpid(checkpoint_pid_, nullptr, 0);
+
+        checkpoint_pid_ = -1;
+        checkpoint_pipe_ = -1;
+        checkpoint_failed_ = ok != 1;
+
+        if (ok)
+            RemoveLogSegments(checkpoint_generation_);
+    }
+
+    template <class Key, class Dispatch>
+    bool DurableArt<Key, Dispatch>::WriteCheckpoint() const
+    {
+        const std::filesystem::path root{directory_};
+        const std::string temp_path = root / kCheckpointTempFile;
+        const std::string checkpoint_path = root / kCheckpointFile;
+
+        // the previous checkpoint is only replaced once the new one is complete
+        return tree_->Save(temp_path) && SyncPath(temp_path, 0) &&
+               std::rename(temp_path.c_str(), checkpoint_path.c_str()) == 0 && SyncPath(directory_, O_DIRECTORY);
+    }
+
+    template <class Key, class Dispatch>
+    void DurableArt<Key, Dispatch>::RemoveLogSegments(const uint64_t generation) const
+    {
+        for (const uint64_t g : GetLogGenerations(directory_))
+        {
+            if (g < generation)
+                std::remove(GetLogPath(g).c_str());
+        }
+    }
+
+#define ART_INSTANTIATE_DURABLE(Key, Dispatch) template class DurableArt<Key, Dispatch>;
+
+    ART_FOR_EACH_CONFIG(ART_INSTANTIATE_DURABLE)
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "art.h"
+
+namespace art
+{
+    /**
+     * When committed log records are flushed to stable storage.
+     */
+    enum class SyncPolicy : uint8_t
+    {
+        // records are handed to the OS in groups but never flushed (survives a process crash, not a power loss)
+        kNone,
+        // every group of batch_size records is written and flushed together (group commit)
+        kBatch,
+        // every record is written and flushed before its insert returns
+        kAlways
+    };
+
+    /**
+     * How a checkpoint writes the tree.
+     */
+    enum class CheckpointMode : uint8_t
+    {
+        // inserts wait until the checkpoint is durable
+        kBlocking,
+        // a forked child process writes its copy-on-write image of the tree while inserts continue
+        kFork
+    };
+
+    struct DurabilityOptions
+    {
+        SyncPolicy sync_policy = SyncPolicy::kBatch;
+        // number of inserts committed together (kNone and kBatch)
+        uint32_t batch_size = 1024;
+        // number of inserts after which a checkpoint is taken automatically (0 only checkpoints on request)
+        uint64_t checkpoint_interval = 0;
+        CheckpointMode checkpoint_mode = CheckpointMode::kBlocking;
+    };
+
+    /**
+     * Art surviving crashes without a full rebuild. A directory holds the last checkpoint of the tree (written by
+     * Art::Save) and a write-ahead log of all inserts since, split into numbered segments.
+     *
+     * Inserts are visible immediately and durable once the group they are logged in is committed (see SyncPolicy).
+     * A checkpoint starts a new log segment, atomically replaces the previous checkpoint with the tree and then removes
+     * the segments before the new one. Opening the directory loads the checkpoint and replays every segment up to its
+     * last complete group. Inserting a key twice has no effect, so segments replayed over a checkpoint that already
+     * contains them (a crash before they were removed) are harmless.
+     *
+     * Only one checkpoint runs at a time. A forked checkpoint (CheckpointMode::kFork) reports its completion through a
+     * pipe which is polled whenever a log group is committed.
+     */
+    template <class Key = uint32_t, class Dispatch = SwitchDispatch>
+    class DurableArt
+    {
+    public:
+        using Tree = Art<Key, Dispatch>;
+
+        DurableArt() = default;
+
+        ~DurableArt();
+
+        DurableArt(const DurableArt&) = delete;
+
+        DurableArt& operator=(const DurableArt&) = delete;
+
+        /**
+         * Recovers the tree stored in directory (creating it if it doesn't exist) and closes the currently open one.
+         * Returns false (leaving the tree closed) if the directory couldn't be created or holds a checkpoint or log
+         * which isn't readable.
+         */
+        bool Open(const std::string& directory, const DurabilityOptions& options = {});
+
+        /**
+         * Commits the pending log records and closes the log.
+         */
+        void Close();
+
+        /**
+         * Inserts a key and logs it. Returns false if committing the log or an automatic checkpoint failed.
+         */
+        bool Insert(Key value);
+
+        bool IsOpen() const
+        {
+            return tree_ != nullptr;
+        }
+
+        bool Find(const Key value) const
+        {
+            return tree_->Find(value);
+        }
+
+        const Tree& GetTree() const
+        {
+            return *tree_;
+        }
+
+        /**
+         * Commits all pending log records and flushes them (independent of the sync policy).
+         */
+        bool Sync();
+
+        /**
+         * Writes a checkpoint of the tree (waiting for a running one first). A blocking checkpoint returns once it is
+         * durable, a forked one as soon as the child process started. Returns false if the checkpoint couldn't be
+         * written (or started).
+         */
+        bool Checkpoint();
+
+        /**
+         * Returns true while a forked checkpoint is running.
+         */
+        bool IsCheckpointRunning();
+
+        /**
+         * Waits for a running forked checkpoint. Returns false if it failed.
+         */
+        bool WaitForCheckpoint();
+
+    private:
+        /**
+         * Returns the path of the log segment with a generation.
+         */
+        std::string GetLogPath(uint64_t generation) const;
+
+        /**
+         * Seals the current log segment (flushing it) and starts the next one.
+         */
+        bool StartLogSegment(uint64_t generation);
+
+        /**
+         * Writes the tree to a temporary file and renames it to the checkpoint once it is durable.
+         */
+        bool WriteCheckpoint() const;
+
+        /**
+         * Removes the log segments before generation which are part of a durable checkpoint.
+         */
+        void RemoveLogSegments(uint64_t generation) const;
+
+        /**
+         * Collects the result of a forked checkpoint if it finished (or always if block is set).
+         */
+        void FinishCheckpoint(bool block);
+
+        /**
+         * Reads the log and inserts all keys of its complete groups. Returns the size of the valid prefix of the log
+         * (0 if there is none) or -1 if the log belongs to a different key type.
+         */
+        int64_t ReplayLog(const std::string& path);
+
+        /**
+         * Writes the pending log records as a single group and flushes it if sync is set.
+         */
+        bool Commit(bool sync);
+
+        std::unique_ptr<Tree> tree_;
+        DurabilityOptions options_;
+        std::string directory_;
+
+        int log_fd_ = -1;
+        uint64_t log_generation_ = 0;
+        std::vector<Key> pending_;
+        std::vector<std::byte> group_;
+
+        uint64_t inserts_since_checkpoint_ = 0;
+
+        // forked checkpoint covering the log segments before checkpoint_generation_
+        int checkpoint_pid_ = -1;
+        int checkpoint_pipe_ = -1;
+        uint64_t checkpoint_generation_ = 0;
+        bool checkpoint_failed_ = false;
+    };
+}
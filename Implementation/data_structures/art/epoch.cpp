@@ -0,0 +1,133 @@
+#include "epoch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace art
+{
+    namespace
+    {
+        // maximum number of threads holding a reader slot at the same time
+        constexpr uint32_t kMaxReaders = 1024;
+
+        // number of retired nodes after which the writer tries to reclaim them
+        constexpr size_t kReclaimThreshold = 64;
+
+        // epoch 0 marks an unpinned reader slot
+        constexpr uint64_t kUnpinned = 0;
+
+        struct alignas(64) ReaderSlot
+        {
+            std::atomic<uint64_t> epoch{kUnpinned};
+            std::atomic<bool> used{false};
+        };
+
+        std::atomic<uint64_t> global_epoch{1};
+        ReaderSlot reader_slots[kMaxReaders];
+        // upper bound of the slot indices ever handed out (limits the writer's scan)
+        std::atomic<uint32_t> slot_count{0};
+
+        /**
+         * Reader slot owned by the calling thread for its whole lifetime.
+         */
+        struct ThreadSlot
+        {
+            uint32_t index;
+
+            ThreadSlot()
+            {
+                while (true)
+                {
+                    for (index = 0; index < kMaxReaders; ++index)
+                    {
+                        bool expected = false;
+                        if (reader_slots[index].used.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                        {
+                            uint32_t count = slot_count.load(std::memory_order_relaxed);
+                            while (count <= index && !slot_count.compare_exchange_weak(count, index + 1, std::memory_order_relaxed));
+                            return;
+                        }
+                    }
+
+                    // wait for another thread to exit
+                    std::this_thread::yield();
+                }
+            }
+
+            ~ThreadSlot()
+            {
+                reader_slots[index].used.store(false, std::memory_order_release);
+            }
+        };
+
+        uint32_t GetThreadSlot()
+        {
+            thread_local const ThreadSlot slot;
+            return slot.index;
+        }
+    }
+
+    EpochGuard::EpochGuard() : slot_{GetThreadSlot()}
+    {
+        outermost_ = reader_slots[slot_].epoch.load(std::memory_order_relaxed) == kUnpinned;
+        Refresh();
+    }
+
+    EpochGuard::~EpochGuard()
+    {
+        if (outermost_)
+            reader_slots[slot_].epoch.store(kUnpinned, std::memory_order_release);
+    }
+
+    void EpochGuard::Refresh()
+    {
+        if (!outermost_)
+            return;
+
+        reader_slots[slot_].epoch.store(global_epoch.load(std::memory_order_acquire), std::memory_order_relaxed);
+
+        // the pinned epoch has to be visible to the writer before we read any node pointer
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    RetireList::~RetireList()
+    {
+        for (const auto& [epoch, node, deleter] : nodes_)
+            deleter(node);
+    }
+
+    void RetireList::Retire(void* node, void (*deleter)(void*))
+    {
+        nodes_.push_back({global_epoch.load(std::memory_order_relaxed), node, deleter});
+
+        if (nodes_.size() >= kReclaimThreshold)
+            Reclaim();
+    }
+
+    void RetireList::Reclaim()
+    {
+        // readers pinning an epoch after this increment see all nodes unlinked before it
+        global_epoch.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        uint64_t oldest = UINT64_MAX;
+        const uint32_t count = slot_count.load(std::memory_order_acquire);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const uint64_t epoch = reader_slots[i].epoch.load(std::memory_order_acquire);
+            if (epoch != kUnpinned)
+                oldest = std::min(oldest, epoch);
+        }
+
+        // readers that pinned an epoch after a node was retired can't reach it anymore
+        std::erase_if(nodes_, [oldest](const auto& retired)
+        {
+            if (retired.epoch >= oldest)
+                return false;
+
+            retired.deleter(retired.node);
+            return true;
+        });
+    }
+}
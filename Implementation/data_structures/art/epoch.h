@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace art
+{
+    /**
+     * Epoch based reclamation for nodes replaced while readers might still traverse them.
+     *
+     * Readers pin the current global epoch for a whole reader session (EpochGuard), i.e. across many operations, so
+     * the operations themselves don't touch any shared state. The writer tags every replaced node with the epoch it
+     * was retired in (RetireList) and frees it once all pinned readers have advanced past that epoch, i.e. once no
+     * reader can still hold a pointer to it. Long-running sessions call Refresh between operations (quiescent
+     * states) so that retired nodes can still be reclaimed.
+     */
+    class EpochGuard
+    {
+    public:
+        /**
+         * Pins the current epoch for the calling thread (nested guards keep the outermost epoch).
+         */
+        EpochGuard();
+
+        ~EpochGuard();
+
+        EpochGuard(const EpochGuard&) = delete;
+
+        EpochGuard& operator=(const EpochGuard&) = delete;
+
+        /**
+         * Re-pins the current epoch. The calling thread must not hold any node pointer obtained under this guard.
+         * Does nothing for nested guards.
+         */
+        void Refresh();
+
+    private:
+        uint32_t slot_;
+        bool outermost_;
+    };
+
+    /**
+     * Nodes retired by a single writer.
+     */
+    class RetireList
+    {
+    public:
+        RetireList() = default;
+
+        /**
+         * Frees all remaining nodes. Readers must not access them anymore.
+         */
+        ~RetireList();
+
+        RetireList(const RetireList&) = delete;
+
+        RetireList& operator=(const RetireList&) = delete;
+
+        /**
+         * Retires a node which has already been unlinked from the tree (but not its children).
+         * Once no reader can access it anymore it is freed by calling deleter(node).
+         */
+        void Retire(void* node, void (*deleter)(void*));
+
+    private:
+        /**
+         * Advances the global epoch and frees all nodes retired before the oldest epoch pinned by a reader.
+         */
+        void Reclaim();
+
+    private:
+        struct RetiredNode
+        {
+            uint64_t epoch;
+            void* node;
+            void (*deleter)(void*);
+        };
+
+        std::vector<RetiredNode> nodes_;
+    };
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace art
+{
+    // large enough that the many small records of a tree don't each cost a call into the C library
+    constexpr size_t kFileBufferSize = 1 << 20;
+
+    /**
+     * Sequentially writes a file through a large buffer.
+     */
+    class FileWriter
+    {
+    public:
+        explicit FileWriter(const std::string& path) : file_{std::fopen(path.c_str(), "wb")},
+                                                        buffer_(kFileBufferSize)
+        {
+        }
+
+        ~FileWriter()
+        {
+            if (file_ != nullptr)
+                std::fclose(file_);
+        }
+
+        bool IsOpen() const
+        {
+            return file_ != nullptr;
+        }
+
+        template <class T>
+        void Write(const T& value)
+        {
+            Write(&value, sizeof(T));
+        }
+
+        void Write(const void* data, size_t size)
+        {
+            auto bytes = static_cast<const char*>(data);
+
+            while (size != 0)
+            {
+                if (used_ == kFileBufferSize)
+                    Flush();
+
+                const size_t n = std::min(size, kFileBufferSize - used_);
+                memcpy(buffer_.data() + used_, bytes, n);
+                used_ += n;
+                bytes += n;
+                size -= n;
+            }
+        }
+
+        /**
+         * Returns the number of bytes written so far (the offset of the next write).
+         */
+        uint64_t Position() const
+        {
+            return flushed_ + used_;
+        }
+
+        /**
+         * Overwrites already written bytes (e.g. a header completed after the rest of the file).
+         */
+        void WriteAt(const uint64_t position, const void* data, const size_t size)
+        {
+            Flush();
+            ok_ &= std::fseek(file_, static_cast<long>(position), SEEK_SET) == 0;
+            ok_ &= std::fwrite(data, 1, size, file_) == size;
+            ok_ &= std::fseek(file_, 0, SEEK_END) == 0;
+        }
+
+        /**
+         * Writes the remaining buffer and closes the file. Returns false if any write failed.
+         */
+        bool Close()
+        {
+            Flush();
+            ok_ &= std::fclose(file_) == 0;
+            file_ = nullptr;
+            return ok_;
+        }
+
+    private:
+        void Flush()
+        {
+            ok_ &= std::fwrite(buffer_.data(), 1, used_, file_) == used_;
+            flushed_ += used_;
+            used_ = 0;
+        }
+
+        std::FILE* file_;
+        std::vector<char> buffer_;
+        size_t used_ = 0;
+        uint64_t flushed_ = 0;
+        bool ok_ = true;
+    };
+
+    /**
+     * Reads a file through a large buffer (see FileWriter).
+     */
+    class FileReader
+    {
+    public:
+        explicit FileReader(const std::string& path) : file_{std::fopen(path.c_str(), "rb")},
+                                                        buffer_(kFileBufferSize)
+        {
+        }
+
+        ~FileReader()
+        {
+            if (file_ != nullptr)
+                std::fclose(file_);
+        }
+
+        bool IsOpen() const
+        {
+            return file_ != nullptr;
+        }
+
+        template <class T>
+        bool Read(T& value)
+        {
+            return Read(&value, sizeof(T));
+        }
+
+        /**
+         * Returns false if the file ends before size bytes were read.
+         */
+        bool Read(void* data, size_t size)
+        {
+            auto bytes = static_cast<char*>(data);
+
+            while (size != 0)
+            {
+                if (position_ == available_ && !Fill())
+                    return false;
+
+                const size_t n = std::min(size, available_ - position_);
+                memcpy(bytes, buffer_.data() + position_, n);
+                position_ += n;
+                bytes += n;
+                size -= n;
+            }
+
+            return true;
+        }
+
+        bool AtEnd()
+        {
+            return position_ == available_ && !Fill();
+        }
+
+        /**
+         * Continues reading at an absolute position of the file (discarding the buffer).
+         */
+        bool Seek(const uint64_t position)
+        {
+            position_ = available_ = 0;
+            return std::fseek(file_, static_cast<long>(position), SEEK_SET) == 0;
+        }
+
+    private:
+        bool Fill()
+        {
+            available_ = std::fread(buffer_.data(), 1, kFileBufferSize, file_);
+            position_ = 0;
+            return available_ != 0;
+        }
+
+        std::FILE* file_;
+        std::vector<char> buffer_;
+        size_t position_ = 0;
+        size_t available_ = 0;
+    };
+}
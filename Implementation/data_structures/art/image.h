@@ -0,0 +1,516 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "node/node.h"
+#include "node/simd.h"
+
+/**
+ * Node layout of trees stored in files or shared memory (see MappedArt, PagedArt, PersistentArt and SharedArt), native
+ * byte order:
+ *
+ *  nodes:      ImageNode4/16/48/256 at 8 byte aligned offsets, every child before its parent if written bottom-up
+ *
+ * Child references are 64 bit:
+ *  - 0 if there is no child
+ *  - offset of the child node | (node type + 1) in the low 3 bits (like TaggedDispatch)
+ *  - key << KeyTraits::kLazyExpansionShift | 7 for a full key (like combined value/pointer slots)
+ *
+ * The last level only stores full keys. Offsets are relative to the base of the file (or page) holding the nodes.
+ */
+namespace art::image
+{
+    struct ImageNode4
+    {
+        uint8_t type;
+        uint8_t child_count;
+        uint8_t keys[4];
+        // seqlock of in-place inserts in shared trees (see SharedArt), 0 otherwise
+        uint16_t version;
+        uint64_t children[4];
+    };
+
+    struct ImageNode16
+    {
+        uint8_t type;
+        uint8_t child_count;
+        uint8_t keys[16];
+        // seqlock of in-place inserts in shared trees (see SharedArt), 0 otherwise
+        uint16_t version;
+        uint64_t children[16];
+    };
+
+    struct ImageNode48
+    {
+        static constexpr uint8_t kFreeMarker = 0xFF;
+
+        uint8_t type;
+        uint8_t child_count;
+        uint8_t keys[256];
+        uint64_t children[48];
+    };
+
+    struct ImageNode256
+    {
+        uint8_t type;
+        // child count modulo 256
+        uint8_t child_count;
+        uint64_t children[256];
+    };
+
+    constexpr size_t kNodeSizes[]{sizeof(ImageNode4), sizeof(ImageNode16), sizeof(ImageNode48), sizeof(ImageNode256)};
+
+    constexpr uint64_t kTagMask = 0x7;
+
+    inline bool IsKey(const uint64_t ref)
+    {
+        return (ref & kTagMask) == kTagMask;
+    }
+
+    inline NodeType GetType(const uint64_t ref)
+    {
+        return static_cast<NodeType>((ref & kTagMask) - 1);
+    }
+
+    template <class Key>
+    uint64_t EncodeKey(const Key key)
+    {
+        return static_cast<uint64_t>(key) << KeyTraits<Key>::kLazyExpansionShift | kTagMask;
+    }
+
+    /**
+     * Returns the full key stored at ref. path holds the partial keys of the nodes above ref which restore the
+     * partial key of the root that 64 bit keys don't store.
+     */
+    template <class Key>
+    Key DecodeKey(const uint64_t ref, const Key path)
+    {
+        const auto key = static_cast<Key>(ref >> KeyTraits<Key>::kLazyExpansionShift);
+
+        if constexpr (KeyTraits<Key>::kLazyExpansionShift + sizeof(Key) * 8 > 64)
+            return key | (path & static_cast<Key>(~uint64_t{0} << (64 - KeyTraits<Key>::kLazyExpansionShift)));
+        else
+            return key;
+    }
+
+    /**
+     * Writes the node storing keys (all sharing the partial keys above offset) bottom-up and returns the reference
+     * to it.
+     */
+    template <class Key, class Writer>
+    uint64_t WriteNode(Writer& writer, const std::span<const Key> keys, const int offset)
+    {
+        uint8_t partial_keys[256];
+        uint64_t children[256];
+        uint16_t child_count = 0;
+
+        for (size_t begin = 0; begin < keys.size();)
+        {
+            const uint8_t partial_key = keys[begin] >> offset & 0xFF;
+
+            size_t end = begin + 1;
+            while (end < keys.size() && (keys[end] >> offset & 0xFF) == partial_key)
+                ++end;
+
+            // a single key is stored at the reference instead of a subtree (always the case at the last level)
+            const auto subtree = keys.subspan(begin, end - begin);
+            children[child_count] = subtree.size() == 1
+                                        ? EncodeKey(subtree[0])
+                                        : WriteNode(writer, subtree, offset - 8);
+            partial_keys[child_count++] = partial_key;
+
+            begin = end;
+        }
+
+        const uint64_t position = writer.Position();
+
+        // same node sizes as Node::Create
+        NodeType type;
+        if (child_count <= 4)
+        {
+            ImageNode4 node{};
+            node.type = type = kNode4;
+            node.child_count = child_count;
+            memcpy(node.keys, partial_keys, child_count);
+            memcpy(node.children, children, child_count * sizeof(uint64_t));
+            writer.Write(node);
+        }
+        else if (child_count <= 16)
+        {
+            ImageNode16 node{};
+            node.type = type = kNode16;
+            node.child_count = child_count;
+            memcpy(node.keys, partial_keys, child_count);
+            memcpy(node.children, children, child_count * sizeof(uint64_t));
+            writer.Write(node);
+        }
+        else if (child_count <= 48)
+        {
+            ImageNode48 node{};
+            node.type = type = kNode48;
+            node.child_count = child_count;
+            memset(node.keys, ImageNode48::kFreeMarker, sizeof(node.keys));
+            for (uint8_t i = 0; i < child_count; ++i)
+                node.keys[partial_keys[i]] = i;
+            memcpy(node.children, children, child_count * sizeof(uint64_t));
+            writer.Write(node);
+        }
+        else
+        {
+            ImageNode256 node{};
+            node.type = type = kNode256;
+            node.child_count = child_count & 0xFF;
+            for (uint16_t i = 0; i < child_count; ++i)
+                node.children[partial_keys[i]] = children[i];
+            writer.Write(node);
+        }
+
+        return position | (type + 1);
+    }
+
+    /**
+     * Returns the reference to the child of the node at ref with partial_key (or 0 if there is none).
+     */
+    inline uint64_t FindChild(const std::byte* base, const uint64_t ref, const uint8_t partial_key)
+    {
+        const std::byte* node = base + (ref & ~kTagMask);
+
+        switch ((ref & kTagMask) - 1)
+        {
+            case kNode4:
+                {
+                    const auto n = reinterpret_cast<const ImageNode4*>(node);
+                    const uint32_t mask = simd::Node4Equal(n->keys, partial_key, n->child_count);
+                    return mask ? n->children[__ctz(mask) >> 3] : 0;
+                }
+            case kNode16:
+                {
+                    const auto n = reinterpret_cast<const ImageNode16*>(node);
+                    const uint32_t mask = simd::node16_kernels.equal(n->keys, partial_key, n->child_count);
+                    return mask ? n->children[__ctz(mask)] : 0;
+                }
+            case kNode48:
+                {
+                    const auto n = reinterpret_cast<const ImageNode48*>(node);
+                    const uint8_t index = n->keys[partial_key];
+                    return index != ImageNode48::kFreeMarker ? n->children[index] : 0;
+                }
+            case kNode256:
+                {
+                    const auto n = reinterpret_cast<const ImageNode256*>(node);
+                    return n->children[partial_key];
+                }
+        }
+
+        __unreachable();
+    }
+
+    /**
+     * Writes an empty node of type to node.
+     */
+    inline void InitializeNode(std::byte* node, const NodeType type)
+    {
+        memset(node, 0, kNodeSizes[type]);
+        reinterpret_cast<ImageNode4*>(node)->type = type;
+        if (type == kNode48)
+            memset(reinterpret_cast<ImageNode48*>(node)->keys, ImageNode48::kFreeMarker, sizeof(ImageNode48::keys));
+    }
+
+    /**
+     * Returns the slot of the existing child with partial_key of the node at ref.
+     */
+    inline uint64_t& GetChildSlot(std::byte* base, const uint64_t ref, const uint8_t partial_key)
+    {
+        std::byte* node = base + (ref & ~kTagMask);
+
+        switch (GetType(ref))
+        {
+            case kNode4:
+                {
+                    const auto n = reinterpret_cast<ImageNode4*>(node);
+                    return n->children[__ctz(simd::Node4Equal(n->keys, partial_key, n->child_count)) >> 3];
+                }
+            case kNode16:
+                {
+                    const auto n = reinterpret_cast<ImageNode16*>(node);
+                    return n->children[__ctz(simd::node16_kernels.equal(n->keys, partial_key, n->child_count))];
+                }
+            case kNode48:
+                {
+                    const auto n = reinterpret_cast<ImageNode48*>(node);
+                    return n->children[n->keys[partial_key]];
+                }
+            case kNode256:
+                {
+                    const auto n = reinterpret_cast<ImageNode256*>(node);
+                    return n->children[partial_key];
+                }
+        }
+
+        __unreachable();
+    }
+
+    /**
+     * Returns true if a child can only be added to the node at ref by copying it into the next larger node type.
+     */
+    inline bool IsFull(const std::byte* base, const uint64_t ref)
+    {
+        // child_count is the first byte after the type in all node types
+        const uint8_t child_count = reinterpret_cast<const ImageNode4*>(base + (ref & ~kTagMask))->child_count;
+
+        switch (GetType(ref))
+        {
+            case kNode4:
+                return child_count == 4;
+            case kNode16:
+                return child_count == 16;
+            case kNode48:
+                return child_count == 48;
+            case kNode256:
+                return false;
+        }
+
+        __unreachable();
+    }
+
+    /**
+     * Adds a child with a new partial key to the node at ref which isn't full.
+     */
+    inline void InsertChild(std::byte* base, const uint64_t ref, const uint8_t partial_key, const uint64_t child)
+    {
+        std::byte* node = base + (ref & ~kTagMask);
+
+        switch (GetType(ref))
+        {
+            case kNode4:
+                {
+                    const auto n = reinterpret_cast<ImageNode4*>(node);
+                    const uint32_t mask = simd::Node4Greater(n->keys, partial_key, n->child_count);
+                    const uint8_t position = mask ? __ctz(mask) >> 3 : n->child_count;
+
+                    memmove(n->keys + position + 1, n->keys + position, n->child_count - position);
+                    memmove(n->children + position + 1, n->children + position,
+                            (n->child_count - position) * sizeof(uint64_t));
+                    n->keys[position] = partial_key;
+                    n->children[position] = child;
+                    ++n->child_count;
+                    return;
+                }
+            case kNode16:
+                {
+                    const auto n = reinterpret_cast<ImageNode16*>(node);
+                    const uint32_t mask = simd::node16_kernels.greater(n->keys, partial_key, n->child_count);
+                    const uint8_t position = mask ? __ctz(mask) : n->child_count;
+
+                    memmove(n->keys + position + 1, n->keys + position, n->child_count - position);
+                    memmove(n->children + position + 1, n->children + position,
+                            (n->child_count - position) * sizeof(uint64_t));
+                    n->keys[position] = partial_key;
+                    n->children[position] = child;
+                    ++n->child_count;
+                    return;
+                }
+            case kNode48:
+                {
+                    // children are never removed so the used slots are always the first child_count ones
+                    const auto n = reinterpret_cast<ImageNode48*>(node);
+                    n->keys[partial_key] = n->child_count;
+                    n->children[n->child_count++] = child;
+                    return;
+                }
+            case kNode256:
+                {
+                    const auto n = reinterpret_cast<ImageNode256*>(node);
+                    n->children[partial_key] = child;
+                    ++n->child_count;
+                    return;
+                }
+        }
+
+        __unreachable();
+    }
+
+    /**
+     * Returns a node storing two different keys below offset (with a chain of Node4 down to the level where their
+     * partial keys differ) or 0 if allocate failed. allocate(type) returns the offset of a new empty node (or 0) and
+     * may move the mapping at base, so children are allocated before their parents.
+     */
+    template <class Key, class Allocate>
+    uint64_t CreatePair(std::byte* const& base, const Key first, const Key second, const int offset,
+                        Allocate&& allocate)
+    {
+        const uint8_t first_partial_key = first >> offset & 0xFF;
+        const uint8_t second_partial_key = second >> offset & 0xFF;
+
+        uint64_t child = 0;
+        if (first_partial_key == second_partial_key)
+        {
+            child = CreatePair(base, first, second, offset - 8, allocate);
+            if (child == 0)
+                return 0;
+        }
+
+        const uint64_t node_offset = allocate(kNode4);
+        if (node_offset == 0)
+            return 0;
+
+        const uint64_t node = node_offset | (kNode4 + 1);
+
+        if (child != 0)
+        {
+            InsertChild(base, node, first_partial_key, child);
+        }
+        else
+        {
+            InsertChild(base, node, first_partial_key, EncodeKey(first));
+            InsertChild(base, node, second_partial_key, EncodeKey(second));
+        }
+
+        return node;
+    }
+
+    /**
+     * Grows the file behind the shared mapping at base from capacity to new_capacity bytes. The mapping may move since
+     * nodes are addressed by offsets.
+     */
+    inline bool GrowMapping(const int fd, std::byte*& base, size_t& capacity, const size_t new_capacity)
+    {
+        if (ftruncate(fd, static_cast<off_t>(new_capacity)) != 0)
+            return false;
+
+        void* grown = mremap(base, capacity, new_capacity, MREMAP_MAYMOVE);
+        if (grown == MAP_FAILED)
+            return false;
+
+        base = static_cast<std::byte*>(grown);
+        capacity = new_capacity;
+
+        return true;
+    }
+
+    /**
+     * Calls f(partial_key, child) for every child of the node at ref with a partial key in [begin, end] in
+     * ascending order until f returns false. Returns false if f did.
+     */
+    template <class F>
+    bool ForEachChild(const std::byte* base, const uint64_t ref, const uint8_t begin, const uint8_t end, F&& f)
+    {
+        const std::byte* node = base + (ref & ~kTagMask);
+
+        switch ((ref & kTagMask) - 1)
+        {
+            case kNode4:
+                {
+                    const auto n = reinterpret_cast<const ImageNode4*>(node);
+                    const uint32_t mask = simd::Node4GreaterEqual(n->keys, begin, n->child_count);
+                    for (uint8_t i = mask ? __ctz(mask) >> 3 : 4; i < n->child_count && n->keys[i] <= end; ++i)
+                        if (!f(n->keys[i], n->children[i]))
+                            return false;
+                    return true;
+                }
+            case kNode16:
+                {
+                    const auto n = reinterpret_cast<const ImageNode16*>(node);
+                    const uint32_t mask = simd::node16_kernels.greater_equal(n->keys, begin, n->child_count);
+                    for (uint8_t i = mask ? __ctz(mask) : 16; i < n->child_count && n->keys[i] <= end; ++i)
+                        if (!f(n->keys[i], n->children[i]))
+                            return false;
+                    return true;
+                }
+            case kNode48:
+                {
+                    const auto n = reinterpret_cast<const ImageNode48*>(node);
+                    uint64_t bitmap[4];
+                    simd::scan_kernels.not_equal(n->keys, ImageNode48::kFreeMarker, bitmap);
+                    return simd::ForEachChildUntil(bitmap, begin, end + 1, [&](const uint8_t i)
+                    {
+                        return f(i, n->children[n->keys[i]]);
+                    });
+                }
+            case kNode256:
+                {
+                    const auto n = reinterpret_cast<const ImageNode256*>(node);
+                    uint64_t bitmap[4];
+                    simd::scan_kernels.non_null(reinterpret_cast<const void* const*>(n->children), bitmap);
+                    return simd::ForEachChildUntil(bitmap, begin, end + 1, [&](const uint8_t i)
+                    {
+                        return f(i, n->children[i]);
+                    });
+                }
+        }
+
+        __unreachable();
+    }
+
+    /**
+     * Calls f(key) for every key in [from, to] below the node at ref in ascending order until f returns false.
+     * Only the children on the path of from (lower) and to (upper) are bounded by them, all others are completely
+     * inside the range. Returns false if f did.
+     */
+    template <class Key, class F>
+    bool Scan(const std::byte* base, const uint64_t ref, const Key from, const Key to, const int offset,
+              const Key path, const bool lower, const bool upper, F&& f)
+    {
+        const uint8_t begin = lower ? from >> offset & 0xFF : 0x00;
+        const uint8_t end = upper ? to >> offset & 0xFF : 0xFF;
+
+        return ForEachChild(base, ref, begin, end, [&](const uint8_t partial_key, const uint64_t child)
+        {
+            const Key child_path = path | static_cast<Key>(static_cast<Key>(partial_key) << offset);
+
+            if (IsKey(child))
+            {
+                const Key key = DecodeKey(child, child_path);
+                return key < from || key > to || f(key);
+            }
+
+            return Scan(base, child, from, to, offset - 8, child_path, lower && partial_key == begin,
+                        upper && partial_key == end, f);
+        });
+    }
+
+    /**
+     * Returns true if value is stored below the root node at root.
+     */
+    template <class Key>
+    bool Find(const std::byte* base, const uint64_t root, const Key value)
+    {
+        uint64_t ref = root;
+
+        // the last level only stores full keys so every lookup ends at a key or a missing child
+        for (int offset = KeyTraits<Key>::kRootOffset;; offset -= 8)
+        {
+            ref = FindChild(base, ref, value >> offset & 0xFF);
+
+            if (ref == 0)
+                return false;
+
+            if (IsKey(ref))
+                return DecodeKey(ref, value) == value;
+        }
+    }
+
+    /**
+     * Returns all keys in [from, to] below the root node at root in ascending order.
+     */
+    template <class Key>
+    std::vector<Key> FindRange(const std::byte* base, const uint64_t root, const Key from, const Key to)
+    {
+        std::vector<Key> res;
+        if (from > to)
+            return res;
+
+        Scan(base, root, from, to, KeyTraits<Key>::kRootOffset, Key{0}, true, true, [&](const Key key)
+        {
+            res.push_back(key);
+            return true;
+        });
+
+        return res;
+    }
+}
@@ -0,0 +1,327 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "file_io.h"
+
+/**
+ * Compact format for shipping the keys of a tree (see Art::Export and Art::Import), native byte order:
+ *
+ *  header:     KeyStreamHeader
+ *  chunks:     ChunkHeader | varints (LEB128) of the differences between consecutive keys (key count - 1 of them)
+ *  index:      IndexEntry of every chunk
+ *
+ * Keys are strictly ascending and every chunk holds up to kKeyStreamChunkSize of them. The first key of a chunk is
+ * stored in full in its header so chunks decode independently, and the index of the chunks' first keys allows
+ * seeking without reading the chunks before.
+ */
+namespace art
+{
+    constexpr uint32_t kKeyStreamChunkSize = 4096;
+
+    namespace key_stream
+    {
+        constexpr char kMagic[4]{'A', 'R', 'T', 'K'};
+        constexpr uint8_t kFormatVersion = 1;
+
+        struct KeyStreamHeader
+        {
+            char magic[4];
+            uint8_t version;
+            uint8_t key_size;
+            uint64_t key_count;
+            uint64_t chunk_count;
+            uint64_t index_offset;
+        };
+
+        struct ChunkHeader
+        {
+            uint64_t first_key;
+            uint32_t key_count;
+            // bytes of varints following the header
+            uint32_t size;
+        };
+
+        struct IndexEntry
+        {
+            uint64_t first_key;
+            uint64_t offset;
+        };
+
+        /**
+         * Returns the maximum number of bytes of the varints of a chunk of keys of type Key.
+         */
+        template <class Key>
+        constexpr size_t MaxChunkSize()
+        {
+            return (kKeyStreamChunkSize - 1) * ((sizeof(Key) * 8 + 6) / 7);
+        }
+    }
+
+    /**
+     * Writes strictly ascending keys to a file in the format above, buffering a single chunk.
+     */
+    template <class Key>
+    class KeyStreamWriter
+    {
+    public:
+        explicit KeyStreamWriter(const std::string& path) : writer_(path)
+        {
+            buffer_.reserve(key_stream::MaxChunkSize<Key>());
+
+            // the header is completed once all chunks are written
+            if (writer_.IsOpen())
+                writer_.Write(key_stream::KeyStreamHeader{});
+        }
+
+        bool IsOpen() const
+        {
+            return writer_.IsOpen();
+        }
+
+        /**
+         * Appends a key greater than all keys written before.
+         */
+        void Write(const Key key)
+        {
+            if (chunk_key_count_ == 0)
+            {
+                first_key_ = key;
+            }
+            else
+            {
+                for (uint64_t delta = key - previous_; ; delta >>= 7)
+                {
+                    if (delta < 0x80)
+                    {
+                        buffer_.push_back(static_cast<uint8_t>(delta));
+                        break;
+                    }
+
+                    buffer_.push_back(static_cast<uint8_t>(delta | 0x80));
+                }
+            }
+
+            previous_ = key;
+            ++key_count_;
+
+            if (++chunk_key_count_ == kKeyStreamChunkSize)
+                FlushChunk();
+        }
+
+        /**
+         * Writes the last chunk, the index and the header and closes the file. Returns false if any write failed.
+         */
+        bool Close()
+        {
+            FlushChunk();
+
+            key_stream::KeyStreamHeader header{};
+            memcpy(header.magic, key_stream::kMagic, sizeof(key_stream::kMagic));
+            header.version = key_stream::kFormatVersion;
+            header.key_size = sizeof(Key);
+            header.key_count = key_count_;
+            header.chunk_count = index_.size();
+            header.index_offset = writer_.Position();
+
+            writer_.Write(index_.data(), index_.size() * sizeof(key_stream::IndexEntry));
+            writer_.WriteAt(0, &header, sizeof(header));
+
+            return writer_.Close();
+        }
+
+    private:
+        void FlushChunk()
+        {
+            if (chunk_key_count_ == 0)
+                return;
+
+            index_.push_back({first_key_, writer_.Position()});
+
+            const auto size = static_cast<uint32_t>(buffer_.size());
+            writer_.Write(key_stream::ChunkHeader{first_key_, chunk_key_count_, size});
+            writer_.Write(buffer_.data(), buffer_.size());
+
+            buffer_.clear();
+            chunk_key_count_ = 0;
+        }
+
+        FileWriter writer_;
+        // varints of the current chunk
+        std::vector<uint8_t> buffer_;
+        // first key of every chunk written (a few bytes per chunk of keys)
+        std::vector<key_stream::IndexEntry> index_;
+        Key first_key_{};
+        Key previous_{};
+        uint32_t chunk_key_count_ = 0;
+        uint64_t key_count_ = 0;
+    };
+
+    /**
+     * Reads the keys written by KeyStreamWriter in ascending order, decoding a single chunk at a time.
+     */
+    template <class Key>
+    class KeyStreamReader
+    {
+    public:
+        explicit KeyStreamReader(const std::string& path) : reader_(path), buffer_(key_stream::MaxChunkSize<Key>())
+        {
+            open_ = reader_.IsOpen() && ReadIndex();
+        }
+
+        /**
+         * Returns false if the file couldn't be read or wasn't written for keys of type Key.
+         */
+        bool IsOpen() const
+        {
+            return open_;
+        }
+
+        uint64_t Size() const
+        {
+            return header_.key_count;
+        }
+
+        /**
+         * Continues reading at the chunk that holds the smallest key greater or equal to key (Read still returns the
+         * keys of that chunk before it).
+         */
+        bool Seek(const Key key)
+        {
+            // the last chunk starting at or before key
+            const auto it = std::upper_bound(index_.begin(), index_.end(), static_cast<uint64_t>(key),
+                                             [](const uint64_t k, const key_stream::IndexEntry& entry)
+                                             {
+                                                 return k < entry.first_key;
+                                             });
+            const size_t chunk = it == index_.begin() ? 0 : it - index_.begin() - 1;
+
+            next_chunk_ = chunk;
+            remaining_ = 0;
+            started_ = false;
+
+            return chunk == index_.size() || reader_.Seek(index_[chunk].offset);
+        }
+
+        /**
+         * Decodes up to capacity of the next keys into out and returns their number (0 once all keys were read or
+         * the file is malformed, see Failed).
+         */
+        size_t Read(Key* out, const size_t capacity)
+        {
+            size_t count = 0;
+
+            while (count < capacity && !failed_)
+            {
+                if (remaining_ == 0 && !ReadChunk())
+                    break;
+
+                out[count++] = remaining_ == chunk_key_count_ ? first_key_ : DecodeNext();
+                previous_ = out[count - 1];
+
+                // all varints of a chunk belong to its keys
+                if (--remaining_ == 0 && position_ != size_)
+                    failed_ = true;
+            }
+
+            return failed_ ? 0 : count;
+        }
+
+        /**
+         * Returns true if the file ended early or its keys weren't strictly ascending.
+         */
+        bool Failed() const
+        {
+            return failed_;
+        }
+
+    private:
+        bool ReadIndex()
+        {
+            if (!reader_.Read(header_) || memcmp(header_.magic, key_stream::kMagic, sizeof(key_stream::kMagic)) != 0 ||
+                header_.version != key_stream::kFormatVersion || header_.key_size != sizeof(Key) ||
+                header_.chunk_count != (header_.key_count + kKeyStreamChunkSize - 1) / kKeyStreamChunkSize)
+                return false;
+
+            index_.resize(header_.chunk_count);
+            return reader_.Seek(header_.index_offset) &&
+                reader_.Read(index_.data(), index_.size() * sizeof(key_stream::IndexEntry)) &&
+                reader_.Seek(sizeof(key_stream::KeyStreamHeader));
+        }
+
+        bool ReadChunk()
+        {
+            if (next_chunk_ == index_.size())
+                return false;
+
+            // all chunks but the last one are full
+            const uint64_t key_count = std::min<uint64_t>(kKeyStreamChunkSize,
+                                                          header_.key_count - next_chunk_ * kKeyStreamChunkSize);
+
+            key_stream::ChunkHeader chunk{};
+            if (!reader_.Read(chunk) || chunk.key_count != key_count || chunk.size > buffer_.size() ||
+                chunk.first_key != index_[next_chunk_].first_key || chunk.first_key > static_cast<Key>(~Key{0}) ||
+                (started_ && chunk.first_key <= previous_) || !reader_.Read(buffer_.data(), chunk.size))
+            {
+                failed_ = true;
+                return false;
+            }
+
+            first_key_ = static_cast<Key>(chunk.first_key);
+            chunk_key_count_ = remaining_ = chunk.key_count;
+            position_ = 0;
+            size_ = chunk.size;
+            started_ = true;
+            ++next_chunk_;
+
+            return true;
+        }
+
+        Key DecodeNext()
+        {
+            uint64_t delta = 0;
+
+            for (int shift = 0; ; shift += 7)
+            {
+                if (position_ == size_ || shift >= 64)
+                {
+                    failed_ = true;
+                    return 0;
+                }
+
+                const uint8_t byte = buffer_[position_++];
+                delta |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+                if (!(byte & 0x80))
+                    break;
+            }
+
+            // keys must be strictly ascending (so the sum must not wrap around either)
+            if (delta == 0 || delta > static_cast<uint64_t>(static_cast<Key>(~Key{0}) - previous_))
+                failed_ = true;
+
+            return static_cast<Key>(previous_ + delta);
+        }
+
+        FileReader reader_;
+        key_stream::KeyStreamHeader header_{};
+        std::vector<key_stream::IndexEntry> index_;
+        bool open_ = false;
+        bool failed_ = false;
+
+        // varints of the current chunk
+        std::vector<uint8_t> buffer_;
+        size_t position_ = 0;
+        size_t size_ = 0;
+        Key first_key_{};
+        Key previous_{};
+        uint32_t chunk_key_count_ = 0;
+        uint32_t remaining_ = 0;
+        size_t next_chunk_ = 0;
+        // a key was read since the last seek
+        bool started_ = false;
+    };
+}
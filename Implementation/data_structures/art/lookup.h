@@ -0,0 +1,217 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace art
+{
+    namespace detail
+    {
+        /**
+         * Thread local free list for coroutine frames.
+         *
+         * Interleaved lookups create and destroy a frame per key so recycling them avoids a malloc/free pair for
+         * every lookup and keeps the frames hot in the cache.
+         */
+        class FramePool
+        {
+        public:
+            // frames up to this size are recycled (larger frames use the global allocator)
+            static constexpr size_t kFrameSize = 256;
+
+            ~FramePool()
+            {
+                for (void* frame : frames_)
+                    ::operator delete(frame, kFrameSize);
+            }
+
+            static void* Allocate(const size_t size)
+            {
+                if (size > kFrameSize)
+                    return ::operator new(size);
+
+                auto& frames = Local().frames_;
+                if (frames.empty())
+                    return ::operator new(kFrameSize);
+
+                void* frame = frames.back();
+                frames.pop_back();
+                return frame;
+            }
+
+            static void Deallocate(void* frame, const size_t size)
+            {
+                if (size > kFrameSize)
+                    ::operator delete(frame, size);
+                else
+                    Local().frames_.push_back(frame);
+            }
+
+        private:
+            static FramePool& Local()
+            {
+                thread_local FramePool pool;
+                return pool;
+            }
+
+            std::vector<void*> frames_;
+        };
+    }
+
+    /**
+     * Coroutine of a single tree lookup (see Art::FindCoroutine and Art::LowerBoundCoroutine).
+     *
+     * The lookup starts suspended and suspends again after prefetching the node of every tree level. Resuming it
+     * advances the lookup by one level so a scheduler can interleave many lookups to hide their memory latency.
+     */
+    template <class T>
+    class Lookup
+    {
+    public:
+        struct promise_type
+        {
+            T result{};
+
+            static void* operator new(const size_t size)
+            {
+                return detail::FramePool::Allocate(size);
+            }
+
+            static void operator delete(void* frame, const size_t size)
+            {
+                detail::FramePool::Deallocate(frame, size);
+            }
+
+            Lookup get_return_object()
+            {
+                return Lookup{std::coroutine_handle<promise_type>::from_promise(*this)};
+            }
+
+            std::suspend_always initial_suspend() noexcept
+            {
+                return {};
+            }
+
+            std::suspend_always final_suspend() noexcept
+            {
+                return {};
+            }
+
+            void return_value(T value)
+            {
+                result = std::move(value);
+            }
+
+            void unhandled_exception()
+            {
+                throw;
+            }
+        };
+
+        Lookup() = default;
+
+        Lookup(Lookup&& other) noexcept : handle_{std::exchange(other.handle_, nullptr)}
+        {
+        }
+
+        Lookup& operator=(Lookup&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                    handle_.destroy();
+                handle_ = std::exchange(other.handle_, nullptr);
+            }
+            return *this;
+        }
+
+        ~Lookup()
+        {
+            if (handle_)
+                handle_.destroy();
+        }
+
+        /**
+         * Advances the lookup by one tree level and returns true once it is done.
+         */
+        bool Resume()
+        {
+            handle_.resume();
+            return handle_.done();
+        }
+
+        /**
+         * Runs the lookup to completion and returns its result.
+         */
+        T Get()
+        {
+            while (!handle_.done())
+                handle_.resume();
+            return std::move(handle_.promise().result);
+        }
+
+        /**
+         * Returns the result of a finished lookup.
+         */
+        T& Result()
+        {
+            return handle_.promise().result;
+        }
+
+    private:
+        explicit Lookup(const std::coroutine_handle<promise_type> handle) : handle_{handle}
+        {
+        }
+
+        std::coroutine_handle<promise_type> handle_{nullptr};
+    };
+
+    /**
+     * Round-robin scheduler running count lookups with up to group_size of them in flight.
+     *
+     * create(i) starts the i-th lookup and consume(i, result) is called with its result once it is done.
+     * Lookups are resumed one tree level at a time in turn so the prefetches of all lookups in flight overlap.
+     */
+    template <class T, class Create, class Consume>
+    void RunInterleaved(const size_t count, const size_t group_size, Create&& create, Consume&& consume)
+    {
+        std::vector<std::pair<size_t, Lookup<T>>> group;
+        group.reserve(group_size);
+
+        size_t next = 0;
+        for (; next < count && next < group_size; ++next)
+            group.emplace_back(next, create(next));
+
+        while (!group.empty())
+        {
+            for (size_t i = 0; i < group.size();)
+            {
+                auto& [index, lookup] = group[i];
+
+                if (!lookup.Resume())
+                {
+                    ++i;
+                    continue;
+                }
+
+                consume(index, std::move(lookup.Result()));
+
+                // replace the finished lookup with the next one or shrink the group
+                if (next < count)
+                {
+                    group[i] = {next, create(next)};
+                    ++next;
+                    ++i;
+                }
+                else
+                {
+                    group[i] = std::move(group.back());
+                    group.pop_back();
+                }
+            }
+        }
+    }
+}
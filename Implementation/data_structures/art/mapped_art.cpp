@@ -0,0 +1,155 @@
+#include "mapped_art.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "file_io.h"
+#include "image.h"
+
+/**
+ * Image layout written by MappedArt::Write (native byte order):
+ *
+ *  header:     ImageHeader at offset 0
+ *  nodes:      tree in the node layout of image.h, offsets relative to the start of the file
+ *
+ * The root is always a node (an empty Node4 for an empty image).
+ */
+namespace art
+{
+    namespace
+    {
+        constexpr char kMagic[4]{'A', 'R', 'T', 'M'};
+        constexpr uint8_t kFormatVersion = 1;
+
+        struct ImageHeader
+        {
+            char magic[4];
+            uint8_t version;
+            uint8_t key_size;
+            uint64_t root;
+            uint64_t key_count;
+            // size of the whole image in bytes
+            uint64_t size;
+        };
+    }
+
+    template <class Key>
+    MappedArt<Key>::~MappedArt()
+    {
+        Close();
+    }
+
+    template <class Key>
+    bool MappedArt<Key>::Write(const std::string& path, const std::span<const Key> keys)
+    {
+        FileWriter writer(path);
+        if (!writer.IsOpen())
+            return false;
+
+        // the header is completed once the root was written
+        ImageHeader header{};
+        memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kFormatVersion;
+        header.key_size = sizeof(Key);
+        writer.Write(header);
+
+        header.root = image::WriteNode(writer, keys, KeyTraits<Key>::kRootOffset);
+        header.key_count = keys.size();
+        header.size = writer.Position();
+        writer.WriteAt(0, &header, sizeof(header));
+
+        return writer.Close();
+    }
+
+    template <class Key>
+    bool MappedArt<Key>::Open(const std::string& path)
+    {
+        Close();
+
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat file_stat{};
+        if (fstat(fd, &file_stat) != 0 || static_cast<size_t>(file_stat.st_size) < sizeof(ImageHeader))
+        {
+            close(fd);
+            return false;
+        }
+
+        const auto size = static_cast<size_t>(file_stat.st_size);
+        void* base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+
+        if (base == MAP_FAILED)
+            return false;
+
+        // lookups only touch a few nodes per page so reading ahead would mostly load pages that are never used
+        madvise(base, size, MADV_RANDOM);
+
+        const auto header = static_cast<const ImageHeader*>(base);
+        if (memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != kFormatVersion ||
+            header->key_size != sizeof(Key) || header->size != size || header->root == 0 ||
+            image::IsKey(header->root) || (header->root & ~image::kTagMask) >= size)
+        {
+            munmap(base, size);
+            return false;
+        }
+
+        base_ = static_cast<const std::byte*>(base);
+        size_ = size;
+
+        return true;
+    }
+
+    template <class Key>
+    void MappedArt<Key>::Close()
+    {
+        if (base_ == nullptr)
+            return;
+
+        munmap(const_cast<std::byte*>(base_), size_);
+        base_ = nullptr;
+        size_ = 0;
+    }
+
+    template <class Key>
+    uint64_t MappedArt<Key>::Size() const
+    {
+        return reinterpret_cast<const ImageHeader*>(base_)->key_count;
+    }
+
+    template <class Key>
+    bool MappedArt<Key>::Find(const Key value) const
+    {
+        return image::Find(base_, reinterpret_cast<const ImageHeader*>(base_)->root, value);
+    }
+
+    template <class Key>
+    std::optional<Key> MappedArt<Key>::LowerBound(const Key value) const
+    {
+        const uint64_t root = reinterpret_cast<const ImageHeader*>(base_)->root;
+
+        std::optional<Key> result;
+        image::Scan(base_, root, value, static_cast<Key>(~Key{0}), KeyTraits<Key>::kRootOffset, Key{0}, true, true,
+                    [&](const Key key)
+                    {
+                        result = key;
+                        return false;
+                    });
+
+        return result;
+    }
+
+    template <class Key>
+    std::vector<Key> MappedArt<Key>::FindRange(const Key from, const Key to) const
+    {
+        return image::FindRange(base_, reinterpret_cast<const ImageHeader*>(base_)->root, from, to);
+    }
+
+    template class MappedArt<uint16_t>;
+    template class MappedArt<uint32_t>;
+    template class MappedArt<uint64_t>;
+}
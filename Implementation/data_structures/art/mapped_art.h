@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+#include "node/policy.h"
+
+namespace art
+{
+    /**
+     * Read-only ART for keys of type Key (see KeyTraits) served directly from a memory-mapped image file.
+     *
+     * The image stores the nodes in the image layout of image.h, which is independent of the dispatch policy and the
+     * in-memory nodes: there is no vtable pointer, the children are 64 bit references (the offset of the child in the
+     * image tagged with its node type like TaggedDispatch, or a full key tagged like in combined value/pointer slots),
+     * Node4 and Node16 keep a version field behind their keys and Node48 marks free keys with its own marker. Nothing is
+     * deserialized, so opening only maps the file and checks its header, and the pages a lookup visits are faulted in
+     * on demand (see mapped_art.cpp for the file layout).
+     *
+     * Images are trusted once their header is valid. Only the header is checked when opening, because checking the
+     * nodes would touch the whole file.
+     */
+    template <class Key = uint32_t>
+    class MappedArt
+    {
+    public:
+        MappedArt() = default;
+
+        ~MappedArt();
+
+        MappedArt(const MappedArt&) = delete;
+
+        MappedArt& operator=(const MappedArt&) = delete;
+
+        /**
+         * Writes the image of a tree storing keys (sorted in ascending order without duplicates) to a file.
+         * Nodes are built bottom-up with exactly their number of children. Returns false if the file couldn't be
+         * written.
+         */
+        static bool Write(const std::string& path, std::span<const Key> keys);
+
+        /**
+         * Maps an image written by Write (closing the current one). Returns false (leaving the tree closed) if the
+         * file couldn't be mapped or isn't an image of keys of type Key.
+         */
+        bool Open(const std::string& path);
+
+        /**
+         * Unmaps the image.
+         */
+        void Close();
+
+        bool IsOpen() const
+        {
+            return base_ != nullptr;
+        }
+
+        /**
+         * Returns the number of keys in the image.
+         */
+        uint64_t Size() const;
+
+        bool Find(Key value) const;
+
+        /**
+         * Returns the smallest key greater than or equal to value (or nothing if there is none).
+         */
+        std::optional<Key> LowerBound(Key value) const;
+
+        /**
+         * Returns all keys in [from, to] in ascending order.
+         */
+        std::vector<Key> FindRange(Key from, Key to) const;
+
+    private:
+        const std::byte* base_ = nullptr;
+        size_t size_ = 0;
+    };
+}
@@ -1,294 +1,142 @@
 #include "node.h"
 
+#include <atomic>
+
 namespace art
 {
-    Node* null_node = nullptr;
-
-    Node* Node::Insert(const uint8_t partial_key, Node* child_node)
+    namespace
     {
-        switch (type_)
+        /**
+         * Node4 and Node16 shift their keys and children on insertion so readers can't rely on single stores.
+         * Insertions are bracketed by version increments instead (seqlock) and are invisible to readers until the
+         * version is even again.
+         */
+        template <class N, class Node>
+        Node* InsertVersioned(N* node, const uint8_t partial_key, Node* child_node)
         {
-            case kNode4:
-                {
-                    const auto n = static_cast<Node4*>(this);
-                    return n->Insert(partial_key, child_node);
-                }
-            case kNode16:
-                {
-                    const auto n = static_cast<Node16*>(this);
-                    return n->Insert(partial_key, child_node);
-                }
-            case kNode48:
-                {
-                    const auto n = static_cast<Node48*>(this);
-                    return n->Insert(partial_key, child_node);
-                }
-            case kNode256:
-                {
-                    const auto n = static_cast<Node256*>(this);
-                    return n->Insert(partial_key, child_node);
-                }
-        }
+            const std::atomic_ref version(node->version_);
+            const uint16_t v = version.load(std::memory_order_relaxed);
 
-        __unreachable();
-    }
+            version.store(v + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
 
-    Node*& Node::FindChild(const uint8_t partial_key)
-    {
-        switch (type_)
-        {
-            case kNode4:
-                {
-                    const auto n = static_cast<Node4*>(this);
-                    return n->FindChild(partial_key);
-                }
-            case kNode16:
-                {
-                    const auto n = static_cast<Node16*>(this);
-                    return n->FindChild(partial_key);
-                }
-            case kNode48:
-                {
-                    const auto n = static_cast<Node48*>(this);
-                    return n->FindChild(partial_key);
-                }
-            case kNode256:
-                {
-                    const auto n = static_cast<Node256*>(this);
-                    return n->FindChild(partial_key);
-                }
-        }
+            node->Insert(partial_key, child_node);
 
-        __unreachable();
-    }
+            version.store(v + 2, std::memory_order_release);
 
-    std::vector<uint32_t> Node::GetRange(const uint32_t from, const uint32_t to, const int offset)
-    {
-        switch (type_)
-        {
-            case kNode4:
-                {
-                    const auto n = static_cast<Node4*>(this);
-                    return n->GetRange(from, to, offset);
-                }
-            case kNode16:
-                {
-                    const auto n = static_cast<Node16*>(this);
-                    return n->GetRange(from, to, offset);
-                }
-            case kNode48:
-                {
-                    const auto n = static_cast<Node48*>(this);
-                    return n->GetRange(from, to, offset);
-                }
-            case kNode256:
-                {
-                    const auto n = static_cast<Node256*>(this);
-                    return n->GetRange(from, to, offset);
-                }
+            return node;
         }
 
-        __unreachable();
-    }
-
-    std::vector<uint32_t> Node::GetLowerRange(const uint32_t from, const int offset)
-    {
-        switch (type_)
+        /**
+         * Looks up the child of a Node4 or Node16 with plain loads and only retries if the version shows that the
+         * lookup overlapped with an insertion into this node.
+         *
+         * Since a node is replaced once full it sees at most 16 insertions so the version never wraps around.
+         */
+        template <class N>
+        auto FindChildVersioned(N* node, const uint8_t partial_key)
         {
-            case kNode4:
-                {
-                    const auto n = static_cast<Node4*>(this);
-                    return n->GetLowerRange(from, offset);
-                }
-            case kNode16:
-                {
-                    const auto n = static_cast<Node16*>(this);
-                    return n->GetLowerRange(from, offset);
-                }
-            case kNode48:
-                {
-                    const auto n = static_cast<Node48*>(this);
-                    return n->GetLowerRange(from, offset);
-                }
-            case kNode256:
-                {
-                    const auto n = static_cast<Node256*>(this);
-                    return n->GetLowerRange(from, offset);
-                }
-        }
+            const std::atomic_ref version(node->version_);
 
-        __unreachable();
-    }
+            while (true)
+            {
+                const uint16_t v = version.load(std::memory_order_acquire);
 
-    std::vector<uint32_t> Node::GetUpperRange(const uint32_t to, const int offset)
-    {
-        switch (type_)
-        {
-            case kNode4:
-                {
-                    const auto n = static_cast<Node4*>(this);
-                    return n->GetUpperRange(to, offset);
-                }
-            case kNode16:
+                if (v & 1)
                 {
-                    const auto n = static_cast<Node16*>(this);
-                    return n->GetUpperRange(to, offset);
+                    // insertion in progress
+                    _mm_pause();
+                    continue;
                 }
-            case kNode48:
-                {
-                    const auto n = static_cast<Node48*>(this);
-                    return n->GetUpperRange(to, offset);
-                }
-            case kNode256:
-                {
-                    const auto n = static_cast<Node256*>(this);
-                    return n->GetUpperRange(to, offset);
-                }
-        }
 
-        __unreachable();
+                auto child_node = node->FindChild(partial_key);
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (version.load(std::memory_order_relaxed) == v)
+                    return child_node;
+            }
+        }
     }
 
-    std::vector<uint32_t> Node::GetFullRange()
+    template <class Config>
+    Node<Config>* Node<Config>::InsertConcurrent(const uint8_t partial_key, Node* child_node)
     {
+        // a full node is copied into a new node which readers can't see yet
+        if (this->IsFull())
+            return this->Insert(partial_key, child_node);
+
         switch (type_)
         {
             case kNode4:
-                {
-                    const auto n = static_cast<Node4*>(this);
-                    return n->GetFullRange();
-                }
+                return InsertVersioned(static_cast<Node4<Config>*>(this), partial_key, child_node);
             case kNode16:
-                {
-                    const auto n = static_cast<Node16*>(this);
-                    return n->GetFullRange();
-                }
+                return InsertVersioned(static_cast<Node16<Config>*>(this), partial_key, child_node);
             case kNode48:
                 {
-                    const auto n = static_cast<Node48*>(this);
-                    return n->GetFullRange();
+                    const auto n = static_cast<Node48<Config>*>(this);
+                    return n->InsertConcurrent(partial_key, child_node);
                 }
             case kNode256:
                 {
-                    const auto n = static_cast<Node256*>(this);
-                    return n->GetFullRange();
+                    const auto n = static_cast<Node256<Config>*>(this);
+                    return n->InsertConcurrent(partial_key, child_node);
                 }
         }
 
         __unreachable();
     }
 
-    bool Node::IsFull() const
+    template <class Config>
+    Node<Config>* Node<Config>::FindChildConcurrent(const uint8_t partial_key)
     {
         switch (type_)
         {
             case kNode4:
-                return child_count_ == 4;
+                return FindChildVersioned(static_cast<Node4<Config>*>(this), partial_key);
             case kNode16:
-                return child_count_ == 16;
+                return FindChildVersioned(static_cast<Node16<Config>*>(this), partial_key);
             case kNode48:
-                return child_count_ == 48;
-            case kNode256:
-                return false;
-        }
-
-        __unreachable();
-    }
-
-    void Node::PrintTree(const int depth)
-    {
-        switch (type_)
-        {
-            case kNode4:
-                {
-                    const auto n = static_cast<Node4*>(this);
-                    n->PrintTree(depth);
-                    return;
-                }
-            case kNode16:
                 {
-                    const auto n = static_cast<Node16*>(this);
-                    n->PrintTree(depth);
-                    return;
-                }
-            case kNode48:
-                {
-                    const auto n = static_cast<Node48*>(this);
-                    n->PrintTree(depth);
-                    return;
+                    const auto n = static_cast<Node48<Config>*>(this);
+                    return n->FindChildConcurrent(partial_key);
                 }
             case kNode256:
                 {
-                    const auto n = static_cast<Node256*>(this);
-                    n->PrintTree(depth);
-                    return;
+                    const auto n = static_cast<Node256<Config>*>(this);
+                    return n->FindChildConcurrent(partial_key);
                 }
         }
 
         __unreachable();
     }
 
-    void Node::PrintChild(Node* child, const int i, const int m)
+    template <class Config>
+    void Node<Config>::PrintChild(Node* child, const int i, const int m)
     {
         if (child == nullptr)
             return;
 
         if (IsLazyExpanded(child))
-        {
-            const auto val = static_cast<uint32_t>(reinterpret_cast<uint64_t>(child) >> 32);
-            std::cout << std::dec << i << ":[" << std::hex << val << "]";
-        }
+            std::cout << std::dec << i << ":[" << std::hex << GetLazyExpansion(child) << "]";
         else
             std::cout << std::dec << i << ":" << std::hex << child;
         if (i < m - 1)
             std::cout << ",";
     }
 
-    bool Node::IsLazyExpanded(Node* node_ptr)
+    template <class Config>
+    Node<Config>* Node<Config>::Create(const uint16_t child_count)
     {
-        return reinterpret_cast<uint64_t>(node_ptr) & 0x7ULL;
+        if (child_count <= 4)
+            return Allocate<Node4<Config>>();
+        if (child_count <= 16)
+            return Allocate<Node16<Config>>();
+        if (child_count <= 48)
+            return Allocate<Node48<Config>>();
+        return Allocate<Node256<Config>>();
     }
 
-    int Node::CmpLazyExpansion(Node* node_ptr, const uint32_t key)
-    {
-        // address_value is actual full key value instead of address
-        // (key value stored at high 32 bits)
-        const uint32_t full_key_value = reinterpret_cast<uint64_t>(node_ptr) >> 32;
-        if (key < full_key_value)
-            return -1;
-        if (key > full_key_value)
-            return 1;
-        return 0;
-    }
+#define ART_INSTANTIATE_NODE(Key, Dispatch) template class Node<TreeConfig<Key, Dispatch>>;
 
-    void Node::Destruct()
-    {
-        switch (type_)
-        {
-            case kNode4:
-                {
-                    const auto n = static_cast<Node4*>(this);
-                    n->Destruct();
-                    return;
-                }
-            case kNode16:
-                {
-                    const auto n = static_cast<Node16*>(this);
-                    n->Destruct();
-                    return;
-                }
-            case kNode48:
-                {
-                    const auto n = static_cast<Node48*>(this);
-                    n->Destruct();
-                    return;
-                }
-            case kNode256:
-                {
-                    const auto n = static_cast<Node256*>(this);
-                    n->Destruct();
-                    return;
-                }
-        }
-    }
+    ART_FOR_EACH_CONFIG(ART_INSTANTIATE_NODE)
 }
@@ -1,19 +1,19 @@
 #pragma once
 
 #include <iostream>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
 #include <vector>
 
-#include "node.h"
+#include "policy.h"
+#include "simd.h"
 #include "../../../util.h"
 
 namespace art
 {
-    class Node;
-
-    // null pointer used to indicate non-existing node
-    extern Node* null_node;
-
     enum NodeType : uint8_t
     {
         kNode4,
@@ -22,18 +22,42 @@ namespace art
         kNode256
     };
 
-    class Node
+    template <class Config>
+    class Node;
+
+    template <class Config>
+    class Node4;
+
+    template <class Config>
+    class Node16;
+
+    template <class Config>
+    class Node48;
+
+    template <class Config>
+    class Node256;
+
+    /**
+     * Operations every node type implements.
+     *
+     * The node header forwards them to the actual node type using the dispatch policy of the tree (see policy.h).
+     * Code handling nodes of every type (e.g. recursive range searches) therefore stays the same for all policies.
+     */
+    template <class Config, bool kVirtual = Config::Dispatch::kVirtual>
+    class NodeInterface
     {
-    public:
-        explicit Node(const NodeType type) : type_{type}, child_count_{0}
-        {
-        }
+        using Node = art::Node<Config>;
+        using Key = typename Config::Key;
 
+    public:
         /**
          * Inserts a new partial key with a pointer to a child node into the node and returns the pointer to it.
          * The returned pointer might point to a new node if the node was already full.
          */
-        Node* Insert(uint8_t partial_key, Node* child_node);
+        Node* Insert(const uint8_t partial_key, Node* child_node)
+        {
+            return Dispatch([&](auto* node) -> Node* { return node->Insert(partial_key, child_node); });
+        }
 
         /**
          * Finds the child node for a given partial key and returns a reference to the pointer to its memory address.
@@ -50,72 +74,424 @@ namespace art
          * for an actual address. The low 3 bits being 1 indicates the high 32 bits storing an 32 key
          * value.
          */
-        Node*& FindChild(uint8_t partial_key);
+        Node*& FindChild(const uint8_t partial_key)
+        {
+            return Dispatch([&](auto* node) -> Node*& { return node->FindChild(partial_key); });
+        }
+
+        /**
+         * Returns the child with the smallest partial key greater or equal to from_key (or nullptr if there is none).
+         */
+        Node* GetFirstChild(const uint8_t from_key) const
+        {
+            return Dispatch([&](auto* node) -> Node* { return node->GetFirstChild(from_key); });
+        }
 
         /**
          * Recursively finds all values in a given range (inclusive).
          * TODO: Implement GetRange without recursion using custom input iterator.
          */
-        std::vector<uint32_t> GetRange(uint32_t from, uint32_t to, int offset);
+        std::vector<Key> GetRange(const Key from, const Key to, const int offset) const
+        {
+            return Dispatch([&](auto* node) { return node->GetRange(from, to, offset); });
+        }
 
         /**
          * Recursively finds all values higher than a given value (inclusive).
          */
-        std::vector<uint32_t> GetLowerRange(uint32_t from, int offset);
+        std::vector<Key> GetLowerRange(const Key from, const int offset) const
+        {
+            return Dispatch([&](auto* node) { return node->GetLowerRange(from, offset); });
+        }
 
         /**
          * Recursively finds all values lower than a given value (inclusive).
          */
-        std::vector<uint32_t> GetUpperRange(uint32_t to, int offset);
+        std::vector<Key> GetUpperRange(const Key to, const int offset) const
+        {
+            return Dispatch([&](auto* node) { return node->GetUpperRange(to, offset); });
+        }
 
         /**
          * Finds all values.
          */
-        std::vector<uint32_t> GetFullRange();
+        std::vector<Key> GetFullRange() const
+        {
+            return Dispatch([&](auto* node) { return node->GetFullRange(); });
+        }
+
+        /**
+         * Returns all children with a partial key in a given range (inclusive) in ascending partial key order.
+         */
+        std::vector<std::pair<uint8_t, Node*>> GetChildren(const uint8_t from_key, const uint8_t to_key) const
+        {
+            return Dispatch([&](auto* node) { return node->GetChildren(from_key, to_key); });
+        }
 
         /**
          * Returns true if the node is full.
          */
-        bool IsFull() const;
+        bool IsFull() const
+        {
+            return Dispatch([](auto* node) { return node->IsFull(); });
+        }
 
         /**
          * Destroys this node and its children recursively.
          */
-        void Destruct();
+        void Destruct()
+        {
+            Dispatch([](auto* node) { node->Destruct(); });
+        }
 
         /**
          * Print Tree in preorder way.
          */
-        void PrintTree(int depth);
+        void PrintTree(const int depth) const
+        {
+            Dispatch([&](auto* node) { node->PrintTree(depth); });
+        }
+
+    private:
+        template <class F>
+        decltype(auto) Dispatch(F&& f)
+        {
+            return Config::Dispatch::Dispatch(static_cast<Node*>(this), std::forward<F>(f));
+        }
+
+        template <class F>
+        decltype(auto) Dispatch(F&& f) const
+        {
+            return Config::Dispatch::Dispatch(static_cast<const Node*>(this), std::forward<F>(f));
+        }
+    };
+
+    /**
+     * Abstract base class of the nodes with virtual dispatch (see above for the documentation of the operations).
+     */
+    template <class Config>
+    class NodeInterface<Config, true>
+    {
+        using Node = art::Node<Config>;
+        using Key = typename Config::Key;
+
+    public:
+        virtual Node* Insert(uint8_t partial_key, Node* child_node) = 0;
+
+        virtual Node*& FindChild(uint8_t partial_key) = 0;
+
+        virtual Node* GetFirstChild(uint8_t from_key) const = 0;
+
+        virtual std::vector<Key> GetRange(Key from, Key to, int offset) const = 0;
+
+        virtual std::vector<Key> GetLowerRange(Key from, int offset) const = 0;
+
+        virtual std::vector<Key> GetUpperRange(Key to, int offset) const = 0;
+
+        virtual std::vector<Key> GetFullRange() const = 0;
+
+        virtual std::vector<std::pair<uint8_t, Node*>> GetChildren(uint8_t from_key, uint8_t to_key) const = 0;
+
+        virtual bool IsFull() const = 0;
+
+        virtual void Destruct() = 0;
+
+        virtual void PrintTree(int depth) const = 0;
+
+    protected:
+        // nodes are only destroyed via Node::Delete which knows their actual type
+        ~NodeInterface() = default;
+    };
+
+    /**
+     * Header of all node types.
+     */
+    template <class Config>
+    class Node : public NodeInterface<Config>
+    {
+    public:
+        using Key = typename Config::Key;
+        using Allocator = typename Config::Allocator;
+
+        explicit Node(const NodeType type) : type_{type}, child_count_{0}, version_{0}
+        {
+        }
+
+        /**
+         * Calls f with this node cast to its actual node type and returns the result.
+         */
+        template <class F>
+        decltype(auto) Visit(F&& f)
+        {
+            switch (type_)
+            {
+                case kNode4:
+                    return f(static_cast<Node4<Config>*>(this));
+                case kNode16:
+                    return f(static_cast<Node16<Config>*>(this));
+                case kNode48:
+                    return f(static_cast<Node48<Config>*>(this));
+                case kNode256:
+                    return f(static_cast<Node256<Config>*>(this));
+            }
+
+            __unreachable();
+        }
+
+        template <class F>
+        decltype(auto) Visit(F&& f) const
+        {
+            switch (type_)
+            {
+                case kNode4:
+                    return f(static_cast<const Node4<Config>*>(this));
+                case kNode16:
+                    return f(static_cast<const Node16<Config>*>(this));
+                case kNode48:
+                    return f(static_cast<const Node48<Config>*>(this));
+                case kNode256:
+                    return f(static_cast<const Node256<Config>*>(this));
+            }
+
+            __unreachable();
+        }
+
+        /**
+         * Inserts a new partial key with a pointer to a child node while other threads might concurrently call
+         * FindChildConcurrent on this node. Only a single thread may insert at a time.
+         *
+         * If the node is already full a new node is returned which isn't visible to readers yet. In this case the
+         * node itself stays unmodified and the caller has to publish the new node and retire this one.
+         */
+        Node* InsertConcurrent(uint8_t partial_key, Node* child_node);
+
+        /**
+         * Finds the child node for a given partial key while a single writer might concurrently call
+         * InsertConcurrent on this node and returns it (or nullptr if the partial key does not exist).
+         */
+        Node* FindChildConcurrent(uint8_t partial_key);
+
+        /**
+         * Destroys only this node (but not its children).
+         */
+        void Delete()
+        {
+            Visit([](auto* node) { Free(node); });
+        }
 
         /**
          * Prints a pointer to a child
          */
         static void PrintChild(Node* child, int i, int m);
 
+        /**
+         * Allocates an empty node of the smallest node type able to hold child_count children.
+         */
+        static Node* Create(uint16_t child_count);
+
+        /**
+         * Allocates an empty node of type N using the allocator of the tree.
+         */
+        template <class N>
+        static N* Allocate()
+        {
+            typename std::allocator_traits<Allocator>::template rebind_alloc<N> allocator;
+            return std::construct_at(allocator.allocate(1));
+        }
+
+        /**
+         * Destroys and frees a node allocated by Allocate.
+         */
+        template <class N>
+        static void Free(N* node)
+        {
+            typename std::allocator_traits<Allocator>::template rebind_alloc<N> allocator;
+            std::destroy_at(node);
+            allocator.deallocate(node, 1);
+        }
+
+        /**
+         * Returns a pointer value storing a full key using combined value/pointer slots.
+         * For 64 bit keys the partial key of the root is not stored (see KeyTraits).
+         */
+        static Node* CreateLazyExpansion(const Key key)
+        {
+            return reinterpret_cast<Node*>(static_cast<uint64_t>(key) << KeyTraits<Key>::kLazyExpansionShift | 0x7);
+        }
+
+        /**
+         * Returns the full key stored at a pointer using combined value/pointer slots
+         * (without the partial key of the root for 64 bit keys).
+         */
+        static Key GetLazyExpansion(Node* node_ptr)
+        {
+            return static_cast<Key>(reinterpret_cast<uint64_t>(node_ptr) >> KeyTraits<Key>::kLazyExpansionShift);
+        }
+
+        /**
+         * Returns the pointer to store in the parent of node (tagged with its node type for TaggedDispatch).
+         */
+        static Node* Tag(Node* node)
+        {
+            if constexpr (kTaggedChildren)
+                return reinterpret_cast<Node*>(reinterpret_cast<uint64_t>(node) | (node->type_ + 1));
+            else
+                return node;
+        }
+
+        /**
+         * Returns the node a (possibly tagged) child pointer points to.
+         */
+        static Node* Untag(Node* node_ptr)
+        {
+            if constexpr (kTaggedChildren)
+                return reinterpret_cast<Node*>(reinterpret_cast<uint64_t>(node_ptr) & ~0x7ULL);
+            else
+                return node_ptr;
+        }
+
+        /**
+         * Finds the child for a given partial key in the node a child pointer points to.
+         *
+         * With TaggedDispatch the kernel is selected by the node type stored in the pointer. Otherwise the node type
+         * has to be loaded from the header of the node before its keys can be searched.
+         */
+        static Node* FindChildOf(Node* node_ptr, const uint8_t partial_key)
+        {
+            if constexpr (kTaggedChildren)
+            {
+                Node* node = Untag(node_ptr);
+
+                switch (GetTag(node_ptr))
+                {
+                    case kNode4 + 1:
+                        return static_cast<Node4<Config>*>(node)->FindChild(partial_key);
+                    case kNode16 + 1:
+                        return static_cast<Node16<Config>*>(node)->FindChild(partial_key);
+                    case kNode48 + 1:
+                        return static_cast<Node48<Config>*>(node)->FindChild(partial_key);
+                    case kNode256 + 1:
+                        return static_cast<Node256<Config>*>(node)->FindChild(partial_key);
+                }
+
+                __unreachable();
+            }
+            else
+                return node_ptr->FindChild(partial_key);
+        }
+
+        /**
+         * Prefetches the cache lines of the node a child pointer points to needed to look up partial_key.
+         *
+         * With TaggedDispatch only the lines of its node type are fetched. Otherwise the node type is unknown until
+         * the node arrives so besides the header (and keys of Node4/16) the lines a Node48 key and a Node256 child
+         * for partial_key would be in are fetched as well.
+         */
+        static void Prefetch(Node* node_ptr, const uint8_t partial_key)
+        {
+            const auto address = reinterpret_cast<const char*>(Untag(node_ptr));
+
+            // the offsets of the members (see Node48)
+            const auto node48_key = address + Node48<Config>::kKeysOffset + partial_key;
+            const auto node256_child = address + Node256<Config>::kChildrenOffset + partial_key * sizeof(Node*);
+
+            if constexpr (kTaggedChildren)
+            {
+                switch (GetTag(node_ptr))
+                {
+                    case kNode4 + 1:
+                    case kNode16 + 1:
+                        // the keys share the first line with the header
+                        _mm_prefetch(address, _MM_HINT_T0);
+                        return;
+                    case kNode48 + 1:
+                        _mm_prefetch(node48_key, _MM_HINT_T0);
+                        return;
+                    case kNode256 + 1:
+                        _mm_prefetch(node256_child, _MM_HINT_T0);
+                        return;
+                }
+
+                __unreachable();
+            }
+            else
+            {
+                _mm_prefetch(address, _MM_HINT_T0);
+                _mm_prefetch(node48_key, _MM_HINT_T0);
+                _mm_prefetch(node256_child, _MM_HINT_T0);
+            }
+        }
+
         /**
          * Returns true if the pointer value is actually a full key stored using combined value/pointer slots.
          */
-        static bool IsLazyExpanded(Node* node_ptr);
+        static bool IsLazyExpanded(Node* node_ptr)
+        {
+            // tagged pointers to nodes use the tags 1 to 4
+            if constexpr (kTaggedChildren)
+                return GetTag(node_ptr) == 0x7;
+            else
+                return reinterpret_cast<uint64_t>(node_ptr) & 0x7ULL;
+        }
 
         /**
          * Compares a full key stored via lazy expansion at a pointer with key
          * and returns -1 if the value is less than the stored key, 1 if it's higher and 0 if they're equal.
          */
-        static int CmpLazyExpansion(Node* node_ptr, uint32_t key);
+        static int CmpLazyExpansion(Node* node_ptr, const Key key)
+        {
+            // address_value is actual full key value instead of address
+            // (key value stored at the high bits, the partial key of the root was already matched on the path)
+            const Key full_key_value = GetLazyExpansion(node_ptr);
+            const Key stored_key = key & kLazyExpansionMask;
+            if (stored_key < full_key_value)
+                return -1;
+            if (stored_key > full_key_value)
+                return 1;
+            return 0;
+        }
+
+        // bits of a key stored at a pointer using combined value/pointer slots
+        static constexpr Key kLazyExpansionMask =
+            static_cast<Key>(~uint64_t{0} >> KeyTraits<Key>::kLazyExpansionShift);
+
+        // null pointer used to indicate non-existing node
+        static inline Node* null_node = nullptr;
+
+    private:
+        static constexpr bool kTaggedChildren = Config::Dispatch::kTaggedChildren;
+
+        static uint64_t GetTag(Node* node_ptr)
+        {
+            return reinterpret_cast<uint64_t>(node_ptr) & 0x7ULL;
+        }
 
     public:
         NodeType type_;
         uint8_t child_count_;
+        // sequence number of concurrent in-place insertions into Node4 and Node16 (odd while inserting)
+        // stored in what would otherwise be padding so it doesn't increase any node size
+        uint16_t version_;
     };
 
     // ================================================================
     //                      Specific Nodes
     // ================================================================
 
-    class Node4 : public Node
+    template <class Config>
+    class Node4 : public Node<Config>
     {
+        using Node = art::Node<Config>;
+        using Key = typename Config::Key;
+
     public:
+        using Node::type_;
+        using Node::child_count_;
+        using Node::IsLazyExpanded;
+        using Node::CmpLazyExpansion;
+        using Node::GetLazyExpansion;
+        using Node::Untag;
+
         Node4() : Node(kNode4), keys_{}, children_{}
         {
         }
@@ -124,13 +500,22 @@ namespace art
 
         Node*& FindChild(uint8_t partial_key);
 
-        std::vector<uint32_t> GetRange(uint32_t from, uint32_t to, int offset) const;
+        Node* GetFirstChild(uint8_t from_key) const;
+
+        std::vector<Key> GetRange(Key from, Key to, int offset) const;
 
-        std::vector<uint32_t> GetLowerRange(uint32_t from, int offset) const;
+        std::vector<Key> GetLowerRange(Key from, int offset) const;
 
-        std::vector<uint32_t> GetUpperRange(uint32_t to, int offset) const;
+        std::vector<Key> GetUpperRange(Key to, int offset) const;
 
-        std::vector<uint32_t> GetFullRange() const;
+        std::vector<Key> GetFullRange() const;
+
+        std::vector<std::pair<uint8_t, Node*>> GetChildren(uint8_t from_key, uint8_t to_key) const;
+
+        bool IsFull() const
+        {
+            return child_count_ == 4;
+        }
 
         void Destruct();
 
@@ -141,9 +526,20 @@ namespace art
         Node* children_[4];
     };
 
-    class Node16 : public Node
+    template <class Config>
+    class Node16 : public Node<Config>
     {
+        using Node = art::Node<Config>;
+        using Key = typename Config::Key;
+
     public:
+        using Node::type_;
+        using Node::child_count_;
+        using Node::IsLazyExpanded;
+        using Node::CmpLazyExpansion;
+        using Node::GetLazyExpansion;
+        using Node::Untag;
+
         Node16() : Node(kNode16), keys_{}, children_{}
         {
         }
@@ -152,13 +548,22 @@ namespace art
 
         Node*& FindChild(uint8_t partial_key);
 
-        std::vector<uint32_t> GetRange(uint32_t from, uint32_t to, int offset);
+        Node* GetFirstChild(uint8_t from_key) const;
+
+        std::vector<Key> GetRange(Key from, Key to, int offset) const;
+
+        std::vector<Key> GetLowerRange(Key from, int offset) const;
 
-        std::vector<uint32_t> GetLowerRange(uint32_t from, int offset);
+        std::vector<Key> GetUpperRange(Key to, int offset) const;
 
-        std::vector<uint32_t> GetUpperRange(uint32_t to, int offset) const;
+        std::vector<Key> GetFullRange() const;
 
-        std::vector<uint32_t> GetFullRange() const;
+        std::vector<std::pair<uint8_t, Node*>> GetChildren(uint8_t from_key, uint8_t to_key) const;
+
+        bool IsFull() const
+        {
+            return child_count_ == 16;
+        }
 
         void Destruct();
 
@@ -168,14 +573,25 @@ namespace art
         uint8_t keys_[16];
         Node* children_[16];
 
-        friend class Node4;
+        friend class Node4<Config>;
     };
 
-    class Node48 : public Node
+    template <class Config>
+    class Node48 : public Node<Config>
     {
+        using Node = art::Node<Config>;
+        using Key = typename Config::Key;
+
         static constexpr uint8_t free_marker_ = 48;
 
     public:
+        using Node::type_;
+        using Node::child_count_;
+        using Node::IsLazyExpanded;
+        using Node::CmpLazyExpansion;
+        using Node::GetLazyExpansion;
+        using Node::Untag;
+
         Node48() : Node(kNode48), keys_{}, children_{}
         {
             std::fill_n(keys_, 256, free_marker_);
@@ -183,53 +599,335 @@ namespace art
 
         Node* Insert(uint8_t partial_key, Node* child_node);
 
+        Node* InsertConcurrent(uint8_t partial_key, Node* child_node);
+
         Node*& FindChild(uint8_t partial_key);
 
-        std::vector<uint32_t> GetRange(uint32_t from, uint32_t to, int offset) const;
+        Node* GetFirstChild(uint8_t from_key) const;
+
+        Node* FindChildConcurrent(uint8_t partial_key);
+
+        std::vector<Key> GetRange(Key from, Key to, int offset) const;
+
+        std::vector<Key> GetLowerRange(Key from, int offset) const;
 
-        std::vector<uint32_t> GetLowerRange(uint32_t from, int offset) const;
+        std::vector<Key> GetUpperRange(Key to, int offset) const;
 
-        std::vector<uint32_t> GetUpperRange(uint32_t to, int offset) const;
+        std::vector<Key> GetFullRange() const;
 
-        std::vector<uint32_t> GetFullRange() const;
+        std::vector<std::pair<uint8_t, Node*>> GetChildren(uint8_t from_key, uint8_t to_key) const;
+
+        bool IsFull() const
+        {
+            return child_count_ == 48;
+        }
 
         void Destruct();
 
         void PrintTree(int depth) const;
 
+        /**
+         * Computes the occupancy bitmap of the child slots (see simd::ScanKernels).
+         */
+        void GetOccupancy(uint64_t* bitmap) const;
+
+        // offsets of the members for prefetching and gathering from the nodes of multiple lookups at once (see
+        // Prefetch and Art::FindBatchGather), taken from the members since with VirtualDispatch the keys might reuse
+        // the tail padding of the header after the vtable pointer (defined below as the class has to be complete)
+        static const size_t kKeysOffset;
+        static const size_t kChildrenOffset;
+        static constexpr uint8_t kFreeMarker = free_marker_;
+
     private:
         uint8_t keys_[256];
         Node* children_[48];
 
-        friend class Node16;
+        friend class Node16<Config>;
     };
 
-    class Node256 : public Node
+    template <class Config>
+    class Node256 : public Node<Config>
     {
+        using Node = art::Node<Config>;
+        using Key = typename Config::Key;
+
     public:
+        using Node::type_;
+        using Node::child_count_;
+        using Node::IsLazyExpanded;
+        using Node::CmpLazyExpansion;
+        using Node::GetLazyExpansion;
+        using Node::Untag;
+
         Node256() : Node(kNode256), children_{}
         {
         }
 
         Node* Insert(uint8_t partial_key, Node* child_node);
 
+        Node* InsertConcurrent(uint8_t partial_key, Node* child_node);
+
         Node*& FindChild(uint8_t partial_key);
 
-        std::vector<uint32_t> GetRange(uint32_t from, uint32_t to, int offset) const;
+        Node* GetFirstChild(uint8_t from_key) const;
+
+        Node* FindChildConcurrent(uint8_t partial_key);
+
+        std::vector<Key> GetRange(Key from, Key to, int offset) const;
 
-        std::vector<uint32_t> GetLowerRange(uint32_t from, int offset) const;
+        std::vector<Key> GetLowerRange(Key from, int offset) const;
 
-        std::vector<uint32_t> GetUpperRange(uint32_t to, int offset) const;
+        std::vector<Key> GetUpperRange(Key to, int offset) const;
 
-        std::vector<uint32_t> GetFullRange() const;
+        std::vector<Key> GetFullRange() const;
+
+        std::vector<std::pair<uint8_t, Node*>> GetChildren(uint8_t from_key, uint8_t to_key) const;
+
+        bool IsFull() const
+        {
+            return false;
+        }
 
         void Destruct();
 
         void PrintTree(int depth) const;
 
+        /**
+         * Computes the occupancy bitmap of the child slots (see simd::ScanKernels).
+         */
+        void GetOccupancy(uint64_t* bitmap) const;
+
+        // offset of the children (see Node48)
+        static const size_t kChildrenOffset;
+
     private:
         Node* children_[256];
 
-        friend class Node48;
+        friend class Node48<Config>;
     };
+
+    // the nodes aren't standard-layout (their header is a base class) but all supported compilers lay them out like C
+    // structs after the header
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+#endif
+
+    template <class Config>
+    const size_t Node48<Config>::kKeysOffset = offsetof(Node48, keys_);
+
+    template <class Config>
+    const size_t Node48<Config>::kChildrenOffset = offsetof(Node48, children_);
+
+    template <class Config>
+    const size_t Node256<Config>::kChildrenOffset = offsetof(Node256, children_);
+
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+
+    // ================================================================
+    //                      Node Kernels
+    // ================================================================
+
+    /**
+     * Lookups and insertions are defined here so every dispatch policy can inline them. The remaining operations
+     * are compiled once in the node's translation unit (see ART_FOR_EACH_CONFIG).
+     */
+
+    template <class Config>
+    Node<Config>* Node4<Config>::Insert(const uint8_t partial_key, Node* child_node)
+    {
+        if (IsFull())
+        {
+            auto new_node = Node::template Allocate<Node16<Config>>();
+
+            memmove(new_node->keys_, keys_, 4);
+            memmove(new_node->children_, children_, sizeof(uint64_t) * 4);
+            new_node->child_count_ = 4;
+
+            return new_node->Insert(partial_key, child_node);
+        }
+
+        // find position to insert new partial key (sorted in ascending order)
+        // -> first key greater than the partial key (all 4 keys are compared at once, see simd.h)
+        const uint32_t cmp_mask = simd::Node4Greater(keys_, partial_key, child_count_);
+        const uint8_t pos = cmp_mask ? __ctz(cmp_mask) >> 3 : child_count_;
+
+        // move everything from pos
+        memmove(keys_ + pos + 1, keys_ + pos, child_count_ - pos);
+        memmove(children_ + pos + 1, children_ + pos, (child_count_ - pos) * sizeof(uint64_t));
+
+        // insert
+        keys_[pos] = partial_key;
+        children_[pos] = child_node;
+        ++child_count_;
+
+        return this;
+    }
+
+    template <class Config>
+    Node<Config>*& Node4<Config>::FindChild(const uint8_t partial_key)
+    {
+        const uint32_t cmp_mask = simd::Node4Equal(keys_, partial_key, child_count_);
+
+        if (cmp_mask)
+            return children_[__ctz(cmp_mask) >> 3];
+
+        return Node::null_node;
+    }
+
+    template <class Config>
+    Node<Config>* Node4<Config>::GetFirstChild(const uint8_t from_key) const
+    {
+        const uint32_t cmp_mask = simd::Node4GreaterEqual(keys_, from_key, child_count_);
+
+        if (cmp_mask)
+            return children_[__ctz(cmp_mask) >> 3];
+
+        return nullptr;
+    }
+
+    template <class Config>
+    Node<Config>* Node16<Config>::Insert(const uint8_t partial_key, Node* child_node)
+    {
+        if (IsFull())
+        {
+            const auto new_node = Node::template Allocate<Node48<Config>>();
+
+            for (uint8_t i = 0; i < 16; ++i)
+            {
+                new_node->keys_[keys_[i]] = i;
+            }
+
+            memmove(new_node->children_, children_, sizeof(uint64_t) * 16);
+            new_node->child_count_ = 16;
+
+            return new_node->Insert(partial_key, child_node);
+        }
+
+        // find position to insert new partial key (sorted in ascending order)
+        // -> first key greater than the partial key (see simd.h for the kernels)
+        const uint32_t cmp_mask = simd::node16_kernels.greater(keys_, partial_key, child_count_);
+        const uint32_t pos = cmp_mask ? __ctz(cmp_mask) : child_count_;
+
+        // move everything from pos
+        memmove(keys_ + pos + 1, keys_ + pos, child_count_ - pos);
+        memmove(children_ + pos + 1, children_ + pos, (child_count_ - pos) * sizeof(uint64_t));
+
+        // insert
+        keys_[pos] = partial_key;
+        children_[pos] = child_node;
+        ++child_count_;
+
+        return this;
+    }
+
+    template <class Config>
+    Node<Config>*& Node16<Config>::FindChild(const uint8_t partial_key)
+    {
+        /**
+         * x86-64 SIMD comparing all keys at once using SSE2, AVX2 or AVX-512 depending on the CPU (see simd.h)
+         * See for reference: https://www.intel.com/content/www/us/en/docs/intrinsics-guide/index.html
+         *
+         * The kernel returns a bitmask storing 1 at bit i if the key at position i is equal otherwise 0.
+         * Only the first child_count_ keys are compared (needed when searching 0th partial key since unused key
+         * elements are also 0).
+         */
+        const uint32_t cmp_mask = simd::node16_kernels.equal(keys_, partial_key, child_count_);
+
+        if (cmp_mask)
+            // return Node pointer in pointer array at index equal to trailing zeros in cmp_mask
+            return children_[__ctz(cmp_mask)];
+
+        return Node::null_node;
+    }
+
+    template <class Config>
+    Node<Config>* Node16<Config>::GetFirstChild(const uint8_t from_key) const
+    {
+        // keys are sorted so the first key greater or equal to from_key is at the first set bit
+        const uint32_t cmp_mask = simd::node16_kernels.greater_equal(keys_, from_key, child_count_);
+
+        if (cmp_mask)
+            return children_[__ctz(cmp_mask)];
+
+        return nullptr;
+    }
+
+    template <class Config>
+    Node<Config>* Node48<Config>::Insert(const uint8_t partial_key, Node* child_node)
+    {
+        if (IsFull())
+        {
+            auto new_node = Node::template Allocate<Node256<Config>>();
+
+            for (uint16_t i = 0; i < 256; ++i)
+            {
+                if (keys_[i] == free_marker_) continue;
+
+                new_node->children_[i] = children_[keys_[i]];
+            }
+
+            new_node->child_count_ = 48;
+
+            return new_node->Insert(partial_key, child_node);
+        }
+
+        // insert
+
+        // find next free index
+        int free_index = child_count_;
+        if (children_[free_index] != nullptr)
+            for (free_index = 0; free_index < 48 && children_[free_index] != nullptr; ++free_index);
+
+        keys_[partial_key] = free_index;
+        children_[free_index] = child_node;
+        ++child_count_;
+
+        return this;
+    }
+
+    template <class Config>
+    Node<Config>*& Node48<Config>::FindChild(const uint8_t partial_key)
+    {
+        if (keys_[partial_key] != free_marker_)
+            return children_[keys_[partial_key]];
+
+        return Node::null_node;
+    }
+
+    template <class Config>
+    Node<Config>* Node48<Config>::GetFirstChild(const uint8_t from_key) const
+    {
+        for (uint16_t i = from_key; i < 256; ++i)
+            if (keys_[i] != free_marker_)
+                return children_[keys_[i]];
+
+        return nullptr;
+    }
+
+    template <class Config>
+    Node<Config>* Node256<Config>::Insert(const uint8_t partial_key, Node* child_node)
+    {
+        children_[partial_key] = child_node;
+        ++child_count_;
+        return this;
+    }
+
+    template <class Config>
+    Node<Config>*& Node256<Config>::FindChild(const uint8_t partial_key)
+    {
+        return children_[partial_key];
+    }
+
+    template <class Config>
+    Node<Config>* Node256<Config>::GetFirstChild(const uint8_t from_key) const
+    {
+        for (uint16_t i = from_key; i < 256; ++i)
+            if (children_[i] != nullptr)
+                return children_[i];
+
+        return nullptr;
+    }
 }
@@ -1,22 +1,34 @@
 #include "node.h"
 
+#include <atomic>
+#include "simd.h"
+
 namespace art
 {
-    Node* Node256::Insert(const uint8_t partial_key, Node* child_node)
+    template <class Config>
+    Node<Config>* Node256<Config>::InsertConcurrent(const uint8_t partial_key, Node* child_node)
     {
-        children_[partial_key] = child_node;
+        std::atomic_ref(children_[partial_key]).store(child_node, std::memory_order_release);
         ++child_count_;
         return this;
     }
 
-    Node*& Node256::FindChild(const uint8_t partial_key)
+    template <class Config>
+    Node<Config>* Node256<Config>::FindChildConcurrent(const uint8_t partial_key)
+    {
+        return std::atomic_ref(children_[partial_key]).load(std::memory_order_acquire);
+    }
+
+    template <class Config>
+    void Node256<Config>::GetOccupancy(uint64_t* bitmap) const
     {
-        return children_[partial_key];
+        simd::scan_kernels.non_null(reinterpret_cast<const void* const*>(children_), bitmap);
     }
 
-    std::vector<uint32_t> Node256::GetRange(const uint32_t from, const uint32_t to, const int offset) const
+    template <class Config>
+    std::vector<typename Config::Key> Node256<Config>::GetRange(const Key from, const Key to, const int offset) const
     {
-        std::vector<uint32_t> res;
+        std::vector<Key> res;
 
         const uint8_t from_key = from >> offset & 0xFF;
         const uint8_t to_key = to >> offset & 0xFF;
@@ -27,35 +39,36 @@ namespace art
             {
                 if (!IsLazyExpanded(children_[from_key]))
                 {
-                    auto p = children_[from_key]->GetLowerRange(from, offset - 8);
+                    auto p = Untag(children_[from_key])->GetLowerRange(from, offset - 8);
                     res.insert(res.end(), p.begin(), p.end());
                 }
                 else if (CmpLazyExpansion(children_[from_key], from) <= 0)
-                    res.push_back(reinterpret_cast<uint64_t>(children_[from_key]) >> 32);
+                    res.push_back(GetLazyExpansion(children_[from_key]));
             }
 
-            for (uint16_t i = from_key + 1; i < to_key; ++i)
-            {
-                if (children_[i] == nullptr) continue;
+            uint64_t bitmap[4];
+            GetOccupancy(bitmap);
 
+            simd::ForEachChild(bitmap, from_key + 1, to_key, [&](const uint8_t i)
+            {
                 if (!IsLazyExpanded(children_[i]))
                 {
-                    auto p = children_[i]->GetFullRange();
+                    auto p = Untag(children_[i])->GetFullRange();
                     res.insert(res.end(), p.begin(), p.end());
                 }
                 else
-                    res.push_back(reinterpret_cast<uint64_t>(children_[i]) >> 32);
-            }
+                    res.push_back(GetLazyExpansion(children_[i]));
+            });
 
             if (children_[to_key] != nullptr)
             {
                 if (!IsLazyExpanded(children_[to_key]))
                 {
-                    auto p = children_[to_key]->GetUpperRange(to, offset - 8);
+                    auto p = Untag(children_[to_key])->GetUpperRange(to, offset - 8);
                     res.insert(res.end(), p.begin(), p.end());
                 }
                 else if (CmpLazyExpansion(children_[to_key], to) >= 0)
-                    res.push_back(reinterpret_cast<uint64_t>(children_[to_key]) >> 32);
+                    res.push_back(GetLazyExpansion(children_[to_key]));
             }
         }
         else
@@ -63,18 +76,19 @@ namespace art
             if (children_[from_key] == nullptr) return res;
 
             if (!IsLazyExpanded(children_[to_key]))
-                return children_[from_key]->GetRange(from, to, offset - 8);
+                return Untag(children_[from_key])->GetRange(from, to, offset - 8);
 
             if (CmpLazyExpansion(children_[from_key], from) <= 0 && CmpLazyExpansion(children_[from_key], to) >= 0)
-                res.push_back(reinterpret_cast<uint64_t>(children_[to_key]) >> 32);
+                res.push_back(GetLazyExpansion(children_[to_key]));
         }
 
         return res;
     }
 
-    std::vector<uint32_t> Node256::GetLowerRange(const uint32_t from, const int offset) const
+    template <class Config>
+    std::vector<typename Config::Key> Node256<Config>::GetLowerRange(const Key from, const int offset) const
     {
-        std::vector<uint32_t> res;
+        std::vector<Key> res;
 
         const uint8_t from_key = from >> offset & 0xFF;
 
@@ -82,83 +96,106 @@ namespace art
         {
             if (!IsLazyExpanded(children_[from_key]))
             {
-                auto p = children_[from_key]->GetLowerRange(from, offset - 8);
+                auto p = Untag(children_[from_key])->GetLowerRange(from, offset - 8);
                 res.insert(res.end(), p.begin(), p.end());
             }
             else if (CmpLazyExpansion(children_[from_key], from) <= 0)
-                res.push_back(reinterpret_cast<uint64_t>(children_[from_key]) >> 32);
+                res.push_back(GetLazyExpansion(children_[from_key]));
         }
 
-        for (uint16_t i = from_key + 1; i < 256; ++i)
-        {
-            if (children_[i] == nullptr) continue;
+        uint64_t bitmap[4];
+        GetOccupancy(bitmap);
 
+        simd::ForEachChild(bitmap, from_key + 1, 256, [&](const uint8_t i)
+        {
             if (!IsLazyExpanded(children_[i]))
             {
-                auto p = children_[i]->GetFullRange();
+                auto p = Untag(children_[i])->GetFullRange();
                 res.insert(res.end(), p.begin(), p.end());
             }
             else
-                res.push_back(reinterpret_cast<uint64_t>(children_[i]) >> 32);
-        }
+                res.push_back(GetLazyExpansion(children_[i]));
+        });
 
         return res;
     }
 
-    std::vector<uint32_t> Node256::GetUpperRange(const uint32_t to, const int offset) const
+    template <class Config>
+    std::vector<typename Config::Key> Node256<Config>::GetUpperRange(const Key to, const int offset) const
     {
-        std::vector<uint32_t> res;
+        std::vector<Key> res;
 
         const uint8_t to_key = to >> offset & 0xFF;
 
-        for (uint16_t i = 0; i < to_key; ++i)
-        {
-            if (children_[i] == nullptr) continue;
+        uint64_t bitmap[4];
+        GetOccupancy(bitmap);
 
+        simd::ForEachChild(bitmap, 0, to_key, [&](const uint8_t i)
+        {
             if (!IsLazyExpanded(children_[i]))
             {
-                auto p = children_[i]->GetFullRange();
+                auto p = Untag(children_[i])->GetFullRange();
                 res.insert(res.end(), p.begin(), p.end());
             }
             else
-                res.push_back(reinterpret_cast<uint64_t>(children_[i]) >> 32);
-        }
+                res.push_back(GetLazyExpansion(children_[i]));
+        });
 
         if (children_[to_key] != nullptr)
         {
             if (!IsLazyExpanded(children_[to_key]))
             {
-                auto p = children_[to_key]->GetUpperRange(to, offset - 8);
+                auto p = Untag(children_[to_key])->GetUpperRange(to, offset - 8);
                 res.insert(res.end(), p.begin(), p.end());
             }
             else if (CmpLazyExpansion(children_[to_key], to) >= 0)
-                res.push_back(reinterpret_cast<uint64_t>(children_[to_key]) >> 32);
+                res.push_back(GetLazyExpansion(children_[to_key]));
         }
 
         return res;
     }
 
-    std::vector<uint32_t> Node256::GetFullRange() const
+    template <class Config>
+    std::vector<typename Config::Key> Node256<Config>::GetFullRange() const
     {
-        std::vector<uint32_t> res;
+        std::vector<Key> res;
 
-        for (uint16_t i = 0; i < 256; ++i)
-        {
-            if (children_[i] == nullptr) continue;
+        uint64_t bitmap[4];
+        GetOccupancy(bitmap);
 
+        simd::ForEachChild(bitmap, 0, 256, [&](const uint8_t i)
+        {
             if (!IsLazyExpanded(children_[i]))
             {
-                auto p = children_[i]->GetFullRange();
+                auto p = Untag(children_[i])->GetFullRange();
                 res.insert(res.end(), p.begin(), p.end());
             }
             else
-                res.push_back(reinterpret_cast<uint64_t>(children_[i]) >> 32);
-        }
+                res.push_back(GetLazyExpansion(children_[i]));
+        });
 
         return res;
     }
 
-    void Node256::PrintTree(const int depth) const
+    template <class Config>
+    std::vector<std::pair<uint8_t, Node<Config>*>> Node256<Config>::GetChildren(const uint8_t from_key,
+                                                                                const uint8_t to_key) const
+    {
+        std::vector<std::pair<uint8_t, Node*>> res;
+
+        uint64_t bitmap[4];
+        GetOccupancy(bitmap);
+
+        simd::ForEachChild(bitmap, from_key, to_key + 1, [&](const uint8_t i)
+        {
+            res.emplace_back(i, children_[i]);
+        });
+
+        return res;
+    }
+
+    template <class Config>
+    void Node256<Config>::PrintTree(const int depth) const
     {
         std::cout << "|";
         for (int i = 0; i < depth; ++i)
@@ -173,20 +210,25 @@ namespace art
         for (int i = 0; i < 256; ++i)
         {
             if (children_[i] == nullptr || Node::IsLazyExpanded(children_[i])) continue;
-            children_[i]->PrintTree(depth + 1);
+            Untag(children_[i])->PrintTree(depth + 1);
         }
     }
 
-    void Node256::Destruct()
+    template <class Config>
+    void Node256<Config>::Destruct()
     {
         // Destruct children
         for (auto& i : children_)
         {
             if (i == nullptr || IsLazyExpanded(i)) continue;
-            i->Destruct();
+            Untag(i)->Destruct();
         }
 
         // suicide :/
-        delete this;
+        Node::Free(this);
     }
+
+#define ART_INSTANTIATE_NODE(Key, Dispatch) template class Node256<TreeConfig<Key, Dispatch>>;
+
+    ART_FOR_EACH_CONFIG(ART_INSTANTIATE_NODE)
 }
@@ -1,58 +1,25 @@
 #include "node.h"
 
-#include <cstring>
+#include "simd.h"
 
 namespace art
 {
-    Node* Node4::Insert(const uint8_t partial_key, Node* child_node)
+    template <class Config>
+    std::vector<typename Config::Key> Node4<Config>::GetRange(const Key from, const Key to, const int offset) const
     {
-        if (IsFull())
-        {
-            auto new_node = new Node16();
-
-            memmove(new_node->keys_, keys_, 4);
-            memmove(new_node->children_, children_, sizeof(uint64_t) * 4);
-            new_node->child_count_ = 4;
-
-            return new_node->Insert(partial_key, child_node);
-        }
-
-        // find position to insert new partial key (sorted in ascending order)
-        uint8_t pos{0};
-        for (; keys_[pos] < partial_key && pos < child_count_; ++pos);
-
-        // move everything from pos
-        memmove(keys_ + pos + 1, keys_ + pos, child_count_ - pos);
-        memmove(children_ + pos + 1, children_ + pos, (child_count_ - pos) * sizeof(uint64_t));
-
-        // insert
-        keys_[pos] = partial_key;
-        children_[pos] = child_node;
-        ++child_count_;
-
-        return this;
-    }
-
-    Node*& Node4::FindChild(const uint8_t partial_key)
-    {
-        for (uint8_t i = 0; i < child_count_; ++i)
-            if (keys_[i] == partial_key)
-                return children_[i];
-
-        return null_node;
-    }
-
-    std::vector<uint32_t> Node4::GetRange(const uint32_t from, const uint32_t to, const int offset) const
-    {
-        std::vector<uint32_t> res;
+        std::vector<Key> res;
 
         const uint8_t from_key = from >> offset & 0xFF;
         const uint8_t to_key = to >> offset & 0xFF;
 
-        uint8_t i = 0;
-        for (; i < child_count_ && keys_[i] < from_key; ++i);
+        // find the first key greater or equal to the from key
+        const uint32_t cmp_mask = simd::Node4GreaterEqual(keys_, from_key, child_count_);
 
-        if (i == child_count_ || keys_[i] > to_key) return res;
+        if (!cmp_mask) return res;
+
+        uint8_t i = __ctz(cmp_mask) >> 3;
+
+        if (keys_[i] > to_key) return res;
 
         if (from_key != to_key)
         {
@@ -60,11 +27,11 @@ namespace art
             {
                 if (!IsLazyExpanded(children_[i]))
                 {
-                    auto p = children_[i]->GetLowerRange(from, offset - 8);
+                    auto p = Untag(children_[i])->GetLowerRange(from, offset - 8);
                     res.insert(res.end(), p.begin(), p.end());
                 }
                 else if (CmpLazyExpansion(children_[i], from) <= 0)
-                    res.push_back(reinterpret_cast<uint64_t>(children_[i]) >> 32);
+                    res.push_back(GetLazyExpansion(children_[i]));
                 ++i;
             }
 
@@ -72,56 +39,59 @@ namespace art
             {
                 if (!IsLazyExpanded(children_[i]))
                 {
-                    auto p = children_[i]->GetFullRange();
+                    auto p = Untag(children_[i])->GetFullRange();
                     res.insert(res.end(), p.begin(), p.end());
                 }
                 else
-                    res.push_back(reinterpret_cast<uint64_t>(children_[i]) >> 32);
+                    res.push_back(GetLazyExpansion(children_[i]));
             }
 
             if (i < child_count_ && keys_[i] == to_key)
             {
                 if (!IsLazyExpanded(children_[i]))
                 {
-                    auto p = children_[i]->GetUpperRange(to, offset - 8);
+                    auto p = Untag(children_[i])->GetUpperRange(to, offset - 8);
                     res.insert(res.end(), p.begin(), p.end());
                 }
                 else if (CmpLazyExpansion(children_[i], to) >= 0)
-                    res.push_back(reinterpret_cast<uint64_t>(children_[i]) >> 32);
+                    res.push_back(GetLazyExpansion(children_[i]));
             }
         }
         else
         {
             if (!IsLazyExpanded(children_[i]))
-                return children_[i]->GetRange(from, to, offset - 8);
+                return Untag(children_[i])->GetRange(from, to, offset - 8);
 
             if (CmpLazyExpansion(children_[i], from) <= 0 && CmpLazyExpansion(children_[i], to) >= 0)
-                res.push_back(reinterpret_cast<uint64_t>(children_[i]) >> 32);
+                res.push_back(GetLazyExpansion(children_[i]));
         }
 
         return res;
     }
 
-    std::vector<uint32_t> Node4::GetLowerRange(const uint32_t from, const int offset) const
+    template <class Config>
+    std::vector<typename Config::Key> Node4<Config>::GetLowerRange(const Key from, const int offset) const
     {
-        std::vector<uint32_t> res;
+        std::vector<Key> res;
 
         const uint8_t from_key = from >> offset & 0xFF;
 
-        uint8_t i = 0;
-        for (; i < child_count_ && keys_[i] < from_key; ++i);
+        // find the first key greater or equal to the from key
+        const uint32_t cmp_mask = simd::Node4GreaterEqual(keys_, from_key, child_count_);
+
+        if (!cmp_mask) return res;
 
-        if (i == child_count_) return res;
+        uint8_t i = __ctz(cmp_mask) >> 3;
 
         if (keys_[i] == from_key)
         {
             if (!IsLazyExpanded(children_[i]))
             {
-                auto p = children_[i]->GetLowerRange(from, offset - 8);
+                auto p = Untag(children_[i])->GetLowerRange(from, offset - 8);
                 res.insert(res.end(), p.begin(), p.end());
             }
             else if (CmpLazyExpansion(children_[i], from) <= 0)
-                res.push_back(reinterpret_cast<uint64_t>(children_[i]) >> 32);
+                res.push_back(GetLazyExpansion(children_[i]));
             ++i;
         }
 
@@ -129,19 +99,20 @@ namespace art
         {
             if (!IsLazyExpanded(children_[i]))
             {
-                auto p = children_[i]->GetFullRange();
+                auto p = Untag(children_[i])->GetFullRange();
                 res.insert(res.end(), p.begin(), p.end());
             }
             else
-                res.push_back(reinterpret_cast<uint64_t>(children_[i]) >> 32);
+                res.push_back(GetLazyExpansion(children_[i]));
         }
 
         return res;
     }
 
-    std::vector<uint32_t> Node4::GetUpperRange(const uint32_t to, const int offset) const
+    template <class Config>
+    std::vector<typename Config::Key> Node4<Config>::GetUpperRange(const Key to, const int offset) const
     {
-        std::vector<uint32_t> res;
+        std::vector<Key> res;
 
         const uint8_t to_key = to >> offset & 0xFF;
 
@@ -153,38 +124,39 @@ namespace art
         {
             if (!IsLazyExpanded(children_[i]))
             {
-                auto p = children_[i]->GetFullRange();
+                auto p = Untag(children_[i])->GetFullRange();
                 res.insert(res.end(), p.begin(), p.end());
             }
             else
-                res.push_back(reinterpret_cast<uint64_t>(children_[i]) >> 32);
+                res.push_back(GetLazyExpansion(children_[i]));
         }
 
         if (i < child_count_ && keys_[i] == to_key)
         {
             if (!IsLazyExpanded(children_[i]))
             {
-                auto p = children_[i]->GetUpperRange(to, offset - 8);
+                auto p = Untag(children_[i])->GetUpperRange(to, offset - 8);
                 res.insert(res.end(), p.begin(), p.end());
             }
             else if (CmpLazyExpansion(children_[i], to) >= 0)
-                res.push_back(reinterpret_cast<uint64_t>(children_[i]) >> 32);
+                res.push_back(GetLazyExpansion(children_[i]));
         }
 
         return res;
     }
 
-    std::vector<uint32_t> Node4::GetFullRange() const
+    template <class Config>
+    std::vector<typename Config::Key> Node4<Config>::GetFullRange() const
     {
-        std::vector<uint32_t> res;
+        std::vector<Key> res;
 
         for (uint8_t i = 0; i < child_count_; ++i)
         {
             if (IsLazyExpanded(children_[i]))
-                res.push_back(reinterpret_cast<uint64_t>(children_[i]) >> 32);
+                res.push_back(GetLazyExpansion(children_[i]));
             else
             {
-                auto p = children_[i]->GetFullRange();
+                auto p = Untag(children_[i])->GetFullRange();
                 res.insert(res.end(), p.begin(), p.end());
             }
         }
@@ -192,7 +164,23 @@ namespace art
         return res;
     }
 
-    void Node4::PrintTree(const int depth) const
+    template <class Config>
+    std::vector<std::pair<uint8_t, Node<Config>*>> Node4<Config>::GetChildren(const uint8_t from_key,
+                                                                              const uint8_t to_key) const
+    {
+        std::vector<std::pair<uint8_t, Node*>> res;
+
+        for (uint8_t i = 0; i < child_count_ && keys_[i] <= to_key; ++i)
+        {
+            if (keys_[i] < from_key) continue;
+            res.emplace_back(keys_[i], children_[i]);
+        }
+
+        return res;
+    }
+
+    template <class Config>
+    void Node4<Config>::PrintTree(const int depth) const
     {
         std::cout << "|";
         for (int i = 0; i < depth; ++i)
@@ -214,20 +202,25 @@ namespace art
         for (uint8_t i = 0; i < child_count_; ++i)
         {
             if (Node::IsLazyExpanded(children_[i])) continue;
-            children_[i]->PrintTree(depth + 1);
+            Untag(children_[i])->PrintTree(depth + 1);
         }
     }
 
-    void Node4::Destruct()
+    template <class Config>
+    void Node4<Config>::Destruct()
     {
         // Destruct children
         for (int i = 0; i < child_count_; ++i)
         {
             if (IsLazyExpanded(children_[i])) continue;
-            children_[i]->Destruct();
+            Untag(children_[i])->Destruct();
         }
 
         // suicide :/
-        delete this;
+        Node::Free(this);
     }
+
+#define ART_INSTANTIATE_NODE(Key, Dispatch) template class Node4<TreeConfig<Key, Dispatch>>;
+
+    ART_FOR_EACH_CONFIG(ART_INSTANTIATE_NODE)
 }
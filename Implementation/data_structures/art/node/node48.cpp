@@ -1,50 +1,46 @@
 #include "node.h"
 
+#include <atomic>
+#include "simd.h"
+
 namespace art
 {
-    Node* Node48::Insert(const uint8_t partial_key, Node* child_node)
+    template <class Config>
+    Node<Config>* Node48<Config>::InsertConcurrent(const uint8_t partial_key, Node* child_node)
     {
-        if (IsFull())
-        {
-            auto new_node = new Node256();
-
-            for (uint16_t i = 0; i < 256; ++i)
-            {
-                if (keys_[i] == free_marker_) continue;
-
-                new_node->children_[i] = children_[keys_[i]];
-            }
-
-            new_node->child_count_ = 48;
-
-            return new_node->Insert(partial_key, child_node);
-        }
-
-        // insert
+        // without deletions the children are stored densely
+        const uint8_t index = child_count_;
 
-        // find next free index
-        int free_index = child_count_;
-        if (children_[free_index] != nullptr)
-            for (free_index = 0; free_index < 48 && children_[free_index] != nullptr; ++free_index);
-
-        keys_[partial_key] = free_index;
-        children_[free_index] = child_node;
+        // publish the child before its key so readers never see a key without its child
+        children_[index] = child_node;
+        std::atomic_ref(keys_[partial_key]).store(index, std::memory_order_release);
         ++child_count_;
 
         return this;
     }
 
-    Node*& Node48::FindChild(const uint8_t partial_key)
+    template <class Config>
+    Node<Config>* Node48<Config>::FindChildConcurrent(const uint8_t partial_key)
     {
-        if (keys_[partial_key] != free_marker_)
-            return children_[keys_[partial_key]];
+        const uint8_t index = std::atomic_ref(keys_[partial_key]).load(std::memory_order_acquire);
+
+        if (index == free_marker_)
+            return nullptr;
 
-        return null_node;
+        // acquire since the child might have been replaced in place (e.g. by a grown node)
+        return std::atomic_ref(children_[index]).load(std::memory_order_acquire);
+    }
+
+    template <class Config>
+    void Node48<Config>::GetOccupancy(uint64_t* bitmap) const
+    {
+        simd::scan_kernels.not_equal(keys_, free_marker_, bitmap);
     }
 
-    std::vector<uint32_t> Node48::GetRange(const uint32_t from, const uint32_t to, const int offset) const
+    template <class Config>
+    std::vector<typename Config::Key> Node48<Config>::GetRange(const Key from, const Key to, const int offset) const
     {
-        std::vector<uint32_t> res;
+        std::vector<Key> res;
 
         const uint8_t from_key = from >> offset & 0xFF;
         const uint8_t to_key = to >> offset & 0xFF;
@@ -55,35 +51,36 @@ namespace art
             {
                 if (!IsLazyExpanded(children_[keys_[from_key]]))
                 {
-                    auto p = children_[keys_[from_key]]->GetLowerRange(from, offset - 8);
+                    auto p = Untag(children_[keys_[from_key]])->GetLowerRange(from, offset - 8);
                     res.insert(res.end(), p.begin(), p.end());
                 }
                 else if (CmpLazyExpansion(children_[keys_[from_key]], from) <= 0)
-                    res.push_back(reinterpret_cast<uint64_t>(children_[keys_[from_key]]) >> 32);
+                    res.push_back(GetLazyExpansion(children_[keys_[from_key]]));
             }
 
-            for (uint16_t i = from_key + 1; i < to_key; ++i)
-            {
-                if (keys_[i] == free_marker_) continue;
+            uint64_t bitmap[4];
+            GetOccupancy(bitmap);
 
+            simd::ForEachChild(bitmap, from_key + 1, to_key, [&](const uint8_t i)
+            {
                 if (!IsLazyExpanded(children_[keys_[i]]))
                 {
-                    auto p = children_[keys_[i]]->GetFullRange();
+                    auto p = Untag(children_[keys_[i]])->GetFullRange();
                     res.insert(res.end(), p.begin(), p.end());
                 }
                 else
-                    res.push_back(reinterpret_cast<uint64_t>(children_[keys_[i]]) >> 32);
-            }
+                    res.push_back(GetLazyExpansion(children_[keys_[i]]));
+            });
 
             if (keys_[to_key] != free_marker_)
             {
                 if (!IsLazyExpanded(children_[keys_[to_key]]))
                 {
-                    auto p = children_[keys_[to_key]]->GetUpperRange(to, offset - 8);
+                    auto p = Untag(children_[keys_[to_key]])->GetUpperRange(to, offset - 8);
                     res.insert(res.end(), p.begin(), p.end());
                 }
                 else if (CmpLazyExpansion(children_[keys_[to_key]], to) >= 0)
-                    res.push_back(reinterpret_cast<uint64_t>(children_[keys_[to_key]]) >> 32);
+                    res.push_back(GetLazyExpansion(children_[keys_[to_key]]));
             }
         }
         else
@@ -91,18 +88,19 @@ namespace art
             if (keys_[from_key] == free_marker_) return res;
 
             if (!IsLazyExpanded(children_[keys_[from_key]]))
-                return children_[keys_[from_key]]->GetRange(from, to, offset - 8);
+                return Untag(children_[keys_[from_key]])->GetRange(from, to, offset - 8);
 
             if (CmpLazyExpansion(children_[keys_[from_key]], from) <= 0 && CmpLazyExpansion(children_[keys_[from_key]], to) >= 0)
-                res.push_back(reinterpret_cast<uint64_t>(children_[keys_[from_key]]) >> 32);
+                res.push_back(GetLazyExpansion(children_[keys_[from_key]]));
         }
 
         return res;
     }
 
-    std::vector<uint32_t> Node48::GetLowerRange(const uint32_t from, const int offset) const
+    template <class Config>
+    std::vector<typename Config::Key> Node48<Config>::GetLowerRange(const Key from, const int offset) const
     {
-        std::vector<uint32_t> res;
+        std::vector<Key> res;
 
         const uint8_t from_key = from >> offset & 0xFF;
 
@@ -110,83 +108,106 @@ namespace art
         {
             if (!IsLazyExpanded(children_[keys_[from_key]]))
             {
-                auto p = children_[keys_[from_key]]->GetLowerRange(from, offset - 8);
+                auto p = Untag(children_[keys_[from_key]])->GetLowerRange(from, offset - 8);
                 res.insert(res.end(), p.begin(), p.end());
             }
             else if (CmpLazyExpansion(children_[keys_[from_key]], from) <= 0)
-                res.push_back(reinterpret_cast<uint64_t>(children_[keys_[from_key]]) >> 32);
+                res.push_back(GetLazyExpansion(children_[keys_[from_key]]));
         }
 
-        for (uint16_t i = from_key + 1; i < 256; ++i)
-        {
-            if (keys_[i] == free_marker_) continue;
+        uint64_t bitmap[4];
+        GetOccupancy(bitmap);
 
+        simd::ForEachChild(bitmap, from_key + 1, 256, [&](const uint8_t i)
+        {
             if (!IsLazyExpanded(children_[keys_[i]]))
             {
-                auto p = children_[keys_[i]]->GetFullRange();
+                auto p = Untag(children_[keys_[i]])->GetFullRange();
                 res.insert(res.end(), p.begin(), p.end());
             }
             else
-                res.push_back(reinterpret_cast<uint64_t>(children_[keys_[i]]) >> 32);
-        }
+                res.push_back(GetLazyExpansion(children_[keys_[i]]));
+        });
 
         return res;
     }
 
-    std::vector<uint32_t> Node48::GetUpperRange(const uint32_t to, const int offset) const
+    template <class Config>
+    std::vector<typename Config::Key> Node48<Config>::GetUpperRange(const Key to, const int offset) const
     {
-        std::vector<uint32_t> res;
+        std::vector<Key> res;
 
         const uint8_t to_key = to >> offset & 0xFF;
 
-        for (uint16_t i = 0; i < to_key; ++i)
-        {
-            if (keys_[i] == free_marker_) continue;
+        uint64_t bitmap[4];
+        GetOccupancy(bitmap);
 
+        simd::ForEachChild(bitmap, 0, to_key, [&](const uint8_t i)
+        {
             if (!IsLazyExpanded(children_[keys_[i]]))
             {
-                auto p = children_[keys_[i]]->GetFullRange();
+                auto p = Untag(children_[keys_[i]])->GetFullRange();
                 res.insert(res.end(), p.begin(), p.end());
             }
             else
-                res.push_back(reinterpret_cast<uint64_t>(children_[keys_[i]]) >> 32);
-        }
+                res.push_back(GetLazyExpansion(children_[keys_[i]]));
+        });
 
         if (keys_[to_key] != free_marker_)
         {
             if (!IsLazyExpanded(children_[keys_[to_key]]))
             {
-                auto p = children_[keys_[to_key]]->GetUpperRange(to, offset - 8);
+                auto p = Untag(children_[keys_[to_key]])->GetUpperRange(to, offset - 8);
                 res.insert(res.end(), p.begin(), p.end());
             }
             else if (CmpLazyExpansion(children_[keys_[to_key]], to) >= 0)
-                res.push_back(reinterpret_cast<uint64_t>(children_[keys_[to_key]]) >> 32);
+                res.push_back(GetLazyExpansion(children_[keys_[to_key]]));
         }
 
         return res;
     }
 
-    std::vector<uint32_t> Node48::GetFullRange() const
+    template <class Config>
+    std::vector<typename Config::Key> Node48<Config>::GetFullRange() const
     {
-        std::vector<uint32_t> res;
+        std::vector<Key> res;
 
-        for (uint16_t i = 0; i < 256; ++i)
-        {
-            if (keys_[i] == free_marker_) continue;
+        uint64_t bitmap[4];
+        GetOccupancy(bitmap);
 
+        simd::ForEachChild(bitmap, 0, 256, [&](const uint8_t i)
+        {
             if (!IsLazyExpanded(children_[keys_[i]]))
             {
-                auto p = children_[keys_[i]]->GetFullRange();
+                auto p = Untag(children_[keys_[i]])->GetFullRange();
                 res.insert(res.end(), p.begin(), p.end());
             }
             else
-                res.push_back(reinterpret_cast<uint64_t>(children_[keys_[i]]) >> 32);
-        }
+                res.push_back(GetLazyExpansion(children_[keys_[i]]));
+        });
 
         return res;
     }
 
-    void Node48::PrintTree(const int depth) const
+    template <class Config>
+    std::vector<std::pair<uint8_t, Node<Config>*>> Node48<Config>::GetChildren(const uint8_t from_key,
+                                                                               const uint8_t to_key) const
+    {
+        std::vector<std::pair<uint8_t, Node*>> res;
+
+        uint64_t bitmap[4];
+        GetOccupancy(bitmap);
+
+        simd::ForEachChild(bitmap, from_key, to_key + 1, [&](const uint8_t i)
+        {
+            res.emplace_back(i, children_[keys_[i]]);
+        });
+
+        return res;
+    }
+
+    template <class Config>
+    void Node48<Config>::PrintTree(const int depth) const
     {
         std::cout << "|";
         for (int i = 0; i < depth; ++i)
@@ -211,21 +232,26 @@ namespace art
             if (keys_[i] != free_marker_)
             {
                 if (Node::IsLazyExpanded(children_[keys_[i]])) continue;
-                children_[keys_[i]]->PrintTree(depth + 1);
+                Untag(children_[keys_[i]])->PrintTree(depth + 1);
             }
         }
     }
 
-    void Node48::Destruct()
+    template <class Config>
+    void Node48<Config>::Destruct()
     {
         // Destruct children
         for (auto& i : children_)
         {
             if (i == nullptr || IsLazyExpanded(i)) continue;
-            i->Destruct();
+            Untag(i)->Destruct();
         }
 
         // suicide :/
-        delete this;
+        Node::Free(this);
     }
+
+#define ART_INSTANTIATE_NODE(Key, Dispatch) template class Node48<TreeConfig<Key, Dispatch>>;
+
+    ART_FOR_EACH_CONFIG(ART_INSTANTIATE_NODE)
 }
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include "../../../util.h"
+
+namespace art
+{
+    /**
+     * Properties of the key types a tree can store.
+     * Keys are unsigned integers which are split into 8 bit partial keys starting at the most significant byte.
+     *
+     * The number of levels is a compile-time constant so the traversals are unrolled (see Art::Find). The last level
+     * only stores full keys using combined value/pointer slots.
+     */
+    template <class Key>
+    struct KeyTraits;
+
+    template <>
+    struct KeyTraits<uint16_t>
+    {
+        // number of tree levels (one per byte)
+        static constexpr int kLevels = 2;
+        // shift of the partial key stored in the root
+        static constexpr int kRootOffset = 8;
+        // shift of a full key stored in a tagged pointer (the low 3 bits are the tag)
+        static constexpr int kLazyExpansionShift = 32;
+    };
+
+    template <>
+    struct KeyTraits<uint32_t>
+    {
+        static constexpr int kLevels = 4;
+        static constexpr int kRootOffset = 24;
+        static constexpr int kLazyExpansionShift = 32;
+    };
+
+    template <>
+    struct KeyTraits<uint64_t>
+    {
+        static constexpr int kLevels = 8;
+        static constexpr int kRootOffset = 56;
+        // a tagged pointer only has 61 bits left so the partial key of the root is dropped
+        // (it is known from the path to the tagged pointer)
+        static constexpr int kLazyExpansionShift = 8;
+    };
+
+    /**
+     * Dispatch policies decide how an operation called on a node header reaches the implementation of the actual
+     * node type. All policies share the same node implementations.
+     */
+
+    /**
+     * Every operation is a single out-of-line function switching over the node type stored in the header (the node
+     * implementations are inlined into it).
+     */
+    struct SwitchDispatch
+    {
+        static constexpr bool kVirtual = false;
+        static constexpr bool kTaggedChildren = false;
+
+        template <class Node, class F>
+        __noinline static decltype(auto) Dispatch(Node* node, F&& f)
+        {
+            return node->Visit(std::forward<F>(f));
+        }
+    };
+
+    /**
+     * The switch over the node type and the node implementation are inlined at every call site (static
+     * polymorphism without a vtable).
+     */
+    struct StaticDispatch
+    {
+        static constexpr bool kVirtual = false;
+        static constexpr bool kTaggedChildren = false;
+
+        template <class Node, class F>
+        __forceinline static decltype(auto) Dispatch(Node* node, F&& f)
+        {
+            return node->Visit(std::forward<F>(f));
+        }
+    };
+
+    /**
+     * Nodes derive from an abstract base class and operations are virtual calls.
+     * Every node additionally stores an 8 byte vtable pointer.
+     */
+    struct VirtualDispatch
+    {
+        static constexpr bool kVirtual = true;
+        static constexpr bool kTaggedChildren = false;
+    };
+
+    /**
+     * Like SwitchDispatch but pointers to child nodes (and the root) additionally store the node type in their low 3
+     * bits. Lookups select the kernel of the next node and prefetch its keys using the tag without waiting for its
+     * header (see Node::FindChildOf).
+     */
+    struct TaggedDispatch
+    {
+        static constexpr bool kVirtual = false;
+        static constexpr bool kTaggedChildren = true;
+
+        template <class Node, class F>
+        __noinline static decltype(auto) Dispatch(Node* node, F&& f)
+        {
+            return node->Visit(std::forward<F>(f));
+        }
+    };
+
+    /**
+     * Template arguments of a tree passed on to its nodes.
+     * The allocator is rebound to the node types and has to be default constructible.
+     */
+    template <class K, class D, class A = std::allocator<std::byte>>
+    struct TreeConfig
+    {
+        using Key = K;
+        using Dispatch = D;
+        using Allocator = A;
+    };
+
+    /**
+     * Invokes X(Key, Dispatch) for every dispatch policy or every configuration the nodes and the tree are compiled
+     * for. Their implementations are explicitly instantiated for these in their translation units.
+     */
+#define ART_FOR_EACH_DISPATCH(X, Key) \
+    X(Key, SwitchDispatch) \
+    X(Key, StaticDispatch) \
+    X(Key, VirtualDispatch) \
+    X(Key, TaggedDispatch)
+
+#define ART_FOR_EACH_CONFIG(X) \
+    ART_FOR_EACH_DISPATCH(X, uint16_t) \
+    ART_FOR_EACH_DISPATCH(X, uint32_t) \
+    ART_FOR_EACH_DISPATCH(X, uint64_t)
+}
@@ -0,0 +1,273 @@
+#include "simd.h"
+
+#include "../../../util.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace art::simd
+{
+    namespace
+    {
+        /**
+         * SSE2 (baseline of x86-64).
+         * There are no unsigned 8 bit comparisons so they are emulated via max (see util.h).
+         */
+        uint32_t EqualSse2(const uint8_t* keys, const uint8_t partial_key, const uint8_t count)
+        {
+            const __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8(partial_key), _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys)));
+            return _mm_movemask_epi8(cmp) & ((1 << count) - 1);
+        }
+
+        uint32_t GreaterSse2(const uint8_t* keys, const uint8_t partial_key, const uint8_t count)
+        {
+            const __m128i cmp = _mm_cmplt_epu8(_mm_set1_epi8(partial_key), _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys)));
+            return _mm_movemask_epi8(cmp) & ((1 << count) - 1);
+        }
+
+        uint32_t GreaterEqualSse2(const uint8_t* keys, const uint8_t partial_key, const uint8_t count)
+        {
+            const __m128i cmp = _mm_cmple_epu8(_mm_set1_epi8(partial_key), _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys)));
+            return _mm_movemask_epi8(cmp) & ((1 << count) - 1);
+        }
+
+        /**
+         * AVX2
+         * 16 keys fit into a single 128 bit register so this level only gains VEX encoded instructions
+         * (a broadcast for the partial key and no SSE/AVX transitions) and BMI2 for masking the key count.
+         */
+        __target("avx2,bmi2") uint32_t EqualAvx2(const uint8_t* keys, const uint8_t partial_key, const uint8_t count)
+        {
+            const __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8(partial_key), _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys)));
+            return _bzhi_u32(_mm_movemask_epi8(cmp), count);
+        }
+
+        __target("avx2,bmi2") uint32_t GreaterAvx2(const uint8_t* keys, const uint8_t partial_key, const uint8_t count)
+        {
+            const __m128i key_set = _mm_set1_epi8(partial_key);
+            const __m128i child_key_set = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys));
+            // keys[i] > key <=> min(keys[i], key) != keys[i]
+            const __m128i cmp = _mm_cmpeq_epi8(_mm_min_epu8(child_key_set, key_set), child_key_set);
+            return _bzhi_u32(~_mm_movemask_epi8(cmp), count);
+        }
+
+        __target("avx2,bmi2") uint32_t GreaterEqualAvx2(const uint8_t* keys, const uint8_t partial_key, const uint8_t count)
+        {
+            const __m128i key_set = _mm_set1_epi8(partial_key);
+            const __m128i child_key_set = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys));
+            // keys[i] >= key <=> max(keys[i], key) == keys[i]
+            const __m128i cmp = _mm_cmpeq_epi8(_mm_max_epu8(child_key_set, key_set), child_key_set);
+            return _bzhi_u32(_mm_movemask_epi8(cmp), count);
+        }
+
+        /**
+         * AVX-512 (BW + VL)
+         * Unsigned comparisons directly produce a bitmask and only compare the first count keys (mask register).
+         */
+        __target("avx512bw,avx512vl,bmi2") uint32_t EqualAvx512(const uint8_t* keys, const uint8_t partial_key, const uint8_t count)
+        {
+            const __mmask16 valid = _bzhi_u32(0xFFFF, count);
+            return _mm_mask_cmpeq_epu8_mask(valid, _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys)), _mm_set1_epi8(partial_key));
+        }
+
+        __target("avx512bw,avx512vl,bmi2") uint32_t GreaterAvx512(const uint8_t* keys, const uint8_t partial_key, const uint8_t count)
+        {
+            const __mmask16 valid = _bzhi_u32(0xFFFF, count);
+            return _mm_mask_cmpgt_epu8_mask(valid, _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys)), _mm_set1_epi8(partial_key));
+        }
+
+        __target("avx512bw,avx512vl,bmi2") uint32_t GreaterEqualAvx512(const uint8_t* keys, const uint8_t partial_key, const uint8_t count)
+        {
+            const __mmask16 valid = _bzhi_u32(0xFFFF, count);
+            return _mm_mask_cmpge_epu8_mask(valid, _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys)), _mm_set1_epi8(partial_key));
+        }
+
+        /**
+         * Occupancy bitmaps (see ScanKernels).
+         * The comparisons of a 64 slot word are combined from 16 (SSE2), 32 (AVX2) or 64 (AVX-512) byte masks
+         * and from 2, 4 or 8 pointer masks respectively.
+         */
+        void NotEqualSse2(const uint8_t* bytes, const uint8_t value, uint64_t* bitmap)
+        {
+            const __m128i value_set = _mm_set1_epi8(static_cast<char>(value));
+
+            for (int word = 0; word < 4; ++word)
+            {
+                uint64_t equal = 0;
+                for (int i = 0; i < 4; ++i)
+                {
+                    const __m128i cmp = _mm_cmpeq_epi8(value_set, _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + word * 64 + i * 16)));
+                    equal |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(cmp))) << i * 16;
+                }
+                bitmap[word] = ~equal;
+            }
+        }
+
+        void NonNullSse2(const void* const* pointers, uint64_t* bitmap)
+        {
+            const __m128i zero = _mm_setzero_si128();
+
+            for (int word = 0; word < 4; ++word)
+            {
+                uint64_t null = 0;
+                for (int i = 0; i < 32; ++i)
+                {
+                    const __m128i cmp = _mm_cmpeq_epi32(zero, _mm_loadu_si128(reinterpret_cast<const __m128i*>(pointers + word * 64 + i * 2)));
+                    // a pointer is null if both of its 32 bit halves are (there is no 64 bit comparison in SSE2)
+                    const __m128i cmp64 = _mm_and_si128(cmp, _mm_shuffle_epi32(cmp, _MM_SHUFFLE(2, 3, 0, 1)));
+                    null |= static_cast<uint64_t>(_mm_movemask_pd(_mm_castsi128_pd(cmp64))) << i * 2;
+                }
+                bitmap[word] = ~null;
+            }
+        }
+
+        __target("avx2,bmi2") void NotEqualAvx2(const uint8_t* bytes, const uint8_t value, uint64_t* bitmap)
+        {
+            const __m256i value_set = _mm256_set1_epi8(static_cast<char>(value));
+
+            for (int word = 0; word < 4; ++word)
+            {
+                const __m256i cmp_low = _mm256_cmpeq_epi8(value_set, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + word * 64)));
+                const __m256i cmp_high = _mm256_cmpeq_epi8(value_set, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + word * 64 + 32)));
+                bitmap[word] = ~(static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(cmp_high))) << 32 |
+                    static_cast<uint32_t>(_mm256_movemask_epi8(cmp_low)));
+            }
+        }
+
+        __target("avx2,bmi2") void NonNullAvx2(const void* const* pointers, uint64_t* bitmap)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+
+            for (int word = 0; word < 4; ++word)
+            {
+                uint64_t null = 0;
+                for (int i = 0; i < 16; ++i)
+                {
+                    const __m256i cmp = _mm256_cmpeq_epi64(zero, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pointers + word * 64 + i * 4)));
+                    null |= static_cast<uint64_t>(_mm256_movemask_pd(_mm256_castsi256_pd(cmp))) << i * 4;
+                }
+                bitmap[word] = ~null;
+            }
+        }
+
+        __target("avx512bw,avx512vl,bmi2") void NotEqualAvx512(const uint8_t* bytes, const uint8_t value, uint64_t* bitmap)
+        {
+            const __m512i value_set = _mm512_set1_epi8(static_cast<char>(value));
+
+            for (int word = 0; word < 4; ++word)
+                bitmap[word] = _mm512_cmpneq_epu8_mask(_mm512_loadu_si512(bytes + word * 64), value_set);
+        }
+
+        __target("avx512bw,avx512vl,bmi2") void NonNullAvx512(const void* const* pointers, uint64_t* bitmap)
+        {
+            for (int word = 0; word < 4; ++word)
+            {
+                uint64_t non_null = 0;
+                for (int i = 0; i < 8; ++i)
+                {
+                    const __m512i children = _mm512_loadu_si512(pointers + word * 64 + i * 8);
+                    non_null |= static_cast<uint64_t>(_mm512_test_epi64_mask(children, children)) << i * 8;
+                }
+                bitmap[word] = non_null;
+            }
+        }
+
+        constexpr Node16Kernels kKernels[] = {
+            {EqualSse2, GreaterSse2, GreaterEqualSse2},
+            {EqualAvx2, GreaterAvx2, GreaterEqualAvx2},
+            {EqualAvx512, GreaterAvx512, GreaterEqualAvx512}
+        };
+
+        constexpr ScanKernels kScanKernels[] = {
+            {NotEqualSse2, NonNullSse2},
+            {NotEqualAvx2, NonNullAvx2},
+            {NotEqualAvx512, NonNullAvx512}
+        };
+
+        Isa selected_isa = Isa::kSse2;
+
+        bool IsSupported(const Isa isa)
+        {
+            switch (isa)
+            {
+                case Isa::kSse2:
+                    return true;
+#ifdef __GNUC__
+                case Isa::kAvx2:
+                    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2");
+                case Isa::kAvx512:
+                    return __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("bmi2");
+#elif defined(_MSC_VER)
+                case Isa::kAvx2:
+                case Isa::kAvx512:
+                    {
+                        int info[4];
+                        __cpuid(info, 0);
+                        if (info[0] < 7) return false;
+
+                        // the OS has to save the AVX (and AVX-512) registers
+                        __cpuid(info, 1);
+                        if (!(info[2] & 1 << 27)) return false;
+                        const uint64_t xcr0 = _xgetbv(0);
+
+                        __cpuidex(info, 7, 0);
+                        const bool avx2 = info[1] & 1 << 5 && info[1] & 1 << 8 && (xcr0 & 0x6) == 0x6;
+                        if (isa == Isa::kAvx2) return avx2;
+
+                        return avx2 && info[1] & 1 << 30 && info[1] & 1 << 31 && (xcr0 & 0xE6) == 0xE6;
+                    }
+#endif
+            }
+
+            return false;
+        }
+
+        // select the best kernels before main (trees are never accessed during static initialization)
+        [[maybe_unused]] const bool initialized = SelectIsa(DetectIsa());
+    }
+
+    // starts with the baseline kernels so it is usable even before the dynamic initialization
+    constinit Node16Kernels node16_kernels = kKernels[0];
+    constinit ScanKernels scan_kernels = kScanKernels[0];
+
+    Isa DetectIsa()
+    {
+        if (IsSupported(Isa::kAvx512))
+            return Isa::kAvx512;
+        if (IsSupported(Isa::kAvx2))
+            return Isa::kAvx2;
+        return Isa::kSse2;
+    }
+
+    Isa GetIsa()
+    {
+        return selected_isa;
+    }
+
+    bool SelectIsa(const Isa isa)
+    {
+        if (!IsSupported(isa))
+            return false;
+
+        selected_isa = isa;
+        node16_kernels = kKernels[static_cast<uint8_t>(isa)];
+        scan_kernels = kScanKernels[static_cast<uint8_t>(isa)];
+        return true;
+    }
+
+    const char* GetIsaName(const Isa isa)
+    {
+        switch (isa)
+        {
+            case Isa::kSse2:
+                return "SSE2";
+            case Isa::kAvx2:
+                return "AVX2";
+            case Isa::kAvx512:
+                return "AVX-512";
+        }
+
+        __unreachable();
+    }
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include "../../../util.h"
+
+namespace art::simd
+{
+    /**
+     * Instruction set levels with their own Node16 and scan kernels.
+     */
+    enum class Isa : uint8_t
+    {
+        kSse2,
+        kAvx2,
+        kAvx512
+    };
+
+    /**
+     * Compares partial_key with the first count keys and returns a bitmask with bit i set if the comparison holds
+     * for keys[i]. keys has to be readable for 16 bytes.
+     */
+    using CompareKernel = uint32_t (*)(const uint8_t* keys, uint8_t partial_key, uint8_t count);
+
+    struct Node16Kernels
+    {
+        // keys[i] == partial_key (child lookup)
+        CompareKernel equal;
+        // keys[i] > partial_key (insert position)
+        CompareKernel greater;
+        // keys[i] >= partial_key (range start)
+        CompareKernel greater_equal;
+    };
+
+    /**
+     * Kernels of the selected instruction set.
+     * Initially the best instruction set supported by the CPU is selected (using cpuid).
+     */
+    extern Node16Kernels node16_kernels;
+
+    /**
+     * Kernels computing the 256 bit occupancy bitmap of the child slots of a Node48 or Node256.
+     * Bit i of bitmap[i / 64] is set if the child of partial key i exists.
+     */
+    struct ScanKernels
+    {
+        // bytes[i] != value (Node48 keys compared with the free marker)
+        void (*not_equal)(const uint8_t* bytes, uint8_t value, uint64_t* bitmap);
+        // pointers[i] != nullptr (Node256 children)
+        void (*non_null)(const void* const* pointers, uint64_t* bitmap);
+    };
+
+    extern ScanKernels scan_kernels;
+
+    /**
+     * Calls f(partial_key) for every set bit of an occupancy bitmap in [begin, end) in ascending order until f
+     * returns false. Returns false if f did.
+     */
+    template <class F>
+    bool ForEachChildUntil(const uint64_t* bitmap, const uint16_t begin, const uint16_t end, F&& f)
+    {
+        if (begin >= end) return true;
+
+        const uint16_t first = begin >> 6;
+        const uint16_t last = (end - 1) >> 6;
+
+        for (uint16_t word = first; word <= last; ++word)
+        {
+            uint64_t bits = bitmap[word];
+
+            if (word == first)
+                bits &= ~static_cast<uint64_t>(0) << (begin & 63);
+            if (word == last)
+                bits &= ~static_cast<uint64_t>(0) >> (63 - ((end - 1) & 63));
+
+            for (; bits; bits &= bits - 1)
+                if (!f(static_cast<uint8_t>(word << 6 | __ctz64(bits))))
+                    return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Calls f(partial_key) for every set bit of an occupancy bitmap in [begin, end) in ascending order.
+     * Scans therefore jump straight to the existing children instead of checking every slot.
+     */
+    template <class F>
+    void ForEachChild(const uint64_t* bitmap, const uint16_t begin, const uint16_t end, F&& f)
+    {
+        ForEachChildUntil(bitmap, begin, end, [&](const uint8_t partial_key)
+        {
+            f(partial_key);
+            return true;
+        });
+    }
+
+    /**
+     * Returns the best instruction set supported by the CPU.
+     */
+    Isa DetectIsa();
+
+    /**
+     * Returns the currently selected instruction set.
+     */
+    Isa GetIsa();
+
+    /**
+     * Selects the kernels of an instruction set. Returns false (keeping the current selection) if the CPU doesn't
+     * support it. Must not be called while a tree is accessed concurrently.
+     */
+    bool SelectIsa(Isa isa);
+
+    const char* GetIsaName(Isa isa);
+
+    // ================================================================
+    //                      Node4 (SWAR)
+    // ================================================================
+
+    /**
+     * Branch-free SWAR (SIMD within a register) kernels for the 4 keys of a Node4 loaded as a single 32 bit word.
+     *
+     * Like the Node16 kernels they compare partial_key with the first count keys but return a mask with the most
+     * significant bit of byte i set if the comparison holds for keys[i], so the position is __ctz(mask) >> 3
+     * (little-endian). keys has to be readable for 4 bytes.
+     */
+    namespace swar
+    {
+        constexpr uint32_t kLow = 0x01010101;
+        constexpr uint32_t kHigh = 0x80808080;
+
+        inline uint32_t LoadKeys(const uint8_t* keys)
+        {
+            uint32_t word;
+            memcpy(&word, keys, sizeof(word));
+            return word;
+        }
+
+        // high bits of the first count bytes
+        inline uint32_t CountMask(const uint8_t count)
+        {
+            return static_cast<uint32_t>((static_cast<uint64_t>(1) << count * 8) - 1) & kHigh;
+        }
+
+        // high bit of every byte of a that is greater or equal to the byte of b (unsigned)
+        inline uint32_t GreaterEqual(const uint32_t a, const uint32_t b)
+        {
+            // compare the low 7 bits (setting the high bit of a prevents borrows between the bytes)
+            const uint32_t low = (a | kHigh) - (b & ~kHigh);
+            // a >= b if a's high bit is set and b's isn't or both are equal and the low 7 bits decide
+            return ((a & ~b) | (~(a ^ b) & low)) & kHigh;
+        }
+    }
+
+    inline uint32_t Node4Equal(const uint8_t* keys, const uint8_t partial_key, const uint8_t count)
+    {
+        // bytes equal to the partial key become 0 which is detected without carries between the bytes
+        const uint32_t x = swar::LoadKeys(keys) ^ partial_key * swar::kLow;
+        return ~(((x & ~swar::kHigh) + ~swar::kHigh) | x) & swar::CountMask(count);
+    }
+
+    inline uint32_t Node4Greater(const uint8_t* keys, const uint8_t partial_key, const uint8_t count)
+    {
+        // keys[i] > partial_key <=> !(partial_key >= keys[i])
+        return ~swar::GreaterEqual(partial_key * swar::kLow, swar::LoadKeys(keys)) & swar::CountMask(count);
+    }
+
+    inline uint32_t Node4GreaterEqual(const uint8_t* keys, const uint8_t partial_key, const uint8_t count)
+    {
+        return swar::GreaterEqual(swar::LoadKeys(keys), partial_key * swar::kLow) & swar::CountMask(count);
+    }
+}
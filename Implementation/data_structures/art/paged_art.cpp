@@ -0,0 +1,763 @@
+#include "paged_art.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include "image.h"
+
+/**
+ * Page layout (native byte order, kPageSize bytes):
+ *
+ *  header:     PageHeader at offset 0
+ *  nodes:      subtrees in the node layout of image.h, offsets relative to the start of the page
+ *  entries:    PageEntry of subtree i at kPageSize - (i + 1) * sizeof(PageEntry), growing towards the nodes
+ *
+ * Slots of upper nodes referring to a subtree in a page:
+ *  - swizzled:   address of its PageEntry in the cached page | 5
+ *  - unswizzled: page ID << 13 | entry index << 3 | 6
+ *
+ * The entries of a page keep their index (and address) until the page is rewritten, so swizzled slots stay valid
+ * while the page is cached. Every subtree stores at least two keys, single keys are stored in the upper slots.
+ */
+namespace art
+{
+    namespace
+    {
+        constexpr uint64_t kFrameTag = 5;
+        constexpr uint64_t kPageTag = 6;
+
+        constexpr int kEntryShift = 3;
+        constexpr uint64_t kEntryMask = 0x3FF;
+        constexpr int kPageShift = 13;
+
+        constexpr uint64_t kNoPage = ~uint64_t{0};
+        constexpr uint32_t kNoFrame = ~uint32_t{0};
+
+        // inserts collected in a cached page before it is rewritten
+        constexpr size_t kPendingLimit = 64;
+
+        // alignment of buffers, offsets and sizes for direct I/O
+        constexpr size_t kDirectIoAlignment = 4096;
+
+        struct PageHeader
+        {
+            uint32_t entry_count;
+            // bytes used by the header and the nodes
+            uint32_t size;
+        };
+
+        /**
+         * Writes nodes into a page up to a limit. Writes beyond the limit are only counted so the caller can detect
+         * that the nodes don't fit.
+         */
+        struct PageWriter
+        {
+            std::byte* data;
+            uint64_t position;
+            uint64_t limit;
+
+            uint64_t Position() const
+            {
+                return position;
+            }
+
+            template <class T>
+            void Write(const T& value)
+            {
+                if (position + sizeof(T) <= limit)
+                    memcpy(data + position, &value, sizeof(T));
+                position += sizeof(T);
+            }
+        };
+
+        inline uint64_t GetTag(const void* slot)
+        {
+            return reinterpret_cast<uint64_t>(slot) & image::kTagMask;
+        }
+
+        /**
+         * Returns the mask of the key bits below the root of a subtree at offset.
+         */
+        template <class Key>
+        Key GetSubtreeMask(const int offset)
+        {
+            return static_cast<Key>((uint64_t{1} << (offset + 8)) - 1);
+        }
+    }
+
+    template <class Key>
+    struct PagedArt<Key>::PageEntry
+    {
+        // key bits above the root of the subtree
+        uint64_t prefix;
+        // reference to the root node (always a node, see image.h)
+        uint32_t root;
+        int32_t offset;
+    };
+
+    namespace
+    {
+        template <class Entry>
+        Entry* GetEntry(std::byte* page, const uint64_t index)
+        {
+            return reinterpret_cast<Entry*>(page + PagedArt<>::kPageSize) - (index + 1);
+        }
+    }
+
+    template <class Key>
+    PagedArt<Key>::~PagedArt()
+    {
+        Close();
+    }
+
+    template <class Key>
+    bool PagedArt<Key>::Open(const std::string& path, const size_t memory_budget, const bool direct_io)
+    {
+        Close();
+
+        int fd = -1;
+#ifdef O_DIRECT
+        if (direct_io)
+            fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+#endif
+        // not every file system supports direct I/O (e.g. tmpfs)
+        if (fd < 0)
+            fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+            return false;
+
+        // the file lives as long as it is open
+        unlink(path.c_str());
+        fd_ = fd;
+
+        const size_t frame_count = std::max<size_t>(memory_budget / kPageSize, 2);
+        memory_.resize((frame_count + 1) * kPageSize + kDirectIoAlignment);
+        const auto address = reinterpret_cast<uintptr_t>(memory_.data());
+        pool_ = memory_.data() + ((kDirectIoAlignment - address % kDirectIoAlignment) % kDirectIoAlignment);
+        packed_ = pool_ + frame_count * kPageSize;
+
+        frames_.assign(frame_count, Frame{kNoPage, {}, false, false});
+        clock_hand_ = 0;
+
+        root_ = Node::Create(0);
+        size_ = 0;
+        failed_ = false;
+        statistics_ = {};
+
+        return true;
+    }
+
+    template <class Key>
+    void PagedArt<Key>::Close()
+    {
+        if (fd_ < 0)
+            return;
+
+        Free(root_);
+        root_ = nullptr;
+        size_ = 0;
+
+        close(fd_);
+        fd_ = -1;
+
+        std::vector<std::byte>().swap(memory_);
+        pool_ = packed_ = nullptr;
+        frames_.clear();
+        page_table_.clear();
+        free_pages_.clear();
+    }
+
+    template <class Key>
+    bool PagedArt<Key>::Build(const std::span<const Key> keys)
+    {
+        Free(root_);
+        // none of the old pages are needed anymore
+        failed_ = false;
+
+        for (Frame& frame : frames_)
+            frame = Frame{kNoPage, {}, false, false};
+        page_table_.clear();
+        free_pages_.clear();
+
+        BeginPacking(AllocatePage(), nullptr);
+        root_ = PlaceChildren(0, KeyTraits<Key>::kRootOffset, keys);
+        FlushPage(false);
+
+        size_ = keys.size();
+
+        return !failed_;
+    }
+
+    template <class Key>
+    bool PagedArt<Key>::Insert(const Key value)
+    {
+        if (failed_)
+            return false;
+
+        Node** node_ref = &root_;
+        Node* node = root_;
+
+        for (int offset = KeyTraits<Key>::kRootOffset;; offset -= 8)
+        {
+            const uint8_t partial_key = value >> offset & 0xFF;
+            Node*& slot = node->FindChild(partial_key);
+
+            if (slot == nullptr)
+            {
+                Node* new_node = node->Insert(partial_key, reinterpret_cast<Node*>(image::EncodeKey(value)));
+                if (new_node != node)
+                {
+                    node->Delete();
+                    *node_ref = new_node;
+                }
+                break;
+            }
+
+            switch (GetTag(slot))
+            {
+                case 0:
+                    node_ref = &slot;
+                    node = slot;
+                    continue;
+                case image::kTagMask:
+                    {
+                        const Key key = image::DecodeKey(reinterpret_cast<uint64_t>(slot), value);
+                        if (key == value)
+                            return true;
+
+                        // the last level never has two keys with the same partial key
+                        const Key keys[2]{std::min(key, value), std::max(key, value)};
+                        AddSubtree(node, partial_key, offset - 8, keys);
+                        break;
+                    }
+                default:
+                    {
+                        const PageEntry* entry = Fix(slot);
+                        if (entry == nullptr)
+                            return false;
+
+                        if (FindInPage(entry, value))
+                            return true;
+
+                        Frame& frame = GetFrame(entry);
+                        frame.pending.insert(std::ranges::upper_bound(frame.pending, value), value);
+                        if (frame.pending.size() >= kPendingLimit)
+                            Rewrite(&frame, true);
+                        break;
+                    }
+            }
+
+            break;
+        }
+
+        ++size_;
+
+        // writing the pages of a rewritten or evicted page might have failed
+        return !failed_;
+    }
+
+    template <class Key>
+    std::optional<bool> PagedArt<Key>::Find(const Key value)
+    {
+        if (failed_)
+            return std::nullopt;
+
+        Node* node = root_;
+
+        for (int offset = KeyTraits<Key>::kRootOffset;; offset -= 8)
+        {
+            Node*& slot = node->FindChild(value >> offset & 0xFF);
+
+            switch (GetTag(slot))
+            {
+                case 0:
+                    if (slot == nullptr)
+                        return false;
+                    node = slot;
+                    break;
+                case image::kTagMask:
+                    return image::DecodeKey(reinterpret_cast<uint64_t>(slot), value) == value;
+                default:
+                    {
+                        const PageEntry* entry = Fix(slot);
+                        if (entry == nullptr)
+                            return std::nullopt;
+
+                        return FindInPage(entry, value);
+                    }
+            }
+        }
+    }
+
+    template <class Key>
+    std::optional<std::vector<Key>> PagedArt<Key>::FindRange(const Key from, const Key to)
+    {
+        if (failed_)
+            return std::nullopt;
+
+        std::vector<Key> result;
+        if (from <= to && !ScanRange(root_, KeyTraits<Key>::kRootOffset, from, to, 0, true, true, result))
+            return std::nullopt;
+
+        return result;
+    }
+
+    template <class Key>
+    bool PagedArt<Key>::ScanRange(Node* node, const int offset, const Key from, const Key to, const Key path,
+                                  const bool lower, const bool upper, std::vector<Key>& result)
+    {
+        const uint8_t begin = lower ? from >> offset & 0xFF : 0x00;
+        const uint8_t end = upper ? to >> offset & 0xFF : 0xFF;
+
+        for (const auto& [partial_key, child] : node->GetChildren(begin, end))
+        {
+            // reading a page can rewrite the subtrees of an evicted one, so the slot is looked up again
+            Node*& slot = node->FindChild(partial_key);
+            const Key child_path = path | static_cast<Key>(static_cast<Key>(partial_key) << offset);
+            const bool child_lower = lower && partial_key == begin;
+            const bool child_upper = upper && partial_key == end;
+
+            switch (GetTag(slot))
+            {
+                case 0:
+                    if (!ScanRange(slot, offset - 8, from, to, child_path, child_lower, child_upper, result))
+                        return false;
+                    break;
+                case image::kTagMask:
+                    {
+                        const Key key = image::DecodeKey(reinterpret_cast<uint64_t>(slot), child_path);
+                        if (key >= from && key <= to)
+                            result.push_back(key);
+                        break;
+                    }
+                default:
+                    {
+                        const PageEntry* entry = Fix(slot);
+                        if (entry == nullptr)
+                            return false;
+
+                        Frame& frame = GetFrame(entry);
+                        const size_t middle = result.size();
+
+                        image::Scan(GetData(&frame), entry->root, from, to, entry->offset, child_path, child_lower,
+                                    child_upper, [&](const Key key)
+                                    {
+                                        result.push_back(key);
+                                        return true;
+                                    });
+
+                        // the pending inserts of the subtree are merged in
+                        const Key last = child_path | GetSubtreeMask<Key>(entry->offset);
+                        const auto first_pending = std::ranges::lower_bound(frame.pending, std::max(from, child_path));
+                        const auto last_pending = std::ranges::upper_bound(frame.pending, std::min(to, last));
+                        if (first_pending < last_pending)
+                        {
+                            result.insert(result.end(), first_pending, last_pending);
+                            std::inplace_merge(result.begin() + middle, result.end() - (last_pending - first_pending),
+                                               result.end());
+                        }
+                        break;
+                    }
+            }
+        }
+
+        return true;
+    }
+
+    template <class Key>
+    typename PagedArt<Key>::Frame& PagedArt<Key>::GetFrame(const PageEntry* entry)
+    {
+        return frames_[(reinterpret_cast<const std::byte*>(entry) - pool_) / kPageSize];
+    }
+
+    template <class Key>
+    bool PagedArt<Key>::FindInPage(const PageEntry* entry, const Key value)
+    {
+        const Frame& frame = GetFrame(entry);
+        const std::byte* page = GetData(&frame);
+
+        uint64_t ref = entry->root;
+        for (int offset = entry->offset;; offset -= 8)
+        {
+            ref = image::FindChild(page, ref, value >> offset & 0xFF);
+
+            if (ref == 0)
+                break;
+
+            if (image::IsKey(ref))
+            {
+                if (image::DecodeKey(ref, value) == value)
+                    return true;
+                break;
+            }
+        }
+
+        return std::ranges::binary_search(frame.pending, value);
+    }
+
+    template <class Key>
+    const typename PagedArt<Key>::PageEntry* PagedArt<Key>::Fix(Node*& slot)
+    {
+        const auto ref = reinterpret_cast<uint64_t>(slot);
+
+        if (GetTag(slot) == kFrameTag)
+        {
+            const auto entry = reinterpret_cast<const PageEntry*>(ref & ~image::kTagMask);
+            GetFrame(entry).referenced = true;
+            return entry;
+        }
+
+        // another subtree of the page might have read it already
+        const uint64_t page_id = ref >> kPageShift;
+        if (page_table_[page_id] == kNoFrame)
+        {
+            // the frame stays empty if the page couldn't be read
+            Frame* frame = AllocateFrame();
+            if (!ReadPage(page_id, GetData(frame)) || failed_)
+                return nullptr;
+
+            frame->page_id = page_id;
+            frame->dirty = false;
+            page_table_[page_id] = frame - frames_.data();
+        }
+
+        Frame& frame = frames_[page_table_[page_id]];
+        frame.referenced = true;
+
+        const PageEntry* entry = GetEntry<PageEntry>(GetData(&frame), ref >> kEntryShift & kEntryMask);
+        slot = reinterpret_cast<Node*>(reinterpret_cast<uint64_t>(entry) | kFrameTag);
+
+        return entry;
+    }
+
+    template <class Key>
+    typename PagedArt<Key>::Frame* PagedArt<Key>::AllocateFrame()
+    {
+        // terminates after at most two rounds because every round clears the referenced bits
+        while (true)
+        {
+            Frame& frame = frames_[clock_hand_];
+            clock_hand_ = (clock_hand_ + 1) % frames_.size();
+
+            if (frame.page_id == kNoPage)
+                return &frame;
+
+            if (frame.referenced)
+            {
+                frame.referenced = false;
+                continue;
+            }
+
+            Evict(&frame);
+            return &frame;
+        }
+    }
+
+    template <class Key>
+    void PagedArt<Key>::Evict(Frame* frame)
+    {
+        ++statistics_.evictions;
+
+        if (!frame->pending.empty())
+        {
+            // points all slots at the rewritten pages
+            Rewrite(frame, false);
+            return;
+        }
+
+        std::byte* page = GetData(frame);
+        if (frame->dirty)
+            WritePage(frame->page_id, page);
+
+        const auto header = reinterpret_cast<const PageHeader*>(page);
+        for (uint32_t i = 0; i < header->entry_count; ++i)
+        {
+            const PageEntry* entry = GetEntry<PageEntry>(page, i);
+            FindSlot(static_cast<Key>(entry->prefix), entry->offset) =
+                reinterpret_cast<Node*>(frame->page_id << kPageShift | i << kEntryShift | kPageTag);
+        }
+
+        page_table_[frame->page_id] = kNoFrame;
+        frame->page_id = kNoPage;
+    }
+
+    template <class Key>
+    void PagedArt<Key>::Rewrite(Frame* frame, const bool keep, const Key extra_prefix, const int extra_offset,
+                                const std::span<const Key> extra_keys)
+    {
+        struct Subtree
+        {
+            Key prefix;
+            int offset;
+            std::vector<Key> keys;
+        };
+
+        std::byte* page = GetData(frame);
+        const auto header = reinterpret_cast<const PageHeader*>(page);
+
+        std::vector<Subtree> subtrees;
+        subtrees.reserve(header->entry_count + 1);
+
+        for (uint32_t i = 0; i < header->entry_count; ++i)
+        {
+            const PageEntry* entry = GetEntry<PageEntry>(page, i);
+            Subtree& subtree = subtrees.emplace_back(static_cast<Key>(entry->prefix), entry->offset);
+
+            image::Scan(page, entry->root, Key{0}, static_cast<Key>(~Key{0}), entry->offset, subtree.prefix, false,
+                        false, [&](const Key key)
+                        {
+                            subtree.keys.push_back(key);
+                            return true;
+                        });
+
+            const auto first = std::ranges::lower_bound(frame->pending, subtree.prefix);
+            const auto last = std::ranges::upper_bound(frame->pending,
+                                                       subtree.prefix | GetSubtreeMask<Key>(subtree.offset));
+            if (first < last)
+            {
+                subtree.keys.insert(subtree.keys.end(), first, last);
+                std::ranges::inplace_merge(subtree.keys, subtree.keys.end() - (last - first));
+            }
+        }
+
+        if (!extra_keys.empty())
+            subtrees.emplace_back(extra_prefix, extra_offset, std::vector<Key>(extra_keys.begin(), extra_keys.end()));
+
+        // siblings stay next to each other
+        std::ranges::sort(subtrees, {}, &Subtree::prefix);
+
+        // a page overflowing is split evenly (like a B-tree node) so neither half is rewritten again right away
+        size_t size = sizeof(PageHeader);
+        for (const Subtree& subtree : subtrees)
+        {
+            PageWriter counter{nullptr, 0, 0};
+            image::WriteNode(counter, std::span<const Key>(subtree.keys), subtree.offset);
+            size += counter.position + sizeof(PageEntry);
+        }
+        const size_t page_count = (size + kPageSize - 1) / kPageSize;
+
+        const uint64_t page_id = frame->page_id;
+        frame->pending.clear();
+        if (!keep)
+        {
+            page_table_[page_id] = kNoFrame;
+            frame->page_id = kNoPage;
+        }
+
+        BeginPacking(page_id, keep ? frame : nullptr, size / page_count);
+        for (const Subtree& subtree : subtrees)
+            FindSlot(subtree.prefix, subtree.offset) = Place(subtree.prefix, subtree.offset, subtree.keys);
+        FlushPage(false);
+    }
+
+    template <class Key>
+    void PagedArt<Key>::AddSubtree(Node* node, const uint8_t partial_key, const int offset,
+                                   const std::span<const Key> keys)
+    {
+        const Key prefix = keys[0] & static_cast<Key>(~GetSubtreeMask<Key>(offset));
+
+        int sibling = -1;
+        for (const auto& [child_key, child] : node->GetChildren(0x00, 0xFF))
+        {
+            const uint64_t tag = GetTag(child);
+            if ((tag == kFrameTag || tag == kPageTag) &&
+                (sibling < 0 || std::abs(child_key - partial_key) < std::abs(sibling - partial_key)))
+                sibling = child_key;
+        }
+
+        if (sibling >= 0)
+        {
+            // Insert reports the failure if the page of the sibling couldn't be read
+            if (const PageEntry* entry = Fix(node->FindChild(sibling)))
+                Rewrite(&GetFrame(entry), true, prefix, offset, keys);
+            return;
+        }
+
+        BeginPacking(AllocatePage(), nullptr);
+        Node* child = Place(prefix, offset, keys);
+        FlushPage(false);
+
+        node->FindChild(partial_key) = child;
+    }
+
+    template <class Key>
+    typename PagedArt<Key>::Node* PagedArt<Key>::Place(const Key prefix, const int offset,
+                                                       const std::span<const Key> keys)
+    {
+        if (keys.size() == 1)
+            return reinterpret_cast<Node*>(image::EncodeKey(keys[0]));
+
+        if (Node* child = AddToPage(prefix, offset, keys))
+            return child;
+
+        if (packed_entries_ != 0)
+        {
+            FlushPage(true);
+            if (Node* child = AddToPage(prefix, offset, keys))
+                return child;
+        }
+
+        // too large for a page on its own (subtrees at the last level always fit)
+        return PlaceChildren(prefix, offset, keys);
+    }
+
+    template <class Key>
+    typename PagedArt<Key>::Node* PagedArt<Key>::PlaceChildren(const Key prefix, const int offset,
+                                                               const std::span<const Key> keys)
+    {
+        uint16_t child_count = 0;
+        for (size_t i = 0; i < keys.size(); ++i)
+            child_count += i == 0 || (keys[i] >> offset & 0xFF) != (keys[i - 1] >> offset & 0xFF);
+
+        Node* node = Node::Create(child_count);
+
+        for (size_t begin = 0; begin < keys.size();)
+        {
+            const uint8_t partial_key = keys[begin] >> offset & 0xFF;
+
+            size_t end = begin + 1;
+            while (end < keys.size() && (keys[end] >> offset & 0xFF) == partial_key)
+                ++end;
+
+            // the node is large enough for all children so it never grows
+            const Key child_prefix = prefix | static_cast<Key>(static_cast<Key>(partial_key) << offset);
+            node->Insert(partial_key, Place(child_prefix, offset - 8, keys.subspan(begin, end - begin)));
+
+            begin = end;
+        }
+
+        return node;
+    }
+
+    template <class Key>
+    typename PagedArt<Key>::Node* PagedArt<Key>::AddToPage(const Key prefix, const int offset,
+                                                           const std::span<const Key> keys)
+    {
+        // every key needs at least a child reference
+        if (keys.size() * sizeof(uint64_t) > kPageSize)
+            return nullptr;
+
+        const uint64_t entries_size = (packed_entries_ + 1) * sizeof(PageEntry);
+        PageWriter writer{packed_, packed_size_, kPageSize - entries_size};
+        const uint64_t root = image::WriteNode(writer, keys, offset);
+
+        if (writer.position > writer.limit || (packed_entries_ != 0 && writer.position + entries_size > packed_fill_))
+            return nullptr;
+
+        const uint32_t index = packed_entries_++;
+        packed_size_ = writer.position;
+        *GetEntry<PageEntry>(packed_, index) = PageEntry{prefix, static_cast<uint32_t>(root), offset};
+
+        if (packed_frame_ != nullptr)
+            return reinterpret_cast<Node*>(
+                reinterpret_cast<uint64_t>(GetEntry<PageEntry>(GetData(packed_frame_), index)) | kFrameTag);
+
+        return reinterpret_cast<Node*>(packed_page_id_ << kPageShift | uint64_t{index} << kEntryShift | kPageTag);
+    }
+
+    template <class Key>
+    void PagedArt<Key>::BeginPacking(const uint64_t page_id, Frame* keep, const size_t fill)
+    {
+        packed_page_id_ = page_id;
+        packed_frame_ = keep;
+        packed_fill_ = fill;
+        packed_size_ = sizeof(PageHeader);
+        packed_entries_ = 0;
+    }
+
+    template <class Key>
+    void PagedArt<Key>::FlushPage(const bool next)
+    {
+        if (packed_entries_ == 0)
+        {
+            if (packed_frame_ != nullptr)
+            {
+                page_table_[packed_page_id_] = kNoFrame;
+                packed_frame_->page_id = kNoPage;
+            }
+            free_pages_.push_back(packed_page_id_);
+        }
+        else
+        {
+            *reinterpret_cast<PageHeader*>(packed_) = PageHeader{packed_entries_, packed_size_};
+
+            if (packed_frame_ != nullptr)
+            {
+                memcpy(GetData(packed_frame_), packed_, kPageSize);
+                packed_frame_->dirty = true;
+            }
+            else
+            {
+                WritePage(packed_page_id_, packed_);
+            }
+        }
+
+        if (next)
+            BeginPacking(AllocatePage(), nullptr, packed_fill_);
+    }
+
+    template <class Key>
+    typename PagedArt<Key>::Node*& PagedArt<Key>::FindSlot(const Key prefix, const int offset)
+    {
+        Node* node = root_;
+        for (int level = KeyTraits<Key>::kRootOffset; level > offset + 8; level -= 8)
+            node = node->FindChild(prefix >> level & 0xFF);
+
+        return node->FindChild(prefix >> (offset + 8) & 0xFF);
+    }
+
+    template <class Key>
+    uint64_t PagedArt<Key>::AllocatePage()
+    {
+        if (!free_pages_.empty())
+        {
+            const uint64_t page_id = free_pages_.back();
+            free_pages_.pop_back();
+            return page_id;
+        }
+
+        page_table_.push_back(kNoFrame);
+        return page_table_.size() - 1;
+    }
+
+    template <class Key>
+    bool PagedArt<Key>::ReadPage(const uint64_t page_id, std::byte* data)
+    {
+        ++statistics_.page_reads;
+
+        if (pread(fd_, data, kPageSize, static_cast<off_t>(page_id * kPageSize)) != kPageSize)
+            failed_ = true;
+
+        return !failed_;
+    }
+
+    template <class Key>
+    bool PagedArt<Key>::WritePage(const uint64_t page_id, const std::byte* data)
+    {
+        ++statistics_.page_writes;
+
+        if (pwrite(fd_, data, kPageSize, static_cast<off_t>(page_id * kPageSize)) != kPageSize)
+            failed_ = true;
+
+        return !failed_;
+    }
+
+    template <class Key>
+    void PagedArt<Key>::Free(Node* node)
+    {
+        if (node == nullptr)
+            return;
+
+        for (const auto& [partial_key, child] : node->GetChildren(0x00, 0xFF))
+            if (GetTag(child) == 0)
+                Free(child);
+
+        node->Delete();
+    }
+
+    template class PagedArt<uint16_t>;
+    template class PagedArt<uint32_t>;
+    template class PagedArt<uint64_t>;
+}
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+#include "node/node.h"
+
+namespace art
+{
+    /**
+     * ART for keys of type Key (see KeyTraits) which is larger than the memory it may use. The upper levels of the
+     * tree are ordinary nodes in memory, the subtrees below them are stored in fixed-size pages of a file and cached
+     * in a buffer pool of memory_budget bytes.
+     *
+     * A page packs several sibling subtrees in the node layout of image.h (slotted: nodes from the front, an entry per
+     * subtree from the back, see paged_art.cpp). The child slot of an upper node referring to a subtree holds
+     *  - a swizzled pointer to the entry of the subtree in its cached page (tagged with 5), or
+     *  - the page ID and the index of the entry (tagged with 6) while the page isn't cached,
+     * next to untagged node pointers and full keys (tagged with 7 like lazy expanded keys). A lookup following an
+     * unswizzled reference reads the page and swizzles the slot, evicting a page with the clock algorithm if the pool
+     * is full. Evicting a page unswizzles the slots of all its subtrees again.
+     *
+     * Inserts into a cached page are collected in a small sorted buffer of the page and merged in groups by rewriting
+     * the page. Subtrees which don't fit into a page anymore move to other pages or are split into an upper node and
+     * smaller subtrees.
+     *
+     * The page file is private scratch space which is removed as soon as it is opened (the tree isn't persistent).
+     * Once a page couldn't be read or written the tree is incomplete, so all operations fail until it is rebuilt.
+     */
+    template <class Key = uint32_t>
+    class PagedArt
+    {
+        using Node = art::Node<TreeConfig<Key, SwitchDispatch>>;
+
+    public:
+        static constexpr size_t kPageSize = 16 * 1024;
+
+        struct Statistics
+        {
+            uint64_t page_reads = 0;
+            uint64_t page_writes = 0;
+            uint64_t evictions = 0;
+        };
+
+        PagedArt() = default;
+
+        ~PagedArt();
+
+        PagedArt(const PagedArt&) = delete;
+
+        PagedArt& operator=(const PagedArt&) = delete;
+
+        /**
+         * Creates an empty tree whose pages are stored in a new file at path (closing the current one). The buffer
+         * pool caches memory_budget / kPageSize pages (at least two). With direct_io the file bypasses the page cache
+         * of the OS (if the file system supports it) so that pages outside the pool are really read from the disk.
+         * Returns false if the file couldn't be created.
+         */
+        bool Open(const std::string& path, size_t memory_budget, bool direct_io = true);
+
+        /**
+         * Frees the tree and its pages.
+         */
+        void Close();
+
+        bool IsOpen() const
+        {
+            return fd_ >= 0;
+        }
+
+        /**
+         * Replaces the tree by one storing keys (sorted in ascending order without duplicates). Sibling subtrees are
+         * packed into pages in key order and written directly to the file. Returns false if a page couldn't be
+         * written.
+         */
+        bool Build(std::span<const Key> keys);
+
+        /**
+         * Inserts a key. Returns false if a page couldn't be read or written.
+         */
+        bool Insert(Key value);
+
+        /**
+         * Returns whether value is stored (or nothing if a page couldn't be read or written).
+         */
+        std::optional<bool> Find(Key value);
+
+        /**
+         * Returns all keys in [from, to] in ascending order (or nothing if a page couldn't be read or written).
+         */
+        std::optional<std::vector<Key>> FindRange(Key from, Key to);
+
+        uint64_t Size() const
+        {
+            return size_;
+        }
+
+        /**
+         * Returns the number of pages in the file (including currently unused ones).
+         */
+        uint64_t GetPageCount() const
+        {
+            return page_table_.size();
+        }
+
+        const Statistics& GetStatistics() const
+        {
+            return statistics_;
+        }
+
+    private:
+        struct PageEntry;
+
+        struct Frame
+        {
+            uint64_t page_id;
+            // keys inserted into the subtrees of the page since it was written, sorted
+            std::vector<Key> pending;
+            bool referenced;
+            bool dirty;
+        };
+
+        /**
+         * Returns the entry of the subtree referenced by slot, reading its page and swizzling the slot if necessary
+         * (nullptr if a page couldn't be read or written).
+         */
+        const PageEntry* Fix(Node*& slot);
+
+        /**
+         * Returns a frame for a page, evicting the next unreferenced one (clock) if all are used.
+         */
+        Frame* AllocateFrame();
+
+        /**
+         * Writes a page back (merging its pending inserts) and unswizzles the slots referencing it.
+         */
+        void Evict(Frame* frame);
+
+        /**
+         * Repacks the subtrees of a cached page together with its pending inserts and an optional new subtree.
+         * The first resulting page stays in the frame if keep is set, all others are written to the file.
+         */
+        void Rewrite(Frame* frame, bool keep, Key extra_prefix = 0, int extra_offset = 0,
+                     std::span<const Key> extra_keys = {});
+
+        /**
+         * Stores a new subtree of keys (at least two) below the slot of node with partial_key, in the page of the
+         * closest sibling subtree if there is one.
+         */
+        void AddSubtree(Node* node, uint8_t partial_key, int offset, std::span<const Key> keys);
+
+        /**
+         * Returns the slot value of a subtree storing keys (sorted, all sharing the bits of prefix above offset):
+         * a full key, a subtree in the page currently packed or an upper node with smaller subtrees.
+         */
+        Node* Place(Key prefix, int offset, std::span<const Key> keys);
+
+        /**
+         * Returns an upper node at offset whose children are placed subtrees of keys.
+         */
+        Node* PlaceChildren(Key prefix, int offset, std::span<const Key> keys);
+
+        /**
+         * Appends a subtree to the page currently packed and returns its slot value (or nullptr if it doesn't fit).
+         */
+        Node* AddToPage(Key prefix, int offset, std::span<const Key> keys);
+
+        /**
+         * Starts packing subtrees into page_id. Its content is copied into keep (if set) instead of being written.
+         * Pages are finished once they hold fill bytes (or the next subtree doesn't fit).
+         */
+        void BeginPacking(uint64_t page_id, Frame* keep, size_t fill = kPageSize);
+
+        /**
+         * Finishes the page currently packed and starts the next one if next is set.
+         */
+        void FlushPage(bool next);
+
+        /**
+         * Returns the slot referencing the subtree with root offset and prefix.
+         */
+        Node*& FindSlot(Key prefix, int offset);
+
+        uint64_t AllocatePage();
+
+        /**
+         * Reads or writes a page. Returns false (marking the tree as failed) if the I/O failed.
+         */
+        bool ReadPage(uint64_t page_id, std::byte* data);
+
+        bool WritePage(uint64_t page_id, const std::byte* data);
+
+        std::byte* GetData(const Frame* frame) const
+        {
+            return pool_ + (frame - frames_.data()) * kPageSize;
+        }
+
+        /**
+         * Returns the frame caching the page of a swizzled entry.
+         */
+        Frame& GetFrame(const PageEntry* entry);
+
+        /**
+         * Returns true if value is stored in the subtree of entry (including the pending inserts of its page).
+         */
+        bool FindInPage(const PageEntry* entry, Key value);
+
+        /**
+         * Appends the keys in [from, to] below node to result. Returns false if a page couldn't be read or written.
+         */
+        bool ScanRange(Node* node, int offset, Key from, Key to, Key path, bool lower, bool upper,
+                       std::vector<Key>& result);
+
+        static void Free(Node* node);
+
+        Node* root_ = nullptr;
+        uint64_t size_ = 0;
+        // a page couldn't be read or written since the last Build
+        bool failed_ = false;
+
+        int fd_ = -1;
+        // page frames followed by the page being packed, aligned for direct I/O
+        std::vector<std::byte> memory_;
+        std::byte* pool_ = nullptr;
+        std::vector<Frame> frames_;
+        size_t clock_hand_ = 0;
+
+        // frame caching each page (or kNoFrame)
+        std::vector<uint32_t> page_table_;
+        std::vector<uint64_t> free_pages_;
+
+        // page currently packed by Place
+        std::byte* packed_ = nullptr;
+        uint64_t packed_page_id_ = 0;
+        Frame* packed_frame_ = nullptr;
+        uint32_t packed_size_ = 0;
+        uint32_t packed_entries_ = 0;
+        size_t packed_fill_ = kPageSize;
+
+        Statistics statistics_;
+    };
+}
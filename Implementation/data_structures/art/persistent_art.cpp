@@ -0,0 +1,369 @@
+#include "persistent_art.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "image.h"
+
+/**
+ * File layout of PersistentArt (native byte order):
+ *
+ *  header:     FileHeader at offset 0, padded to kHeaderSize bytes
+ *  nodes:      nodes in the layout of image.h in any order, offsets relative to the start of the file
+ *
+ * The root is always a node (an empty Node4 for an empty tree). Space after FileHeader::used and nodes on the free
+ * lists are unused.
+ *
+ * Crash consistency (shadow paging): the header only changes in Sync, after all nodes were flushed, so the root it
+ * stores always points to a complete tree. Until the next sync, nodes reachable from that root aren't modified: an
+ * insert copies every such node on its path instead (later inserts modify the copies in place) and the replaced nodes
+ * are only put on the free lists once the header points to the new root.
+ *
+ * Taking a node from a free list overwrites its link, so the first allocation from the free lists after a sync marks
+ * the free lists of the header invalid (and flushes it) first. Opening a file with invalid free lists drops them and
+ * leaks their nodes.
+ */
+namespace art
+{
+    namespace
+    {
+        constexpr char kMagic[4]{'A', 'R', 'T', 'P'};
+        constexpr uint8_t kFormatVersion = 1;
+        constexpr size_t kHeaderSize = 4096;
+
+        struct FileHeader
+        {
+            char magic[4];
+            uint8_t version;
+            uint8_t key_size;
+            // free_lists is intact
+            uint8_t free_lists_valid;
+            uint64_t root;
+            uint64_t key_count;
+            // end of the allocated nodes
+            uint64_t used;
+            uint64_t free_lists[4];
+        };
+
+        static_assert(sizeof(FileHeader) <= kHeaderSize);
+    }
+
+    template <class Key>
+    PersistentArt<Key>::~PersistentArt()
+    {
+        Close();
+    }
+
+    template <class Key>
+    bool PersistentArt<Key>::Open(const std::string& path)
+    {
+        Close();
+
+        const int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0)
+            return false;
+
+        struct stat file_stat{};
+        if (fstat(fd, &file_stat) != 0)
+        {
+            close(fd);
+            return false;
+        }
+
+        const bool created = file_stat.st_size == 0;
+        if (created && ftruncate(fd, kExtentSize) != 0)
+        {
+            close(fd);
+            return false;
+        }
+
+        const size_t size = created ? kExtentSize : static_cast<size_t>(file_stat.st_size);
+        void* base = size >= kHeaderSize ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+        if (base == MAP_FAILED)
+        {
+            close(fd);
+            return false;
+        }
+
+        const auto header = static_cast<FileHeader*>(base);
+
+        if (created)
+        {
+            memcpy(header->magic, kMagic, sizeof(kMagic));
+            header->version = kFormatVersion;
+            header->key_size = sizeof(Key);
+            header->used = kHeaderSize;
+        }
+        else if (memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != kFormatVersion ||
+                 header->key_size != sizeof(Key) || header->used < kHeaderSize || header->used > size ||
+                 header->root == 0 || image::IsKey(header->root) ||
+                 (header->root & ~image::kTagMask) >= header->used)
+        {
+            munmap(base, size);
+            close(fd);
+            return false;
+        }
+
+        base_ = static_cast<std::byte*>(base);
+        capacity_ = size;
+        fd_ = fd;
+
+        root_ = header->root;
+        size_ = header->key_count;
+        used_ = synced_used_ = header->used;
+        if (header->free_lists_valid)
+            memcpy(free_lists_, header->free_lists, sizeof(free_lists_));
+        free_lists_synced_ = true;
+
+        if (created)
+        {
+            root_ = Allocate(kNode4) | (kNode4 + 1);
+            if (!Sync())
+            {
+                Close();
+                unlink(path.c_str());
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    template <class Key>
+    void PersistentArt<Key>::Close()
+    {
+        if (base_ == nullptr)
+            return;
+
+        Sync();
+
+        munmap(base_, capacity_);
+        close(fd_);
+
+        base_ = nullptr;
+        capacity_ = 0;
+        fd_ = -1;
+        root_ = size_ = used_ = synced_used_ = 0;
+        memset(free_lists_, 0, sizeof(free_lists_));
+        reused_.clear();
+        retired_.clear();
+    }
+
+    template <class Key>
+    bool PersistentArt<Key>::Sync()
+    {
+        // all nodes reachable from the new root are on disk before the header points to it
+        if (msync(base_, used_, MS_SYNC) != 0)
+            return false;
+
+        const auto header = reinterpret_cast<FileHeader*>(base_);
+        header->root = root_;
+        header->key_count = size_;
+        header->used = used_;
+        memcpy(header->free_lists, free_lists_, sizeof(free_lists_));
+        header->free_lists_valid = 1;
+
+        if (msync(base_, kHeaderSize, MS_SYNC) != 0)
+            return false;
+
+        // the nodes replaced since the last sync aren't reachable from the durable root anymore
+        for (const uint64_t ref : retired_)
+        {
+            const uint64_t offset = ref & ~image::kTagMask;
+            *reinterpret_cast<uint64_t*>(base_ + offset) = free_lists_[image::GetType(ref)];
+            free_lists_[image::GetType(ref)] = offset;
+        }
+
+        retired_.clear();
+        reused_.clear();
+        synced_used_ = used_;
+        free_lists_synced_ = true;
+
+        return true;
+    }
+
+    template <class Key>
+    bool PersistentArt<Key>::Insert(const Key value)
+    {
+        bool inserted = false;
+        const uint64_t root = InsertAt(root_, value, KeyTraits<Key>::kRootOffset, inserted);
+        if (root == 0)
+            return false;
+
+        root_ = root;
+        size_ += inserted;
+
+        return true;
+    }
+
+    template <class Key>
+    uint64_t PersistentArt<Key>::InsertAt(const uint64_t ref, const Key value, const int offset, bool& inserted)
+    {
+        const uint8_t partial_key = value >> offset & 0xFF;
+        const uint64_t child = image::FindChild(base_, ref, partial_key);
+
+        if (child == 0)
+        {
+            inserted = true;
+            return AddChild(ref, partial_key, image::EncodeKey(value));
+        }
+
+        uint64_t new_child;
+        if (image::IsKey(child))
+        {
+            const Key key = image::DecodeKey(child, value);
+            if (key == value)
+                return ref;
+
+            inserted = true;
+            new_child = image::CreatePair(base_, key, value, offset - 8,
+                                          [this](const NodeType type) { return Allocate(type); });
+        }
+        else
+        {
+            new_child = InsertAt(child, value, offset - 8, inserted);
+        }
+
+        if (new_child == 0)
+            return 0;
+
+        if (new_child == child)
+            return ref;
+
+        // the child was replaced so the slot pointing to it has to change too (path copying)
+        const uint64_t node = MakeWritable(ref);
+        if (node == 0)
+            return 0;
+
+        image::GetChildSlot(base_, node, partial_key) = new_child;
+
+        return node;
+    }
+
+    template <class Key>
+    uint64_t PersistentArt<Key>::AddChild(const uint64_t ref, const uint8_t partial_key, const uint64_t child)
+    {
+        uint64_t node;
+
+        if (image::IsFull(base_, ref))
+        {
+            // full nodes are copied into the next larger node type like Node::Insert does
+            const auto type = static_cast<NodeType>(image::GetType(ref) + 1);
+
+            const uint64_t offset = Allocate(type);
+            if (offset == 0)
+                return 0;
+
+            node = offset | (type + 1);
+            image::ForEachChild(base_, ref, 0x00, 0xFF, [&](const uint8_t key, const uint64_t c)
+            {
+                image::InsertChild(base_, node, key, c);
+                return true;
+            });
+
+            Free(ref);
+        }
+        else
+        {
+            node = MakeWritable(ref);
+            if (node == 0)
+                return 0;
+        }
+
+        image::InsertChild(base_, node, partial_key, child);
+
+        return node;
+    }
+
+    template <class Key>
+    uint64_t PersistentArt<Key>::MakeWritable(const uint64_t ref)
+    {
+        if (IsFresh(ref & ~image::kTagMask))
+            return ref;
+
+        const NodeType type = image::GetType(ref);
+
+        const uint64_t offset = Allocate(type);
+        if (offset == 0)
+            return 0;
+
+        memcpy(base_ + offset, base_ + (ref & ~image::kTagMask), image::kNodeSizes[type]);
+        Free(ref);
+
+        return offset | (type + 1);
+    }
+
+    template <class Key>
+    uint64_t PersistentArt<Key>::Allocate(const NodeType type)
+    {
+        uint64_t offset = free_lists_[type];
+
+        if (offset != 0)
+        {
+            if (free_lists_synced_)
+            {
+                // the link is overwritten below so the free lists of the header are invalid from now on
+                reinterpret_cast<FileHeader*>(base_)->free_lists_valid = 0;
+                if (msync(base_, kHeaderSize, MS_SYNC) != 0)
+                    return 0;
+
+                free_lists_synced_ = false;
+            }
+
+            free_lists_[type] = *reinterpret_cast<uint64_t*>(base_ + offset);
+            reused_.insert(offset);
+        }
+        else
+        {
+            if (used_ + image::kNodeSizes[type] > capacity_ && !Grow())
+                return 0;
+
+            offset = used_;
+            used_ += image::kNodeSizes[type];
+        }
+
+        image::InitializeNode(base_ + offset, type);
+
+        return offset;
+    }
+
+    template <class Key>
+    void PersistentArt<Key>::Free(const uint64_t ref)
+    {
+        const uint64_t offset = ref & ~image::kTagMask;
+
+        if (!IsFresh(offset))
+        {
+            retired_.push_back(ref);
+            return;
+        }
+
+        // fresh nodes aren't reachable from the durable root (nor on the free lists of the header)
+        *reinterpret_cast<uint64_t*>(base_ + offset) = free_lists_[image::GetType(ref)];
+        free_lists_[image::GetType(ref)] = offset;
+    }
+
+    template <class Key>
+    bool PersistentArt<Key>::Grow()
+    {
+        return image::GrowMapping(fd_, base_, capacity_, capacity_ + kExtentSize);
+    }
+
+    template <class Key>
+    bool PersistentArt<Key>::Find(const Key value) const
+    {
+        return image::Find(base_, root_, value);
+    }
+
+    template <class Key>
+    std::vector<Key> PersistentArt<Key>::FindRange(const Key from, const Key to) const
+    {
+        return image::FindRange(base_, root_, from, to);
+    }
+
+    template class PersistentArt<uint16_t>;
+    template class PersistentArt<uint32_t>;
+    template class PersistentArt<uint64_t>;
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "node/node.h"
+
+namespace art
+{
+    /**
+     * ART for keys of type Key (see KeyTraits) whose nodes live in a memory-mapped file. The file is the only copy of
+     * the tree: inserts modify the mapping directly and opening an existing file only maps it (no load step).
+     *
+     * Nodes use the layout of image.h and children are offsets into the file, so the file maps at any address and the
+     * mapping can move when it grows. The file grows in extents of kExtentSize bytes.
+     *
+     * Sync makes all inserts durable. Nodes of the last durable tree are never modified in place (they are copied on
+     * write and only reused after the next sync), and the header pointing to the root is written after all nodes are
+     * flushed. A crash therefore always leaves the tree of the last sync behind (see persistent_art.cpp).
+     */
+    template <class Key = uint32_t>
+    class PersistentArt
+    {
+    public:
+        static constexpr size_t kExtentSize = 64 << 20;
+
+        PersistentArt() = default;
+
+        ~PersistentArt();
+
+        PersistentArt(const PersistentArt&) = delete;
+
+        PersistentArt& operator=(const PersistentArt&) = delete;
+
+        /**
+         * Maps the tree stored at path or creates an empty one if the file doesn't exist (closing the current one).
+         * Returns false if the file couldn't be created or mapped or doesn't store keys of type Key.
+         */
+        bool Open(const std::string& path);
+
+        /**
+         * Syncs and unmaps the tree.
+         */
+        void Close();
+
+        bool IsOpen() const
+        {
+            return base_ != nullptr;
+        }
+
+        /**
+         * Inserts a key (durable after the next Sync). Returns false if the file couldn't grow.
+         */
+        bool Insert(Key value);
+
+        bool Find(Key value) const;
+
+        /**
+         * Returns all keys in [from, to] in ascending order.
+         */
+        std::vector<Key> FindRange(Key from, Key to) const;
+
+        uint64_t Size() const
+        {
+            return size_;
+        }
+
+        /**
+         * Returns the size of the file in bytes.
+         */
+        uint64_t GetFileSize() const
+        {
+            return capacity_;
+        }
+
+        /**
+         * Flushes all nodes and then the header pointing to the current root. Returns false if flushing failed.
+         */
+        bool Sync();
+
+    private:
+        /**
+         * Inserts value below the node at ref (at offset) and returns the reference to the node replacing it
+         * (ref itself if it was modified in place or value already existed, 0 if the file couldn't grow).
+         */
+        uint64_t InsertAt(uint64_t ref, Key value, int offset, bool& inserted);
+
+        /**
+         * Adds a child to the node at ref (growing it if it is full) and returns the reference to the modified node.
+         */
+        uint64_t AddChild(uint64_t ref, uint8_t partial_key, uint64_t child);
+
+        /**
+         * Returns ref if the node may be modified in place or a copy of it otherwise (0 if the file couldn't grow).
+         */
+        uint64_t MakeWritable(uint64_t ref);
+
+        /**
+         * Returns the offset of a new empty node of type (0 if the file couldn't grow).
+         */
+        uint64_t Allocate(NodeType type);
+
+        /**
+         * Frees a node replaced by another one. Nodes of the last durable tree are only reused after the next sync.
+         */
+        void Free(uint64_t ref);
+
+        /**
+         * Returns true if the node at offset was allocated after the last sync (and isn't part of the durable tree).
+         */
+        bool IsFresh(uint64_t offset) const
+        {
+            return offset >= synced_used_ || reused_.contains(offset);
+        }
+
+        /**
+         * Grows the file and the mapping by kExtentSize bytes.
+         */
+        bool Grow();
+
+        std::byte* base_ = nullptr;
+        size_t capacity_ = 0;
+        int fd_ = -1;
+
+        uint64_t root_ = 0;
+        uint64_t size_ = 0;
+        // end of the allocated nodes
+        uint64_t used_ = 0;
+        // heads of the lists of free nodes per node type (linked through the first 8 bytes of the nodes)
+        uint64_t free_lists_[4]{};
+
+        // end of the allocated nodes at the last sync (nodes behind it are fresh)
+        uint64_t synced_used_ = 0;
+        // fresh nodes taken from the free lists
+        std::unordered_set<uint64_t> reused_;
+        // nodes of the durable tree replaced since the last sync
+        std::vector<uint64_t> retired_;
+        // the free lists stored in the header are still intact (no node was taken from them since the last sync)
+        bool free_lists_synced_ = true;
+    };
+}
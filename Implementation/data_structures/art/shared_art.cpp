@@ -0,0 +1,629 @@
+#include "shared_art.h"
+
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "image.h"
+
+/**
+ * Segment layout of SharedArt (native byte order):
+ *
+ *  header:     SegmentHeader at offset 0
+ *  nodes:      nodes in the layout of image.h in allocation order, offsets relative to the start of the segment
+ *
+ * The root is always a node (an empty Node4 for an empty tree).
+ *
+ * Readers follow a child reference only once the node behind it is complete: the writer initializes a node before
+ * storing its reference with release semantics, and in-place inserts into Node4 and Node16 (which shift children)
+ * are bracketed by increments of the node version like InsertVersioned in node.cpp. Range scans copy the children of
+ * every node they visit the same way, so a concurrent insert only repeats the copy of a single node.
+ */
+namespace art
+{
+    namespace
+    {
+        using image::ImageNode4;
+        using image::ImageNode16;
+        using image::ImageNode48;
+        using image::ImageNode256;
+
+        constexpr char kMagic[4]{'A', 'R', 'T', 'H'};
+        constexpr uint8_t kFormatVersion = 2;
+
+        struct SegmentHeader
+        {
+            char magic[4];
+            uint8_t version;
+            uint8_t key_size;
+            uint64_t root;
+            uint64_t key_count;
+            // size of the segment, grown before any node behind the old size is referenced
+            uint64_t capacity;
+            // end of the allocated nodes
+            uint64_t used;
+        };
+
+        constexpr size_t kHeaderSize = (sizeof(SegmentHeader) + 7) & ~size_t{7};
+
+        /**
+         * Loads a value of the segment which another process may store concurrently.
+         */
+        template <class T>
+        T LoadAcquire(const T& value)
+        {
+            return std::atomic_ref(const_cast<T&>(value)).load(std::memory_order_acquire);
+        }
+
+        template <class T>
+        void StoreRelease(T& value, const T desired)
+        {
+            std::atomic_ref(value).store(desired, std::memory_order_release);
+        }
+
+        /**
+         * Adds a child with a new partial key to the node at ref which isn't full without exposing a partial insert.
+         */
+        void PublishChild(std::byte* base, const uint64_t ref, const uint8_t partial_key, const uint64_t child)
+        {
+            std::byte* node = base + (ref & ~image::kTagMask);
+
+            const auto insert_versioned = [&](uint16_t& version_field)
+            {
+                const std::atomic_ref version(version_field);
+                const uint16_t v = version.load(std::memory_order_relaxed);
+
+                version.store(v + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+
+                image::InsertChild(base, ref, partial_key, child);
+
+                version.store(v + 2, std::memory_order_release);
+            };
+
+            switch (image::GetType(ref))
+            {
+                case kNode4:
+                    insert_versioned(reinterpret_cast<ImageNode4*>(node)->version);
+                    return;
+                case kNode16:
+                    insert_versioned(reinterpret_cast<ImageNode16*>(node)->version);
+                    return;
+                case kNode48:
+                    {
+                        // the child is stored in an unused slot before its index makes it reachable
+                        const auto n = reinterpret_cast<ImageNode48*>(node);
+                        std::atomic_ref(n->children[n->child_count]).store(child, std::memory_order_relaxed);
+                        StoreRelease(n->keys[partial_key], n->child_count);
+                        ++n->child_count;
+                        return;
+                    }
+                case kNode256:
+                    {
+                        const auto n = reinterpret_cast<ImageNode256*>(node);
+                        StoreRelease(n->children[partial_key], child);
+                        ++n->child_count;
+                        return;
+                    }
+            }
+
+            __unreachable();
+        }
+
+        /**
+         * Reads a Node4 or Node16 with plain loads via read() and only retries if the version shows that the read
+         * overlapped with an insertion into this node (see FindChildVersioned in node.cpp).
+         *
+         * Since a node is replaced once full it sees at most 16 insertions so the version never wraps around.
+         */
+        template <class Read>
+        auto ReadVersioned(const uint16_t& version_field, Read&& read)
+        {
+            const std::atomic_ref version(const_cast<uint16_t&>(version_field));
+
+            while (true)
+            {
+                const uint16_t v = version.load(std::memory_order_acquire);
+
+                if (v & 1)
+                {
+                    // insertion in progress
+                    _mm_pause();
+                    continue;
+                }
+
+                const auto result = read();
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (version.load(std::memory_order_relaxed) == v)
+                    return result;
+            }
+        }
+
+        /**
+         * Returns the version of the Node4 or Node16 at node.
+         */
+        const uint16_t& GetVersion(const std::byte* node, const NodeType type)
+        {
+            return type == kNode4
+                       ? reinterpret_cast<const ImageNode4*>(node)->version
+                       : reinterpret_cast<const ImageNode16*>(node)->version;
+        }
+
+        /**
+         * Returns the reference to the child of the node at ref with partial_key (or 0 if there is none) while the
+         * writer may insert into the node.
+         */
+        uint64_t FindChildConcurrent(const std::byte* base, const uint64_t ref, const uint8_t partial_key)
+        {
+            const std::byte* node = base + (ref & ~image::kTagMask);
+
+            switch (image::GetType(ref))
+            {
+                case kNode4:
+                case kNode16:
+                    return ReadVersioned(GetVersion(node, image::GetType(ref)), [&]
+                    {
+                        return image::FindChild(base, ref, partial_key);
+                    });
+                case kNode48:
+                    {
+                        const auto n = reinterpret_cast<const ImageNode48*>(node);
+                        const uint8_t index = LoadAcquire(n->keys[partial_key]);
+                        return index != ImageNode48::kFreeMarker ? LoadAcquire(n->children[index]) : 0;
+                    }
+                case kNode256:
+                    {
+                        const auto n = reinterpret_cast<const ImageNode256*>(node);
+                        return LoadAcquire(n->children[partial_key]);
+                    }
+            }
+
+            __unreachable();
+        }
+
+        /**
+         * Copies the children of the node at ref with a partial key in [begin, end] in ascending order to partial_keys
+         * and children while the writer may insert into the node. Returns their number.
+         */
+        uint16_t CopyChildrenConcurrent(const std::byte* base, const uint64_t ref, const uint8_t begin,
+                                        const uint8_t end, uint8_t* partial_keys, uint64_t* children)
+        {
+            const std::byte* node = base + (ref & ~image::kTagMask);
+            uint16_t count = 0;
+
+            switch (image::GetType(ref))
+            {
+                case kNode4:
+                case kNode16:
+                    // a copy overlapping with an insertion (which shifts the children) is repeated
+                    return ReadVersioned(GetVersion(node, image::GetType(ref)), [&]
+                    {
+                        count = 0;
+                        image::ForEachChild(base, ref, begin, end, [&](const uint8_t partial_key, const uint64_t child)
+                        {
+                            partial_keys[count] = partial_key;
+                            children[count++] = child;
+                            return true;
+                        });
+                        return count;
+                    });
+                case kNode48:
+                    {
+                        // a child is stored before its index makes it reachable
+                        const auto n = reinterpret_cast<const ImageNode48*>(node);
+                        uint64_t bitmap[4];
+                        simd::scan_kernels.not_equal(n->keys, ImageNode48::kFreeMarker, bitmap);
+                        simd::ForEachChild(bitmap, begin, end + 1, [&](const uint8_t i)
+                        {
+                            partial_keys[count] = i;
+                            children[count++] = LoadAcquire(n->children[LoadAcquire(n->keys[i])]);
+                        });
+                        return count;
+                    }
+                case kNode256:
+                    {
+                        const auto n = reinterpret_cast<const ImageNode256*>(node);
+                        uint64_t bitmap[4];
+                        simd::scan_kernels.non_null(reinterpret_cast<const void* const*>(n->children), bitmap);
+                        simd::ForEachChild(bitmap, begin, end + 1, [&](const uint8_t i)
+                        {
+                            partial_keys[count] = i;
+                            children[count++] = LoadAcquire(n->children[i]);
+                        });
+                        return count;
+                    }
+            }
+
+            __unreachable();
+        }
+
+        /**
+         * Like image::Scan but copies the children of every node consistently (see CopyChildrenConcurrent) and stops
+         * (returning false) at the first node behind the first size bytes of the segment. The keys found until then
+         * are in res, so the scan can resume after the last one. Keys inserted during the scan may be missed.
+         */
+        template <class Key>
+        bool ScanConcurrent(const std::byte* base, const size_t size, const uint64_t ref, const Key from, const Key to,
+                            const int offset, const Key path, const bool lower, const bool upper,
+                            std::vector<Key>& res)
+        {
+            if ((ref & ~image::kTagMask) + image::kNodeSizes[image::GetType(ref)] > size)
+                return false;
+
+            const uint8_t begin = lower ? from >> offset & 0xFF : 0x00;
+            const uint8_t end = upper ? to >> offset & 0xFF : 0xFF;
+
+            uint8_t partial_keys[256];
+            uint64_t children[256];
+            const uint16_t count = CopyChildrenConcurrent(base, ref, begin, end, partial_keys, children);
+
+            for (uint16_t i = 0; i < count; ++i)
+            {
+                const uint8_t partial_key = partial_keys[i];
+                const Key child_path = path | static_cast<Key>(static_cast<Key>(partial_key) << offset);
+
+                if (image::IsKey(children[i]))
+                {
+                    const Key key = image::DecodeKey(children[i], child_path);
+                    if (key >= from && key <= to)
+                        res.push_back(key);
+                }
+                else if (!ScanConcurrent(base, size, children[i], from, to, offset - 8, child_path,
+                                         lower && partial_key == begin, upper && partial_key == end, res))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    }
+
+    template <class Key>
+    SharedArt<Key>::~SharedArt()
+    {
+        Close();
+    }
+
+    template <class Key>
+    bool SharedArt<Key>::Create(const std::string& name, const size_t extent_size)
+    {
+        Close();
+
+        // readers of an existing segment keep their mappings of it
+        shm_unlink(name.c_str());
+
+        const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0)
+            return false;
+
+        void* base = ftruncate(fd, static_cast<off_t>(extent_size)) == 0
+                         ? mmap(nullptr, extent_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+                         : MAP_FAILED;
+        if (base == MAP_FAILED)
+        {
+            close(fd);
+            shm_unlink(name.c_str());
+            return false;
+        }
+
+        base_ = static_cast<std::byte*>(base);
+        capacity_ = extent_size;
+        extent_size_ = extent_size;
+        fd_ = fd;
+
+        const auto header = static_cast<SegmentHeader*>(base);
+        header->version = kFormatVersion;
+        header->key_size = sizeof(Key);
+        header->capacity = extent_size;
+        header->used = kHeaderSize;
+        header->root = Allocate(kNode4) | (kNode4 + 1);
+
+        // readers opening the segment concurrently only accept it once it is initialized
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(header->magic, kMagic, sizeof(kMagic));
+
+        return true;
+    }
+
+    template <class Key>
+    void SharedArt<Key>::Close()
+    {
+        if (base_ == nullptr)
+            return;
+
+        munmap(base_, capacity_);
+        close(fd_);
+
+        base_ = nullptr;
+        capacity_ = 0;
+        fd_ = -1;
+    }
+
+    template <class Key>
+    bool SharedArt<Key>::Remove(const std::string& name)
+    {
+        return shm_unlink(name.c_str()) == 0;
+    }
+
+    template <class Key>
+    bool SharedArt<Key>::Insert(const Key value)
+    {
+        bool inserted = false;
+        bool grown = true;
+
+        // the parent of the root is the header (parent_ref 0)
+        uint64_t parent_ref = 0;
+        uint8_t parent_key = 0;
+        uint64_t ref = reinterpret_cast<SegmentHeader*>(base_)->root;
+
+        for (int offset = KeyTraits<Key>::kRootOffset;; offset -= 8)
+        {
+            const uint8_t partial_key = value >> offset & 0xFF;
+            const uint64_t child = image::FindChild(base_, ref, partial_key);
+
+            if (child == 0)
+            {
+                grown = inserted = AddChild(parent_ref, parent_key, ref, partial_key, image::EncodeKey(value));
+                break;
+            }
+
+            if (image::IsKey(child))
+            {
+                const Key key = image::DecodeKey(child, value);
+                if (key == value)
+                    break;
+
+                // a single store replaces the key by the complete subtree holding both keys
+                const uint64_t pair = image::CreatePair(base_, key, value, offset - 8,
+                                                        [this](const NodeType type) { return Allocate(type); });
+                if (pair != 0)
+                    StoreRelease(image::GetChildSlot(base_, ref, partial_key), pair);
+
+                grown = inserted = pair != 0;
+                break;
+            }
+
+            parent_ref = ref;
+            parent_key = partial_key;
+            ref = child;
+        }
+
+        // allocations may have moved the mapping
+        const auto header = reinterpret_cast<SegmentHeader*>(base_);
+        if (inserted)
+            StoreRelease(header->key_count, header->key_count + 1);
+
+        return grown;
+    }
+
+    template <class Key>
+    bool SharedArt<Key>::AddChild(const uint64_t parent_ref, const uint8_t parent_key, const uint64_t ref,
+                                  const uint8_t partial_key, const uint64_t child)
+    {
+        if (!image::IsFull(base_, ref))
+        {
+            PublishChild(base_, ref, partial_key, child);
+            return true;
+        }
+
+        // full nodes are copied into the next larger node type which readers only reach once it is complete
+        const auto type = static_cast<NodeType>(image::GetType(ref) + 1);
+
+        const uint64_t offset = Allocate(type);
+        if (offset == 0)
+            return false;
+
+        const uint64_t node = offset | (type + 1);
+        image::ForEachChild(base_, ref, 0x00, 0xFF, [&](const uint8_t key, const uint64_t c)
+        {
+            image::InsertChild(base_, node, key, c);
+            return true;
+        });
+        image::InsertChild(base_, node, partial_key, child);
+
+        uint64_t& slot = parent_ref == 0
+                             ? reinterpret_cast<SegmentHeader*>(base_)->root
+                             : image::GetChildSlot(base_, parent_ref, parent_key);
+        StoreRelease(slot, node);
+
+        return true;
+    }
+
+    template <class Key>
+    uint64_t SharedArt<Key>::Allocate(const NodeType type)
+    {
+        const uint64_t offset = reinterpret_cast<SegmentHeader*>(base_)->used;
+
+        if (offset + image::kNodeSizes[type] > capacity_ && !Grow())
+            return 0;
+
+        reinterpret_cast<SegmentHeader*>(base_)->used = offset + image::kNodeSizes[type];
+        image::InitializeNode(base_ + offset, type);
+
+        return offset;
+    }
+
+    template <class Key>
+    bool SharedArt<Key>::Grow()
+    {
+        if (!image::GrowMapping(fd_, base_, capacity_, capacity_ + extent_size_))
+            return false;
+
+        // readers map the grown segment before following references to the new nodes
+        StoreRelease(reinterpret_cast<SegmentHeader*>(base_)->capacity, uint64_t{capacity_});
+
+        return true;
+    }
+
+    template <class Key>
+    bool SharedArt<Key>::Find(const Key value) const
+    {
+        return image::Find<Key>(base_, reinterpret_cast<const SegmentHeader*>(base_)->root, value);
+    }
+
+    template <class Key>
+    std::vector<Key> SharedArt<Key>::FindRange(const Key from, const Key to) const
+    {
+        return image::FindRange<Key>(base_, reinterpret_cast<const SegmentHeader*>(base_)->root, from, to);
+    }
+
+    template <class Key>
+    uint64_t SharedArt<Key>::Size() const
+    {
+        return reinterpret_cast<const SegmentHeader*>(base_)->key_count;
+    }
+
+    template <class Key>
+    SharedArtReader<Key>::~SharedArtReader()
+    {
+        Close();
+    }
+
+    template <class Key>
+    bool SharedArtReader<Key>::Open(const std::string& name)
+    {
+        Close();
+
+        const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+            return false;
+
+        struct stat segment_stat{};
+        if (fstat(fd, &segment_stat) != 0 || static_cast<size_t>(segment_stat.st_size) < kHeaderSize)
+        {
+            close(fd);
+            return false;
+        }
+
+        const auto size = static_cast<size_t>(segment_stat.st_size);
+        void* base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED)
+        {
+            close(fd);
+            return false;
+        }
+
+        const auto header = static_cast<const SegmentHeader*>(base);
+        const bool valid = memcmp(header->magic, kMagic, sizeof(kMagic)) == 0;
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (!valid || header->version != kFormatVersion || header->key_size != sizeof(Key))
+        {
+            munmap(base, size);
+            close(fd);
+            return false;
+        }
+
+        base_ = static_cast<const std::byte*>(base);
+        size_ = size;
+        fd_ = fd;
+
+        return true;
+    }
+
+    template <class Key>
+    void SharedArtReader<Key>::Close()
+    {
+        if (base_ == nullptr)
+            return;
+
+        munmap(const_cast<std::byte*>(base_), size_);
+        close(fd_);
+
+        base_ = nullptr;
+        size_ = 0;
+        fd_ = -1;
+    }
+
+    template <class Key>
+    bool SharedArtReader<Key>::IsMapped(const uint64_t ref) const
+    {
+        return (ref & ~image::kTagMask) + image::kNodeSizes[image::GetType(ref)] <= size_;
+    }
+
+    template <class Key>
+    bool SharedArtReader<Key>::Remap()
+    {
+        const size_t capacity = LoadAcquire(reinterpret_cast<const SegmentHeader*>(base_)->capacity);
+        if (capacity <= size_)
+            return true;
+
+        void* base = mremap(const_cast<std::byte*>(base_), size_, capacity, MREMAP_MAYMOVE);
+        if (base == MAP_FAILED)
+            return false;
+
+        base_ = static_cast<const std::byte*>(base);
+        size_ = capacity;
+
+        return true;
+    }
+
+    template <class Key>
+    bool SharedArtReader<Key>::Find(const Key value)
+    {
+        // restarted from the root once a node lies behind the mapping (the segment grew)
+        while (true)
+        {
+            uint64_t ref = LoadAcquire(reinterpret_cast<const SegmentHeader*>(base_)->root);
+
+            // the last level only stores full keys so every lookup ends at a key or a missing child
+            for (int offset = KeyTraits<Key>::kRootOffset; IsMapped(ref); offset -= 8)
+            {
+                ref = FindChildConcurrent(base_, ref, value >> offset & 0xFF);
+
+                if (ref == 0)
+                    return false;
+
+                if (image::IsKey(ref))
+                    return image::DecodeKey(ref, value) == value;
+            }
+
+            if (!Remap())
+                return false;
+        }
+    }
+
+    template <class Key>
+    std::optional<std::vector<Key>> SharedArtReader<Key>::FindRange(Key from, const Key to)
+    {
+        std::vector<Key> res;
+        if (from > to)
+            return res;
+
+        // resumed after the last key found once a node lies behind the mapping (the segment grew)
+        while (!ScanConcurrent(base_, size_, LoadAcquire(reinterpret_cast<const SegmentHeader*>(base_)->root), from,
+                               to, KeyTraits<Key>::kRootOffset, Key{0}, true, true, res))
+        {
+            if (!Remap())
+                return std::nullopt;
+
+            if (!res.empty())
+            {
+                if (res.back() == to)
+                    break;
+
+                from = res.back() + 1;
+            }
+        }
+
+        return res;
+    }
+
+    template <class Key>
+    uint64_t SharedArtReader<Key>::Size() const
+    {
+        return LoadAcquire(reinterpret_cast<const SegmentHeader*>(base_)->key_count);
+    }
+
+    template class SharedArt<uint16_t>;
+    template class SharedArt<uint32_t>;
+    template class SharedArt<uint64_t>;
+
+    template class SharedArtReader<uint16_t>;
+    template class SharedArtReader<uint32_t>;
+    template class SharedArtReader<uint64_t>;
+}
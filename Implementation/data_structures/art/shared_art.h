@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "node/node.h"
+
+namespace art
+{
+    /**
+     * ART for keys of type Key (see KeyTraits) living in a POSIX shared memory segment so that processes on one host
+     * can share one tree. A single writer process inserts into the segment while reader processes map it read-only
+     * (see SharedArtReader) and search in place without copying.
+     *
+     * Nodes use the layout of image.h and children are offsets into the segment, so every process maps it at its own
+     * address. The segment grows in extents of kExtentSize bytes (or the extent size passed to Create).
+     *
+     * Inserts stay invisible to readers until they are complete, like InsertConcurrent of in-memory nodes: a full
+     * node is copied into a larger one which is published with a single store to its parent slot, Node4 and Node16
+     * are modified under their version (seqlock) and Node48 and Node256 publish a new child with a single store.
+     * Replaced nodes may still be read, so they are never reused.
+     */
+    template <class Key = uint32_t>
+    class SharedArt
+    {
+    public:
+        static constexpr size_t kExtentSize = 64 << 20;
+
+        SharedArt() = default;
+
+        ~SharedArt();
+
+        SharedArt(const SharedArt&) = delete;
+
+        SharedArt& operator=(const SharedArt&) = delete;
+
+        /**
+         * Creates an empty tree in a new segment called name (replacing an existing segment of that name and closing
+         * the current one). The segment starts at and grows by extent_size bytes (a multiple of the page size).
+         * Returns false if the segment couldn't be created.
+         */
+        bool Create(const std::string& name, size_t extent_size = kExtentSize);
+
+        /**
+         * Unmaps the segment. The segment stays available to readers until it is removed.
+         */
+        void Close();
+
+        bool IsOpen() const
+        {
+            return base_ != nullptr;
+        }
+
+        /**
+         * Removes the segment called name. Processes that mapped it keep their mappings.
+         */
+        static bool Remove(const std::string& name);
+
+        /**
+         * Inserts a key. Returns false if the segment couldn't grow.
+         */
+        bool Insert(Key value);
+
+        bool Find(Key value) const;
+
+        /**
+         * Returns all keys in [from, to] in ascending order.
+         */
+        std::vector<Key> FindRange(Key from, Key to) const;
+
+        uint64_t Size() const;
+
+        /**
+         * Returns the size of the segment in bytes.
+         */
+        uint64_t GetSegmentSize() const
+        {
+            return capacity_;
+        }
+
+    private:
+        /**
+         * Adds a child to the node at ref whose parent is the node at parent_ref (0 for the root) and publishes it.
+         * Returns false if the segment couldn't grow.
+         */
+        bool AddChild(uint64_t parent_ref, uint8_t parent_key, uint64_t ref, uint8_t partial_key, uint64_t child);
+
+        /**
+         * Returns the offset of a new empty node of type (0 if the segment couldn't grow).
+         */
+        uint64_t Allocate(NodeType type);
+
+        /**
+         * Grows the segment and the mapping by one extent.
+         */
+        bool Grow();
+
+        std::byte* base_ = nullptr;
+        size_t capacity_ = 0;
+        size_t extent_size_ = kExtentSize;
+        int fd_ = -1;
+    };
+
+    /**
+     * Read-only view of a tree written by SharedArt in another (or the same) process. Lookups validate the versions
+     * the writer maintains and retry instead of locking, and the view maps the grown segment once it finds a node
+     * behind its mapping. An instance must only be used by one thread at a time.
+     */
+    template <class Key = uint32_t>
+    class SharedArtReader
+    {
+    public:
+        SharedArtReader() = default;
+
+        ~SharedArtReader();
+
+        SharedArtReader(const SharedArtReader&) = delete;
+
+        SharedArtReader& operator=(const SharedArtReader&) = delete;
+
+        /**
+         * Maps the segment called name (closing the current one). Returns false if it doesn't exist or doesn't
+         * store keys of type Key.
+         */
+        bool Open(const std::string& name);
+
+        void Close();
+
+        bool IsOpen() const
+        {
+            return base_ != nullptr;
+        }
+
+        bool Find(Key value);
+
+        /**
+         * Returns all keys in [from, to] in ascending order (or nothing if the grown segment couldn't be mapped).
+         * Keys inserted meanwhile may be missing. A concurrent insert into a node only repeats reading that node, and
+         * the scan resumes after the last key found once the segment grew.
+         */
+        std::optional<std::vector<Key>> FindRange(Key from, Key to);
+
+        uint64_t Size() const;
+
+    private:
+        /**
+         * Returns true if the node at ref lies inside the mapping.
+         */
+        bool IsMapped(uint64_t ref) const;
+
+        /**
+         * Maps the segment with its current size. Returns false if it couldn't be mapped.
+         */
+        bool Remap();
+
+        const std::byte* base_ = nullptr;
+        size_t size_ = 0;
+        int fd_ = -1;
+    };
+}
@@ -0,0 +1,150 @@
+#include "thread_pool.h"
+
+namespace art
+{
+    namespace
+    {
+        // pool and queue index of the worker running on the current thread
+        thread_local const ThreadPool* current_pool = nullptr;
+        thread_local uint32_t current_queue = 0;
+    }
+
+    ThreadPool::ThreadPool(const uint32_t thread_count)
+    {
+        const uint32_t n = thread_count == 0 ? 1 : thread_count;
+
+        queues_.reserve(n);
+        for (uint32_t i = 0; i < n; ++i)
+            queues_.push_back(std::make_unique<TaskQueue>());
+
+        workers_.reserve(n);
+        for (uint32_t i = 0; i < n; ++i)
+            workers_.emplace_back(&ThreadPool::WorkerLoop, this, i);
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        work_available_.notify_all();
+
+        for (auto& worker : workers_)
+            worker.join();
+    }
+
+    void ThreadPool::Submit(std::function<void()> task)
+    {
+        // workers keep their own tasks local, everything else is distributed round-robin
+        const uint32_t index = current_pool == this
+                                   ? current_queue
+                                   : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+
+        pending_.fetch_add(1, std::memory_order_relaxed);
+
+        {
+            // increment under the lock so sleeping workers can't miss the new task
+            std::lock_guard lock(mutex_);
+            queued_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        {
+            std::lock_guard lock(queues_[index]->mutex);
+            queues_[index]->tasks.push_back(std::move(task));
+        }
+
+        work_available_.notify_one();
+    }
+
+    void ThreadPool::Wait()
+    {
+        uint32_t index = 0;
+
+        while (pending_.load(std::memory_order_acquire) != 0)
+        {
+            if (RunTask(index))
+                continue;
+
+            index = (index + 1) % queues_.size();
+
+            std::unique_lock lock(mutex_);
+            work_done_.wait(lock, [this]
+            {
+                return pending_.load(std::memory_order_acquire) == 0 || queued_.load(std::memory_order_relaxed) != 0;
+            });
+        }
+    }
+
+    uint32_t ThreadPool::GetThreadCount() const
+    {
+        return static_cast<uint32_t>(workers_.size());
+    }
+
+    void ThreadPool::WorkerLoop(const uint32_t index)
+    {
+        current_pool = this;
+        current_queue = index;
+
+        while (true)
+        {
+            if (RunTask(index))
+                continue;
+
+            std::unique_lock lock(mutex_);
+            work_available_.wait(lock, [this]
+            {
+                return stop_ || queued_.load(std::memory_order_relaxed) != 0;
+            });
+
+            if (stop_)
+                return;
+        }
+    }
+
+    bool ThreadPool::RunTask(const uint32_t index)
+    {
+        std::function<void()> task;
+
+        // tasks are run in submission order so ordered consumers (e.g. ordered scans) can start early
+        {
+            std::lock_guard lock(queues_[index]->mutex);
+            if (!queues_[index]->tasks.empty())
+            {
+                task = std::move(queues_[index]->tasks.front());
+                queues_[index]->tasks.pop_front();
+            }
+        }
+
+        // steal the oldest task of another queue
+        for (size_t i = 1; !task && i < queues_.size(); ++i)
+        {
+            auto& victim = *queues_[(index + i) % queues_.size()];
+
+            std::lock_guard lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+            }
+        }
+
+        if (!task)
+            return false;
+
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        task();
+        FinishTask();
+
+        return true;
+    }
+
+    void ThreadPool::FinishTask()
+    {
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            std::lock_guard lock(mutex_);
+            work_done_.notify_all();
+        }
+    }
+}
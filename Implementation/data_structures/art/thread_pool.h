@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace art
+{
+    /**
+     * Work-stealing thread pool used by the parallel tree operations.
+     *
+     * Every worker owns a task queue. Workers take tasks from their own queue and steal from the other queues
+     * once their own runs empty. Tasks submitted from outside the pool are distributed round-robin.
+     */
+    class ThreadPool
+    {
+    public:
+        /**
+         * Starts thread_count workers (defaults to the number of hardware threads).
+         */
+        explicit ThreadPool(uint32_t thread_count = std::thread::hardware_concurrency());
+
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * Schedules a task for execution.
+         */
+        void Submit(std::function<void()> task);
+
+        /**
+         * Blocks until all submitted tasks are finished. The calling thread helps executing tasks while waiting.
+         * Must not be called from within a task.
+         */
+        void Wait();
+
+        /**
+         * Returns the number of worker threads.
+         */
+        uint32_t GetThreadCount() const;
+
+    private:
+        struct TaskQueue
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        void WorkerLoop(uint32_t index);
+
+        /**
+         * Runs a single task, preferring the queue at index and stealing from the other queues otherwise.
+         * Returns false if there was no task to run.
+         */
+        bool RunTask(uint32_t index);
+
+        void FinishTask();
+
+    private:
+        std::vector<std::unique_ptr<TaskQueue>> queues_;
+        std::vector<std::thread> workers_;
+
+        // tasks waiting in a queue
+        std::atomic<uint64_t> queued_{0};
+        // tasks waiting in a queue or running
+        std::atomic<uint64_t> pending_{0};
+        std::atomic<uint32_t> next_queue_{0};
+
+        std::mutex mutex_;
+        std::condition_variable work_available_;
+        std::condition_variable work_done_;
+        bool stop_{false};
+    };
+}
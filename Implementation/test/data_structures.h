@@ -1,8 +1,19 @@
 #pragma once
 
 #include "structures/art_benchmark.h"
-#include "structures/art_virt_benchmark.h"
-#include "structures/art_crtp_benchmark.h"
+#include "structures/art_loaded_benchmark.h"
+#include "structures/art_imported_benchmark.h"
+#include "structures/art_replica_benchmark.h"
+#include "structures/art_mapped_benchmark.h"
+#include "structures/art_paged_benchmark.h"
+#include "structures/art_persistent_benchmark.h"
+#include "structures/art_shared_benchmark.h"
+#include "structures/art_durable_benchmark.h"
+#include "structures/art_batch_benchmark.h"
+#include "structures/art_gather_benchmark.h"
+#include "structures/art_coroutine_benchmark.h"
+#include "structures/art_parallel_benchmark.h"
+#include "structures/art_swmr_benchmark.h"
 #include "structures/art_leis_benchmark.h"
 #include "structures/trie_benchmark.h"
 #include "structures/mtrie_benchmark.h"
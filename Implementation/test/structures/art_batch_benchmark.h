@@ -0,0 +1,78 @@
+#pragma once
+
+#include <memory>
+#include "../../data_structures/art/art.h"
+#include "../benchmark.h"
+
+/**
+ * Dispatch is the dispatch policy of the tree (see policy.h).
+ */
+template <class Dispatch = art::SwitchDispatch>
+class ArtBatchBenchmark : public Benchmark
+{
+public:
+    ~ArtBatchBenchmark() override
+    {
+        delete art_;
+    }
+
+    void InitializeStructure() override
+    {
+        art_ = new art::Art<uint32_t, Dispatch>();
+    }
+
+    void DeleteStructure() override
+    {
+        delete art_;
+        art_ = nullptr;
+    }
+
+    void Insert(const std::vector<uint32_t>& numbers) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+            art_->Insert(numbers[i]);
+    }
+
+    void Search(const std::vector<uint32_t>& numbers, std::vector<bool>& expected) override
+    {
+        const auto actual = std::make_unique<bool[]>(numbers.size());
+        art_->FindBatch(numbers, actual.get());
+
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+        {
+            if (actual[i] != expected[i])
+                std::cerr << "\033[1;31mART (Batch) Search error: expected " << expected[i] << " got " << !expected[i] << " number " << std::hex
+                    << numbers[i] << "\033[0m" << std::endl;
+        }
+    }
+
+    void RangeSearch(const std::vector<uint32_t>& numbers, std::vector<std::vector<uint32_t>>& expected) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); i += 2)
+        {
+            const auto actual = art_->FindRange(numbers[i], numbers[i + 1]);
+
+            if (actual.size() != expected[i / 2].size())
+                std::cerr << "\033[1;31mART (Batch) RangeSearch size error: expected " << expected[i / 2].size() << " got " << actual.size() <<
+                    " at set " << i / 2 << "\033[0m" << std::endl;
+
+            size_t j = 0;
+            for (; j < std::min(actual.size(), expected[i / 2].size()); ++j)
+                if (actual[j] != expected[i / 2][j])
+                    std::cerr << "\033[1;31mART (Batch) RangeSearch error: expected " << std::hex << expected[i / 2][j] << " got " << actual[j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+
+            if (actual.size() > expected[i / 2].size())
+                for (; j < actual.size(); ++j)
+                    std::cerr << "\033[1;31mART (Batch) RangeSearch error: actual left over " << std::hex << actual[j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+            else if (actual.size() < expected[i / 2].size())
+                for (; j < expected[i / 2].size(); ++j)
+                    std::cerr << "\033[1;31mART (Batch) RangeSearch error: expected left over " << std::hex << expected[i / 2][j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+        }
+    }
+
+private:
+    art::Art<uint32_t, Dispatch>* art_ = nullptr;
+};
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <algorithm>
+#include "../../data_structures/art/art.h"
+#include "../benchmark.h"
+
+class ArtCoroutineBenchmark : public Benchmark
+{
+public:
+    ~ArtCoroutineBenchmark() override
+    {
+        delete art_;
+    }
+
+    void InitializeStructure() override
+    {
+        art_ = new art::Art<>();
+    }
+
+    void DeleteStructure() override
+    {
+        delete art_;
+        art_ = nullptr;
+    }
+
+    void Insert(const std::vector<uint32_t>& numbers) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+            art_->Insert(numbers[i]);
+
+        keys_ = numbers;
+        std::ranges::sort(keys_);
+        keys_.erase(std::unique(keys_.begin(), keys_.end()), keys_.end());
+    }
+
+    void Search(const std::vector<uint32_t>& numbers, std::vector<bool>& expected) override
+    {
+        std::vector<bool> actual(numbers.size());
+        art::RunInterleaved<bool>(numbers.size(), 16,
+                                  [this, &numbers](const size_t i) { return art_->FindCoroutine(numbers[i]); },
+                                  [&actual](const size_t i, const bool found) { actual[i] = found; });
+
+        std::vector<std::optional<uint32_t>> lower_bounds(numbers.size());
+        art::RunInterleaved<std::optional<uint32_t>>(numbers.size(), 16,
+                                                     [this, &numbers](const size_t i) { return art_->LowerBoundCoroutine(numbers[i]); },
+                                                     [&lower_bounds](const size_t i, const std::optional<uint32_t> key) { lower_bounds[i] = key; });
+
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+        {
+            if (actual[i] != expected[i])
+                std::cerr << "\033[1;31mART (Coro) Search error: expected " << expected[i] << " got " << !expected[i] << " number " << std::hex
+                    << numbers[i] << "\033[0m" << std::endl;
+
+            const auto it = std::ranges::lower_bound(keys_, numbers[i]);
+            const std::optional<uint32_t> expected_lower_bound = it == keys_.end() ? std::nullopt : std::optional{*it};
+
+            if (lower_bounds[i] != expected_lower_bound || art_->LowerBound(numbers[i]) != expected_lower_bound)
+                std::cerr << "\033[1;31mART (Coro) LowerBound error: expected " << std::hex << expected_lower_bound.value_or(0) << " got "
+                    << lower_bounds[i].value_or(0) << " number " << numbers[i] << "\033[0m" << std::endl;
+        }
+    }
+
+    void RangeSearch(const std::vector<uint32_t>& numbers, std::vector<std::vector<uint32_t>>& expected) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); i += 2)
+        {
+            const auto actual = art_->FindRange(numbers[i], numbers[i + 1]);
+
+            if (actual.size() != expected[i / 2].size())
+                std::cerr << "\033[1;31mART (Coro) RangeSearch size error: expected " << expected[i / 2].size() << " got " << actual.size() <<
+                    " at set " << i / 2 << "\033[0m" << std::endl;
+
+            size_t j = 0;
+            for (; j < std::min(actual.size(), expected[i / 2].size()); ++j)
+                if (actual[j] != expected[i / 2][j])
+                    std::cerr << "\033[1;31mART (Coro) RangeSearch error: expected " << std::hex << expected[i / 2][j] << " got " << actual[j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+
+            if (actual.size() > expected[i / 2].size())
+                for (; j < actual.size(); ++j)
+                    std::cerr << "\033[1;31mART (Coro) RangeSearch error: actual left over " << std::hex << actual[j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+            else if (actual.size() < expected[i / 2].size())
+                for (; j < expected[i / 2].size(); ++j)
+                    std::cerr << "\033[1;31mART (Coro) RangeSearch error: expected left over " << std::hex << expected[i / 2][j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+        }
+    }
+
+private:
+    art::Art<>* art_ = nullptr;
+    // sorted inserted keys to verify lower bounds
+    std::vector<uint32_t> keys_;
+};
\ No newline at end of file
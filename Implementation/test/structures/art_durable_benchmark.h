@@ -0,0 +1,188 @@
+#pragma once
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include "../../data_structures/art/durable_art.h"
+#include "../benchmark.h"
+
+/**
+ * Logs all inserts (taking a forked checkpoint halfway) and searches in the tree recovered from the checkpoint and the
+ * log (see DurableArt). Right after the checkpoint started, the sealed log segment has to hold all inserts before it.
+ *
+ * Crashes are simulated by recovering copies of the directory: one taken while the forked checkpoint runs and one
+ * taken at the end whose last log group is cut in half (a torn write). Both have to recover exactly the keys of the
+ * complete groups.
+ */
+class ArtDurableBenchmark : public Benchmark
+{
+public:
+    ~ArtDurableBenchmark() override
+    {
+        DeleteStructure();
+    }
+
+    void InitializeStructure() override
+    {
+        art_ = new art::DurableArt<>();
+    }
+
+    void DeleteStructure() override
+    {
+        delete art_;
+        art_ = nullptr;
+
+        std::error_code error;
+        std::filesystem::remove_all(directory_, error);
+    }
+
+    void Insert(const std::vector<uint32_t>& numbers) override
+    {
+        std::error_code error;
+        std::filesystem::remove_all(directory_, error);
+
+        {
+            art::DurableArt<> logged;
+            const art::DurabilityOptions options{
+                art::SyncPolicy::kNone, 1024, numbers.size() / 2 + 1, art::CheckpointMode::kFork
+            };
+            if (!logged.Open(directory_, options))
+                std::cerr << "\033[1;31mART (Durable) error: couldn't open " << directory_ << "\033[0m" << std::endl;
+
+            for (uint32_t i = 0; i < numbers.size(); ++i)
+            {
+                logged.Insert(numbers[i]);
+
+                // the automatic checkpoint was started by this insert
+                if (i == numbers.size() / 2)
+                {
+                    logged.Sync();
+                    CheckSealedSegment(i + 1, options.batch_size);
+                    CheckCrashRecovery(numbers, i + 1, 0, "during the checkpoint");
+                }
+            }
+
+            // the keys after the checkpoint were committed in groups of batch_size keys and a last smaller one by Sync
+            logged.Sync();
+            const size_t logged_count = numbers.size() - (numbers.size() / 2 + 1);
+            const size_t last_group = logged_count % options.batch_size != 0 ? logged_count % options.batch_size : options.batch_size;
+            if (logged_count != 0)
+                CheckCrashRecovery(numbers, numbers.size() - last_group, last_group, "with a torn log group");
+        }
+
+        if (!art_->Open(directory_))
+            std::cerr << "\033[1;31mART (Durable) error: couldn't recover " << directory_ << "\033[0m" << std::endl;
+    }
+
+    void Search(const std::vector<uint32_t>& numbers, std::vector<bool>& expected) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+        {
+            if (art_->Find(numbers[i]) != expected[i])
+                std::cerr << "\033[1;31mART (Durable) Search error: expected " << expected[i] << " got " << !expected[i] << " number " << std::hex
+                    << numbers[i] << "\033[0m" << std::endl;
+        }
+    }
+
+    void RangeSearch(const std::vector<uint32_t>& numbers, std::vector<std::vector<uint32_t>>& expected) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); i += 2)
+        {
+            const auto actual = art_->GetTree().FindRange(numbers[i], numbers[i + 1]);
+
+            if (actual.size() != expected[i / 2].size())
+                std::cerr << "\033[1;31mART (Durable) RangeSearch size error: expected " << expected[i / 2].size() << " got " << actual.size() <<
+                    " at set " << i / 2 << "\033[0m" << std::endl;
+
+            size_t j = 0;
+            for (; j < std::min(actual.size(), expected[i / 2].size()); ++j)
+                if (actual[j] != expected[i / 2][j])
+                    std::cerr << "\033[1;31mART (Durable) RangeSearch error: expected " << std::hex << expected[i / 2][j] << " got " << actual[j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+
+            if (actual.size() > expected[i / 2].size())
+                for (; j < actual.size(); ++j)
+                    std::cerr << "\033[1;31mART (Durable) RangeSearch error: actual left over " << std::hex << actual[j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+            else if (actual.size() < expected[i / 2].size())
+                for (; j < expected[i / 2].size(); ++j)
+                    std::cerr << "\033[1;31mART (Durable) RangeSearch error: expected left over " << std::hex << expected[i / 2][j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+        }
+    }
+
+private:
+    /**
+     * Checks that the first log segment holds all count keys logged before the checkpoint in groups of batch_size
+     * keys. The segment is only removed once the parent notices that the checkpoint finished.
+     */
+    void CheckSealedSegment(const size_t count, const size_t batch_size) const
+    {
+        // 8 byte segment header, 8 byte group header and 4 byte keys (see durable_art.cpp)
+        const size_t groups = (count + batch_size - 1) / batch_size;
+        const uintmax_t expected = 8 + groups * 8 + count * sizeof(uint32_t);
+
+        std::error_code error;
+        const uintmax_t actual = std::filesystem::file_size(std::filesystem::path(directory_) / "wal.0.log", error);
+
+        if (error || actual != expected)
+            std::cerr << "\033[1;31mART (Durable) error: sealed log segment holds " << (error ? 0 : actual) << " bytes instead of "
+                << expected << "\033[0m" << std::endl;
+    }
+
+    /**
+     * Recovers a copy of the directory (in which the last group of the newest log segment holding torn_group keys is
+     * cut in half) and checks that it holds exactly the first count keys.
+     */
+    void CheckCrashRecovery(const std::vector<uint32_t>& numbers, const size_t count, const size_t torn_group,
+                            const std::string& crash) const
+    {
+        std::error_code error;
+        std::filesystem::remove_all(crash_directory_, error);
+        std::filesystem::copy(directory_, crash_directory_, error);
+        if (error)
+        {
+            std::cerr << "\033[1;31mART (Durable) error: couldn't copy " << directory_ << "\033[0m" << std::endl;
+            return;
+        }
+
+        if (torn_group != 0)
+        {
+            // segments are named wal.<generation>.log (see durable_art.cpp)
+            uint64_t newest = 0;
+            for (const auto& entry : std::filesystem::directory_iterator(crash_directory_))
+            {
+                const std::string name = entry.path().filename();
+                if (name.starts_with("wal."))
+                    newest = std::max<uint64_t>(newest, std::stoull(name.substr(4)));
+            }
+
+            const auto segment = std::filesystem::path(crash_directory_) / ("wal." + std::to_string(newest) + ".log");
+            std::filesystem::resize_file(segment, std::filesystem::file_size(segment) - torn_group * sizeof(uint32_t) / 2 - 1);
+        }
+
+        {
+            art::DurableArt<> recovered;
+            if (!recovered.Open(crash_directory_))
+                std::cerr << "\033[1;31mART (Durable) error: couldn't recover the copy " << crash << "\033[0m" << std::endl;
+            else
+            {
+                std::vector<uint32_t> committed(numbers.begin(), numbers.begin() + count);
+                std::ranges::sort(committed);
+
+                for (const uint32_t number : numbers)
+                {
+                    if (recovered.Find(number) != std::ranges::binary_search(committed, number))
+                        std::cerr << "\033[1;31mART (Durable) crash recovery error " << crash << ": expected " << !recovered.Find(number)
+                            << " got " << recovered.Find(number) << " number " << std::hex << number << "\033[0m" << std::endl;
+                }
+            }
+        }
+
+        std::filesystem::remove_all(crash_directory_, error);
+    }
+
+    art::DurableArt<>* art_ = nullptr;
+    const std::string directory_ = std::filesystem::temp_directory_path() / "art_durable_test";
+    const std::string crash_directory_ = std::filesystem::temp_directory_path() / "art_durable_crash_test";
+};
\ No newline at end of file
@@ -1,19 +1,20 @@
 #pragma once
 
-#include "../../data_structures/art_virt/art.h"
+#include <memory>
+#include "../../data_structures/art/art.h"
 #include "../benchmark.h"
 
-class ArtVirtBenchmark : public Benchmark
+class ArtGatherBenchmark : public Benchmark
 {
 public:
-    ~ArtVirtBenchmark() override
+    ~ArtGatherBenchmark() override
     {
         delete art_;
     }
 
     void InitializeStructure() override
     {
-        art_ = new art_virt::Art();
+        art_ = new art::Art<uint32_t, art::TaggedDispatch>();
     }
 
     void DeleteStructure() override
@@ -30,10 +31,13 @@ public:
 
     void Search(const std::vector<uint32_t>& numbers, std::vector<bool>& expected) override
     {
+        const auto actual = std::make_unique<bool[]>(numbers.size());
+        art_->FindBatchGather(numbers, actual.get());
+
         for (uint32_t i = 0; i < numbers.size(); ++i)
         {
-            if (art_->Find(numbers[i]) != expected[i])
-                std::cerr << "\033[1;31mART (EXP) Search error: expected " << expected[i] << " got " << !expected[i] << " number " << std::hex
+            if (actual[i] != expected[i])
+                std::cerr << "\033[1;31mART (Gather) Search error: expected " << expected[i] << " got " << !expected[i] << " number " << std::hex
                     << numbers[i] << "\033[0m" << std::endl;
         }
     }
@@ -45,26 +49,26 @@ public:
             const auto actual = art_->FindRange(numbers[i], numbers[i + 1]);
 
             if (actual.size() != expected[i / 2].size())
-                std::cerr << "\033[1;31mART (EXP) RangeSearch size error: expected " << expected[i / 2].size() << " got " << actual.size() <<
+                std::cerr << "\033[1;31mART (Gather) RangeSearch size error: expected " << expected[i / 2].size() << " got " << actual.size() <<
                     " at set " << i / 2 << "\033[0m" << std::endl;
 
             size_t j = 0;
             for (; j < std::min(actual.size(), expected[i / 2].size()); ++j)
                 if (actual[j] != expected[i / 2][j])
-                    std::cerr << "\033[1;31mART (EXP) RangeSearch error: expected " << std::hex << expected[i / 2][j] << " got " << actual[j] <<
+                    std::cerr << "\033[1;31mART (Gather) RangeSearch error: expected " << std::hex << expected[i / 2][j] << " got " << actual[j] <<
                         " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
 
             if (actual.size() > expected[i / 2].size())
                 for (; j < actual.size(); ++j)
-                    std::cerr << "\033[1;31mART (EXP) RangeSearch error: actual left over " << std::hex << actual[j] <<
+                    std::cerr << "\033[1;31mART (Gather) RangeSearch error: actual left over " << std::hex << actual[j] <<
                         " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
             else if (actual.size() < expected[i / 2].size())
                 for (; j < expected[i / 2].size(); ++j)
-                    std::cerr << "\033[1;31mART (EXP) RangeSearch error: expected left over " << std::hex << expected[i / 2][j] <<
+                    std::cerr << "\033[1;31mART (Gather) RangeSearch error: expected left over " << std::hex << expected[i / 2][j] <<
                         " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
         }
     }
 
 private:
-    art_virt::Art* art_ = nullptr;
+    art::Art<uint32_t, art::TaggedDispatch>* art_ = nullptr;
 };
\ No newline at end of file
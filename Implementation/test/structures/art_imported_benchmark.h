@@ -0,0 +1,81 @@
+#pragma once
+
+#include <filesystem>
+#include "../../data_structures/art/art.h"
+#include "../benchmark.h"
+
+/**
+ * Exports the keys inserted by Insert to a file and searches in the tree imported from it (see Art::Export and Art::Import).
+ */
+class ArtImportedBenchmark : public Benchmark
+{
+public:
+    ~ArtImportedBenchmark() override
+    {
+        delete art_;
+    }
+
+    void InitializeStructure() override
+    {
+        art_ = new art::Art<uint32_t>();
+    }
+
+    void DeleteStructure() override
+    {
+        delete art_;
+        art_ = nullptr;
+    }
+
+    void Insert(const std::vector<uint32_t>& numbers) override
+    {
+        art::Art<uint32_t> inserted;
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+            inserted.Insert(numbers[i]);
+
+        const auto path = std::filesystem::temp_directory_path() / "art_imported_test.keys";
+        if (!inserted.Export(path) || !art_->Import(path))
+            std::cerr << "\033[1;31mART (Imported) error: couldn't export and import " << path << "\033[0m" << std::endl;
+
+        std::filesystem::remove(path);
+    }
+
+    void Search(const std::vector<uint32_t>& numbers, std::vector<bool>& expected) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+        {
+            if (art_->Find(numbers[i]) != expected[i])
+                std::cerr << "\033[1;31mART (Imported) Search error: expected " << expected[i] << " got " << !expected[i] << " number " << std::hex
+                    << numbers[i] << "\033[0m" << std::endl;
+        }
+    }
+
+    void RangeSearch(const std::vector<uint32_t>& numbers, std::vector<std::vector<uint32_t>>& expected) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); i += 2)
+        {
+            const auto actual = art_->FindRange(numbers[i], numbers[i + 1]);
+
+            if (actual.size() != expected[i / 2].size())
+                std::cerr << "\033[1;31mART (Imported) RangeSearch size error: expected " << expected[i / 2].size() << " got " << actual.size() <<
+                    " at set " << i / 2 << "\033[0m" << std::endl;
+
+            size_t j = 0;
+            for (; j < std::min(actual.size(), expected[i / 2].size()); ++j)
+                if (actual[j] != expected[i / 2][j])
+                    std::cerr << "\033[1;31mART (Imported) RangeSearch error: expected " << std::hex << expected[i / 2][j] << " got " << actual[j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+
+            if (actual.size() > expected[i / 2].size())
+                for (; j < actual.size(); ++j)
+                    std::cerr << "\033[1;31mART (Imported) RangeSearch error: actual left over " << std::hex << actual[j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+            else if (actual.size() < expected[i / 2].size())
+                for (; j < expected[i / 2].size(); ++j)
+                    std::cerr << "\033[1;31mART (Imported) RangeSearch error: expected left over " << std::hex << expected[i / 2][j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+        }
+    }
+
+private:
+    art::Art<uint32_t>* art_ = nullptr;
+};
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <filesystem>
+#include "../../data_structures/art/mapped_art.h"
+#include "../benchmark.h"
+
+/**
+ * Writes the image of all inserted keys to a file and searches in the mapped image (see MappedArt). Search also checks
+ * LowerBound against the sorted keys.
+ */
+class ArtMappedBenchmark : public Benchmark
+{
+public:
+    ~ArtMappedBenchmark() override
+    {
+        DeleteStructure();
+    }
+
+    void InitializeStructure() override
+    {
+        art_ = new art::MappedArt<uint32_t>();
+    }
+
+    void DeleteStructure() override
+    {
+        delete art_;
+        art_ = nullptr;
+
+        std::error_code error;
+        std::filesystem::remove(path_, error);
+    }
+
+    void Insert(const std::vector<uint32_t>& numbers) override
+    {
+        keys_ = numbers;
+        std::ranges::sort(keys_);
+        keys_.erase(std::ranges::unique(keys_).begin(), keys_.end());
+
+        if (!art::MappedArt<uint32_t>::Write(path_, keys_) || !art_->Open(path_))
+            std::cerr << "\033[1;31mART (Mapped) error: couldn't write and map " << path_ << "\033[0m" << std::endl;
+    }
+
+    void Search(const std::vector<uint32_t>& numbers, std::vector<bool>& expected) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+        {
+            if (art_->Find(numbers[i]) != expected[i])
+                std::cerr << "\033[1;31mART (Mapped) Search error: expected " << expected[i] << " got " << !expected[i] << " number " << std::hex
+                    << numbers[i] << "\033[0m" << std::endl;
+
+            const auto it = std::ranges::lower_bound(keys_, numbers[i]);
+            const std::optional<uint32_t> expected_lower_bound = it == keys_.end() ? std::nullopt : std::optional{*it};
+
+            if (art_->LowerBound(numbers[i]) != expected_lower_bound)
+                std::cerr << "\033[1;31mART (Mapped) LowerBound error: expected " << std::hex << expected_lower_bound.value_or(0) << " got "
+                    << art_->LowerBound(numbers[i]).value_or(0) << " number " << numbers[i] << "\033[0m" << std::endl;
+        }
+    }
+
+    void RangeSearch(const std::vector<uint32_t>& numbers, std::vector<std::vector<uint32_t>>& expected) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); i += 2)
+        {
+            const auto actual = art_->FindRange(numbers[i], numbers[i + 1]);
+
+            if (actual.size() != expected[i / 2].size())
+                std::cerr << "\033[1;31mART (Mapped) RangeSearch size error: expected " << expected[i / 2].size() << " got " << actual.size() <<
+                    " at set " << i / 2 << "\033[0m" << std::endl;
+
+            size_t j = 0;
+            for (; j < std::min(actual.size(), expected[i / 2].size()); ++j)
+                if (actual[j] != expected[i / 2][j])
+                    std::cerr << "\033[1;31mART (Mapped) RangeSearch error: expected " << std::hex << expected[i / 2][j] << " got " << actual[j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+
+            if (actual.size() > expected[i / 2].size())
+                for (; j < actual.size(); ++j)
+                    std::cerr << "\033[1;31mART (Mapped) RangeSearch error: actual left over " << std::hex << actual[j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+            else if (actual.size() < expected[i / 2].size())
+                for (; j < expected[i / 2].size(); ++j)
+                    std::cerr << "\033[1;31mART (Mapped) RangeSearch error: expected left over " << std::hex << expected[i / 2][j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+        }
+    }
+
+private:
+    art::MappedArt<uint32_t>* art_ = nullptr;
+    std::vector<uint32_t> keys_;
+    const std::string path_ = std::filesystem::temp_directory_path() / "art_mapped_test.bin";
+};
\ No newline at end of file
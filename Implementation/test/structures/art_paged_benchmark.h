@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <filesystem>
+#include "../../data_structures/art/paged_art.h"
+#include "../benchmark.h"
+
+/**
+ * Builds the pages of the first half of the keys and inserts the second half one by one, with a buffer pool smaller
+ * than the pages (see PagedArt). Lookups and scans then keep evicting and reading pages. The pages are read through
+ * the page cache. The first kRandomInserts keys of the second half are inserted in their random order, so evicted
+ * pages still hold pending inserts, and the rest in ascending order, as random inserts into 16M keys would mostly
+ * wait for the disk.
+ */
+class ArtPagedBenchmark : public Benchmark
+{
+public:
+    ~ArtPagedBenchmark() override
+    {
+        DeleteStructure();
+    }
+
+    void InitializeStructure() override
+    {
+        art_ = new art::PagedArt<uint32_t>();
+    }
+
+    void DeleteStructure() override
+    {
+        delete art_;
+        art_ = nullptr;
+    }
+
+    void Insert(const std::vector<uint32_t>& numbers) override
+    {
+        CheckSiblingRewrite();
+
+        // 4 bytes per key while the pages need more than 8
+        if (!art_->Open(path_, numbers.size() * sizeof(uint32_t), false))
+            std::cerr << "\033[1;31mART (Paged) error: couldn't create " << path_ << "\033[0m" << std::endl;
+
+        std::vector<uint32_t> keys(numbers.begin(), numbers.begin() + numbers.size() / 2);
+        std::ranges::sort(keys);
+        keys.erase(std::ranges::unique(keys).begin(), keys.end());
+        if (!art_->Build(keys))
+            std::cerr << "\033[1;31mART (Paged) error: couldn't write the pages to " << path_ << "\033[0m" << std::endl;
+
+        const auto random_end = numbers.begin() + std::min(numbers.size(), numbers.size() / 2 + kRandomInserts);
+        keys.assign(numbers.begin() + numbers.size() / 2, random_end);
+        const auto sorted_begin = keys.insert(keys.end(), random_end, numbers.end());
+        std::sort(sorted_begin, keys.end());
+        for (const uint32_t key : keys)
+        {
+            if (!art_->Insert(key))
+                std::cerr << "\033[1;31mART (Paged) error: couldn't insert " << std::hex << key << std::dec << " into " << path_ << "\033[0m" << std::endl;
+        }
+    }
+
+    void Search(const std::vector<uint32_t>& numbers, std::vector<bool>& expected) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+        {
+            const auto found = art_->Find(numbers[i]);
+            if (!found)
+                std::cerr << "\033[1;31mART (Paged) Search error: couldn't read the page of " << std::hex << numbers[i] << "\033[0m" << std::endl;
+            else if (*found != expected[i])
+                std::cerr << "\033[1;31mART (Paged) Search error: expected " << expected[i] << " got " << !expected[i] << " number " << std::hex
+                    << numbers[i] << "\033[0m" << std::endl;
+        }
+    }
+
+    void RangeSearch(const std::vector<uint32_t>& numbers, std::vector<std::vector<uint32_t>>& expected) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); i += 2)
+        {
+            const auto scanned = art_->FindRange(numbers[i], numbers[i + 1]);
+            if (!scanned)
+            {
+                std::cerr << "\033[1;31mART (Paged) RangeSearch error: couldn't read the pages of set " << i / 2 << "\033[0m" << std::endl;
+                continue;
+            }
+
+            const auto& actual = *scanned;
+
+            if (actual.size() != expected[i / 2].size())
+                std::cerr << "\033[1;31mART (Paged) RangeSearch size error: expected " << expected[i / 2].size() << " got " << actual.size() <<
+                    " at set " << i / 2 << "\033[0m" << std::endl;
+
+            size_t j = 0;
+            for (; j < std::min(actual.size(), expected[i / 2].size()); ++j)
+                if (actual[j] != expected[i / 2][j])
+                    std::cerr << "\033[1;31mART (Paged) RangeSearch error: expected " << std::hex << expected[i / 2][j] << " got " << actual[j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+
+            if (actual.size() > expected[i / 2].size())
+                for (; j < actual.size(); ++j)
+                    std::cerr << "\033[1;31mART (Paged) RangeSearch error: actual left over " << std::hex << actual[j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+            else if (actual.size() < expected[i / 2].size())
+                for (; j < expected[i / 2].size(); ++j)
+                    std::cerr << "\033[1;31mART (Paged) RangeSearch error: expected left over " << std::hex << expected[i / 2][j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+        }
+    }
+
+private:
+    static constexpr size_t kRandomInserts = 1 << 17;
+
+    /**
+     * The keys of the test never leave a single key next to a paged subtree, so this builds a tree in which 0x010000xx
+     * to 0x01000Fxx fill pages of their own while 0x01001000 to 0x01001F00 are single keys, then inserts a second key
+     * next to each of those. Their new subtrees are added to the pages of their nearest siblings (see
+     * PagedArt::AddSubtree) while the buffer pool keeps evicting those pages.
+     */
+    void CheckSiblingRewrite() const
+    {
+        std::vector<uint32_t> keys;
+        for (uint32_t key = 0x01000000; key < 0x01001000; ++key)
+            keys.push_back(key);
+        for (uint32_t key = 0x01001000; key < 0x01002000; key += 0x100)
+            keys.push_back(key);
+
+        art::PagedArt<uint32_t> tree;
+        if (!tree.Open(sibling_path_, 2 * art::PagedArt<uint32_t>::kPageSize, false) || !tree.Build(keys))
+            std::cerr << "\033[1;31mART (Paged) error: couldn't write the pages to " << sibling_path_ << "\033[0m" << std::endl;
+
+        for (uint32_t key = 0x01001001; key < 0x01002000; key += 0x100)
+        {
+            keys.push_back(key);
+            if (!tree.Insert(key))
+                std::cerr << "\033[1;31mART (Paged) error: couldn't insert " << std::hex << key << std::dec << " into " << sibling_path_ << "\033[0m" << std::endl;
+        }
+        std::ranges::sort(keys);
+
+        for (uint32_t key = 0x01000000; key < 0x01002100; ++key)
+        {
+            const bool expected = std::ranges::binary_search(keys, key);
+            if (tree.Find(key) != expected)
+                std::cerr << "\033[1;31mART (Paged) sibling rewrite error: expected " << expected << " got " << !expected << " number "
+                    << std::hex << key << "\033[0m" << std::endl;
+        }
+
+        if (tree.FindRange(0, 0xFFFFFFFF) != keys)
+            std::cerr << "\033[1;31mART (Paged) sibling rewrite error: the range of all keys differs\033[0m" << std::endl;
+
+        tree.Close();
+        std::filesystem::remove(sibling_path_);
+    }
+
+    art::PagedArt<uint32_t>* art_ = nullptr;
+    const std::string path_ = std::filesystem::temp_directory_path() / "art_paged_test.pages";
+    const std::string sibling_path_ = std::filesystem::temp_directory_path() / "art_paged_sibling_test.pages";
+};
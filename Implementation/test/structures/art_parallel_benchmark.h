@@ -0,0 +1,77 @@
+#pragma once
+
+#include "../../data_structures/art/art.h"
+#include "../benchmark.h"
+
+class ArtParallelBenchmark : public Benchmark
+{
+public:
+    ~ArtParallelBenchmark() override
+    {
+        delete art_;
+    }
+
+    void InitializeStructure() override
+    {
+        art_ = nullptr;
+    }
+
+    void DeleteStructure() override
+    {
+        delete art_;
+        art_ = nullptr;
+    }
+
+    void Insert(const std::vector<uint32_t>& numbers) override
+    {
+        // bulk build the first half and merge the second half as a batch
+        const std::vector first(numbers.begin(), numbers.begin() + numbers.size() / 2);
+        const std::vector second(numbers.begin() + numbers.size() / 2, numbers.end());
+
+        art_ = new art::Art<>(first, pool_);
+        art_->InsertBatchParallel(second, pool_);
+    }
+
+    void Search(const std::vector<uint32_t>& numbers, std::vector<bool>& expected) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+        {
+            if (art_->Find(numbers[i]) != expected[i])
+                std::cerr << "\033[1;31mART (Parallel) Search error: expected " << expected[i] << " got " << !expected[i] << " number " << std::hex
+                    << numbers[i] << "\033[0m" << std::endl;
+        }
+    }
+
+    void RangeSearch(const std::vector<uint32_t>& numbers, std::vector<std::vector<uint32_t>>& expected) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); i += 2)
+        {
+            std::vector<uint32_t> actual;
+            for (const auto& chunk : art_->FindRangeParallel(numbers[i], numbers[i + 1], pool_))
+                actual.insert(actual.end(), chunk.begin(), chunk.end());
+
+            if (actual.size() != expected[i / 2].size())
+                std::cerr << "\033[1;31mART (Parallel) RangeSearch size error: expected " << expected[i / 2].size() << " got " << actual.size() <<
+                    " at set " << i / 2 << "\033[0m" << std::endl;
+
+            size_t j = 0;
+            for (; j < std::min(actual.size(), expected[i / 2].size()); ++j)
+                if (actual[j] != expected[i / 2][j])
+                    std::cerr << "\033[1;31mART (Parallel) RangeSearch error: expected " << std::hex << expected[i / 2][j] << " got " << actual[j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+
+            if (actual.size() > expected[i / 2].size())
+                for (; j < actual.size(); ++j)
+                    std::cerr << "\033[1;31mART (Parallel) RangeSearch error: actual left over " << std::hex << actual[j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+            else if (actual.size() < expected[i / 2].size())
+                for (; j < expected[i / 2].size(); ++j)
+                    std::cerr << "\033[1;31mART (Parallel) RangeSearch error: expected left over " << std::hex << expected[i / 2][j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+        }
+    }
+
+private:
+    art::Art<>* art_ = nullptr;
+    art::ThreadPool pool_;
+};
\ No newline at end of file
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>
+#include <filesystem>
+#include "../../data_structures/art/persistent_art.h"
+#include "../benchmark.h"
+
+/**
+ * Inserts all keys into a file-backed tree (syncing halfway) and searches in the tree reopened from the file (see
+ * PersistentArt). Before the writer closes (and syncs) the file, a copy of it is checked to hold exactly the keys
+ * synced halfway, like the file left behind by a crash.
+ */
+class ArtPersistentBenchmark : public Benchmark
+{
+public:
+    ~ArtPersistentBenchmark() override
+    {
+        DeleteStructure();
+    }
+
+    void InitializeStructure() override
+    {
+        art_ = new art::PersistentArt<uint32_t>();
+    }
+
+    void DeleteStructure() override
+    {
+        delete art_;
+        art_ = nullptr;
+
+        std::error_code error;
+        std::filesystem::remove(path_, error);
+    }
+
+    void Insert(const std::vector<uint32_t>& numbers) override
+    {
+        std::error_code error;
+        std::filesystem::remove(path_, error);
+
+        {
+            art::PersistentArt<uint32_t> writer;
+            if (!writer.Open(path_))
+                std::cerr << "\033[1;31mART (Persistent) error: couldn't create " << path_ << "\033[0m" << std::endl;
+
+            for (uint32_t i = 0; i < numbers.size(); ++i)
+            {
+                if (!writer.Insert(numbers[i]))
+                    std::cerr << "\033[1;31mART (Persistent) error: couldn't grow " << path_ << "\033[0m" << std::endl;
+
+                if (i == numbers.size() / 2)
+                    writer.Sync();
+            }
+
+            CheckCrashConsistency(numbers);
+        }
+
+        if (!art_->Open(path_))
+            std::cerr << "\033[1;31mART (Persistent) error: couldn't reopen " << path_ << "\033[0m" << std::endl;
+    }
+
+    void Search(const std::vector<uint32_t>& numbers, std::vector<bool>& expected) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+        {
+            if (art_->Find(numbers[i]) != expected[i])
+                std::cerr << "\033[1;31mART (Persistent) Search error: expected " << expected[i] << " got " << !expected[i] << " number " << std::hex
+                    << numbers[i] << "\033[0m" << std::endl;
+        }
+    }
+
+    void RangeSearch(const std::vector<uint32_t>& numbers, std::vector<std::vector<uint32_t>>& expected) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); i += 2)
+        {
+            const auto actual = art_->FindRange(numbers[i], numbers[i + 1]);
+
+            if (actual.size() != expected[i / 2].size())
+                std::cerr << "\033[1;31mART (Persistent) RangeSearch size error: expected " << expected[i / 2].size() << " got " << actual.size() <<
+                    " at set " << i / 2 << "\033[0m" << std::endl;
+
+            size_t j = 0;
+            for (; j < std::min(actual.size(), expected[i / 2].size()); ++j)
+                if (actual[j] != expected[i / 2][j])
+                    std::cerr << "\033[1;31mART (Persistent) RangeSearch error: expected " << std::hex << expected[i / 2][j] << " got " << actual[j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+
+            if (actual.size() > expected[i / 2].size())
+                for (; j < actual.size(); ++j)
+                    std::cerr << "\033[1;31mART (Persistent) RangeSearch error: actual left over " << std::hex << actual[j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+            else if (actual.size() < expected[i / 2].size())
+                for (; j < expected[i / 2].size(); ++j)
+                    std::cerr << "\033[1;31mART (Persistent) RangeSearch error: expected left over " << std::hex << expected[i / 2][j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+        }
+    }
+
+private:
+    /**
+     * Copies the file of the open writer (all inserts since the sync may have reached it, but not the header) and
+     * checks that the copy holds exactly the keys inserted up to the sync halfway.
+     */
+    void CheckCrashConsistency(const std::vector<uint32_t>& numbers)
+    {
+        std::error_code error;
+        if (!std::filesystem::copy_file(path_, crash_path_, std::filesystem::copy_options::overwrite_existing, error))
+        {
+            std::cerr << "\033[1;31mART (Persistent) error: couldn't copy " << path_ << "\033[0m" << std::endl;
+            return;
+        }
+
+        // the keys up to numbers[numbers.size() / 2] were synced
+        std::vector<uint32_t> synced(numbers.begin(), numbers.begin() + numbers.size() / 2 + 1);
+        std::ranges::sort(synced);
+        synced.erase(std::unique(synced.begin(), synced.end()), synced.end());
+
+        {
+            art::PersistentArt<uint32_t> crashed;
+            if (!crashed.Open(crash_path_))
+                std::cerr << "\033[1;31mART (Persistent) error: couldn't open the crashed copy " << crash_path_ << "\033[0m" << std::endl;
+            else
+            {
+                if (crashed.Size() != synced.size())
+                    std::cerr << "\033[1;31mART (Persistent) crash consistency error: expected " << synced.size() << " synced keys got "
+                        << crashed.Size() << "\033[0m" << std::endl;
+
+                for (const uint32_t number : numbers)
+                {
+                    if (crashed.Find(number) != std::ranges::binary_search(synced, number))
+                        std::cerr << "\033[1;31mART (Persistent) crash consistency error: expected " << !crashed.Find(number) << " got "
+                            << crashed.Find(number) << " number " << std::hex << number << "\033[0m" << std::endl;
+                }
+            }
+        }
+
+        std::filesystem::remove(crash_path_, error);
+    }
+
+    art::PersistentArt<uint32_t>* art_ = nullptr;
+    const std::string path_ = std::filesystem::temp_directory_path() / "art_persistent_test.bin";
+    const std::string crash_path_ = std::filesystem::temp_directory_path() / "art_persistent_crash_test.bin";
+};
\ No newline at end of file
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <filesystem>
+#include "../../data_structures/art/art.h"
+#include "../benchmark.h"
+
+/**
+ * Searches in a replica following the change feed of the tree built by Insert (see Art::EnableChangeFeed). The
+ * replica catches up only once during the first half of the keys, falling behind the feed for larger sizes so it
+ * continues from a snapshot, and then every kTailInterval keys.
+ *
+ * Right after that first catch-up the primary loads a tree holding all keys, which the caught-up replica must not miss
+ * by tailing the feed (the changes before the load don't apply to the new tree).
+ */
+class ArtReplicaBenchmark : public Benchmark
+{
+public:
+    ~ArtReplicaBenchmark() override
+    {
+        delete art_;
+    }
+
+    void InitializeStructure() override
+    {
+        art_ = new art::Art<uint32_t>();
+    }
+
+    void DeleteStructure() override
+    {
+        delete art_;
+        art_ = nullptr;
+    }
+
+    void Insert(const std::vector<uint32_t>& numbers) override
+    {
+        art::Art<uint32_t> primary;
+        primary.EnableChangeFeed(kFeedCapacity);
+
+        uint64_t position = 0;
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+        {
+            primary.Insert(numbers[i]);
+
+            if (i + 1 == numbers.size() / 2 || (i >= numbers.size() / 2 && (i + 1) % kTailInterval == 0))
+                CatchUp(primary, position);
+
+            if (i + 1 == numbers.size() / 2)
+                LoadAllKeys(primary, numbers, position);
+        }
+
+        CatchUp(primary, position);
+    }
+
+    void Search(const std::vector<uint32_t>& numbers, std::vector<bool>& expected) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+        {
+            if (art_->Find(numbers[i]) != expected[i])
+                std::cerr << "\033[1;31mART (Replica) Search error: expected " << expected[i] << " got " << !expected[i] << " number " << std::hex
+                    << numbers[i] << "\033[0m" << std::endl;
+        }
+    }
+
+    void RangeSearch(const std::vector<uint32_t>& numbers, std::vector<std::vector<uint32_t>>& expected) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); i += 2)
+        {
+            const auto actual = art_->FindRange(numbers[i], numbers[i + 1]);
+
+            if (actual.size() != expected[i / 2].size())
+                std::cerr << "\033[1;31mART (Replica) RangeSearch size error: expected " << expected[i / 2].size() << " got " << actual.size() <<
+                    " at set " << i / 2 << "\033[0m" << std::endl;
+
+            size_t j = 0;
+            for (; j < std::min(actual.size(), expected[i / 2].size()); ++j)
+                if (actual[j] != expected[i / 2][j])
+                    std::cerr << "\033[1;31mART (Replica) RangeSearch error: expected " << std::hex << expected[i / 2][j] << " got " << actual[j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+
+            if (actual.size() > expected[i / 2].size())
+                for (; j < actual.size(); ++j)
+                    std::cerr << "\033[1;31mART (Replica) RangeSearch error: actual left over " << std::hex << actual[j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+            else if (actual.size() < expected[i / 2].size())
+                for (; j < expected[i / 2].size(); ++j)
+                    std::cerr << "\033[1;31mART (Replica) RangeSearch error: expected left over " << std::hex << expected[i / 2][j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+        }
+    }
+
+private:
+    static constexpr size_t kFeedCapacity = 1 << 16;
+    static constexpr uint32_t kTailInterval = 1 << 14;
+
+    /**
+     * Replaces the tree of the primary by one holding all keys while the replica is caught up at position.
+     */
+    void LoadAllKeys(art::Art<uint32_t>& primary, const std::vector<uint32_t>& numbers, const uint64_t position)
+    {
+        const auto path = std::filesystem::temp_directory_path() / "art_replica_test.art";
+
+        art::Art<uint32_t> all;
+        for (const uint32_t number : numbers)
+            all.Insert(number);
+
+        if (!all.Save(path) || !primary.Load(path))
+            std::cerr << "\033[1;31mART (Replica) error: couldn't save and load " << path << "\033[0m" << std::endl;
+
+        std::vector<art::Change<uint32_t>> changes;
+        if (primary.GetChangeFeed()->Read(position, changes))
+            std::cerr << "\033[1;31mART (Replica) error: a caught-up replica can still tail the feed after Load\033[0m" << std::endl;
+
+        std::filesystem::remove(path);
+    }
+
+    /**
+     * Inserts the changes after position into the replica or imports a snapshot if they were overwritten.
+     */
+    void CatchUp(const art::Art<uint32_t>& primary, uint64_t& position)
+    {
+        std::vector<art::Change<uint32_t>> changes;
+
+        if (primary.GetChangeFeed()->Read(position, changes))
+        {
+            for (const auto& change : changes)
+                art_->Insert(change.key);
+
+            if (!changes.empty())
+                position = changes.back().sequence;
+
+            return;
+        }
+
+        const auto path = std::filesystem::temp_directory_path() / "art_replica_test.keys";
+        const auto sequence = primary.ExportSnapshot(path);
+
+        if (!sequence || !art_->Import(path))
+            std::cerr << "\033[1;31mART (Replica) error: couldn't export and import the snapshot " << path << "\033[0m" << std::endl;
+        else
+            position = *sequence;
+
+        std::filesystem::remove(path);
+    }
+
+    art::Art<uint32_t>* art_ = nullptr;
+};
\ No newline at end of file
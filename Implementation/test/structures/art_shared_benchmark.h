@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include "../../data_structures/art/shared_art.h"
+#include "../benchmark.h"
+
+/**
+ * Inserts all keys into a tree in a shared memory segment and searches through a separate read-only mapping of it
+ * (see SharedArt). While inserting, another thread searches and scans the keys inserted so far through a third mapping.
+ */
+class ArtSharedBenchmark : public Benchmark
+{
+public:
+    ~ArtSharedBenchmark() override
+    {
+        DeleteStructure();
+    }
+
+    void InitializeStructure() override
+    {
+        writer_ = new art::SharedArt<uint32_t>();
+        art_ = new art::SharedArtReader<uint32_t>();
+    }
+
+    void DeleteStructure() override
+    {
+        delete art_;
+        art_ = nullptr;
+        delete writer_;
+        writer_ = nullptr;
+
+        art::SharedArt<uint32_t>::Remove(name_);
+    }
+
+    void Insert(const std::vector<uint32_t>& numbers) override
+    {
+        // small extents so the segment grows (and the reader remaps it) while the reader searches
+        if (!writer_->Create(name_, kTestExtentSize) || !art_->Open(name_))
+            std::cerr << "\033[1;31mART (Shared) error: couldn't create and map " << name_ << "\033[0m" << std::endl;
+
+        std::vector<uint32_t> sorted(numbers);
+        std::ranges::sort(sorted);
+
+        // number of keys whose insert has completed
+        std::atomic<uint32_t> inserted{0};
+        std::atomic<bool> done{false};
+
+        std::thread reader([&]
+        {
+            // the reader searches through its own read-only mapping of the segment
+            art::SharedArtReader<uint32_t> view;
+            if (!view.Open(name_))
+                std::cerr << "\033[1;31mART (Shared) error: couldn't map " << name_ << " concurrently\033[0m" << std::endl;
+
+            for (uint32_t i = 0; !done.load(std::memory_order_acquire); i = i * 1'103'515'245 + 12'345)
+            {
+                const uint32_t count = inserted.load(std::memory_order_acquire);
+                if (count == 0)
+                    continue;
+
+                const uint32_t key = numbers[i % count];
+                if (!view.Find(key))
+                    std::cerr << "\033[1;31mART (Shared) concurrent Search error: missing " << std::hex << key << "\033[0m" << std::endl;
+
+                const uint32_t from = key - std::min(key, kConcurrentRange);
+                const uint32_t to = key + std::min(~key, kConcurrentRange);
+                const auto scanned = view.FindRange(from, to);
+                if (!scanned)
+                {
+                    std::cerr << "\033[1;31mART (Shared) error: couldn't remap " << name_ << " concurrently\033[0m" << std::endl;
+                    continue;
+                }
+
+                const auto& range = *scanned;
+                if (!std::ranges::is_sorted(range) || !std::ranges::binary_search(range, key) ||
+                    !std::ranges::all_of(range, [&](const uint32_t k) { return std::ranges::binary_search(sorted, k); }))
+                    std::cerr << "\033[1;31mART (Shared) concurrent RangeSearch error: around " << std::hex << key << "\033[0m" << std::endl;
+            }
+        });
+
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+        {
+            if (!writer_->Insert(numbers[i]))
+                std::cerr << "\033[1;31mART (Shared) error: couldn't grow " << name_ << "\033[0m" << std::endl;
+
+            inserted.store(i + 1, std::memory_order_release);
+
+            // lets the reader interleave with the writer even on a single core
+            if (i % 1024 == 0)
+                std::this_thread::yield();
+        }
+
+        done.store(true, std::memory_order_release);
+        reader.join();
+    }
+
+    void Search(const std::vector<uint32_t>& numbers, std::vector<bool>& expected) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+        {
+            if (art_->Find(numbers[i]) != expected[i])
+                std::cerr << "\033[1;31mART (Shared) Search error: expected " << expected[i] << " got " << !expected[i] << " number " << std::hex
+                    << numbers[i] << "\033[0m" << std::endl;
+        }
+    }
+
+    void RangeSearch(const std::vector<uint32_t>& numbers, std::vector<std::vector<uint32_t>>& expected) override
+    {
+        for (uint32_t i = 0; i < numbers.size(); i += 2)
+        {
+            const auto scanned = art_->FindRange(numbers[i], numbers[i + 1]);
+            if (!scanned)
+            {
+                std::cerr << "\033[1;31mART (Shared) RangeSearch error: couldn't remap " << name_ << " at set " << i / 2 << "\033[0m" << std::endl;
+                continue;
+            }
+
+            const auto& actual = *scanned;
+
+            if (actual.size() != expected[i / 2].size())
+                std::cerr << "\033[1;31mART (Shared) RangeSearch size error: expected " << expected[i / 2].size() << " got " << actual.size() <<
+                    " at set " << i / 2 << "\033[0m" << std::endl;
+
+            size_t j = 0;
+            for (; j < std::min(actual.size(), expected[i / 2].size()); ++j)
+                if (actual[j] != expected[i / 2][j])
+                    std::cerr << "\033[1;31mART (Shared) RangeSearch error: expected " << std::hex << expected[i / 2][j] << " got " << actual[j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+
+            if (actual.size() > expected[i / 2].size())
+                for (; j < actual.size(); ++j)
+                    std::cerr << "\033[1;31mART (Shared) RangeSearch error: actual left over " << std::hex << actual[j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+            else if (actual.size() < expected[i / 2].size())
+                for (; j < expected[i / 2].size(); ++j)
+                    std::cerr << "\033[1;31mART (Shared) RangeSearch error: expected left over " << std::hex << expected[i / 2][j] <<
+                        " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
+        }
+    }
+
+private:
+    static constexpr size_t kTestExtentSize = 1 << 20;
+    // keys around a searched key scanned by the concurrent reader
+    static constexpr uint32_t kConcurrentRange = 1 << 16;
+
+    art::SharedArt<uint32_t>* writer_ = nullptr;
+    art::SharedArtReader<uint32_t>* art_ = nullptr;
+    const std::string name_ = "/art_shared_test";
+};
\ No newline at end of file
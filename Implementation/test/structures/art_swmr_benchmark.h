@@ -1,19 +1,19 @@
 #pragma once
 
-#include "../../data_structures/art_crtp/art.h"
+#include "../../data_structures/art/art.h"
 #include "../benchmark.h"
 
-class ArtCRTPBenchmark : public Benchmark
+class ArtSwmrBenchmark : public Benchmark
 {
 public:
-    ~ArtCRTPBenchmark() override
+    ~ArtSwmrBenchmark() override
     {
         delete art_;
     }
 
     void InitializeStructure() override
     {
-        art_ = new art_crtp::Art();
+        art_ = new art::Art<>();
     }
 
     void DeleteStructure() override
@@ -25,15 +25,17 @@ public:
     void Insert(const std::vector<uint32_t>& numbers) override
     {
         for (uint32_t i = 0; i < numbers.size(); ++i)
-            art_->Insert(numbers[i]);
+            art_->InsertConcurrent(numbers[i]);
     }
 
     void Search(const std::vector<uint32_t>& numbers, std::vector<bool>& expected) override
     {
+        const art::EpochGuard session;
+
         for (uint32_t i = 0; i < numbers.size(); ++i)
         {
-            if (art_->Find(numbers[i]) != expected[i])
-                std::cerr << "\033[1;31mART (EXP) Search error: expected " << expected[i] << " got " << !expected[i] << " number " << std::hex
+            if (art_->FindConcurrent(numbers[i], session) != expected[i])
+                std::cerr << "\033[1;31mART (SWMR) Search error: expected " << expected[i] << " got " << !expected[i] << " number " << std::hex
                     << numbers[i] << "\033[0m" << std::endl;
         }
     }
@@ -45,26 +47,26 @@ public:
             const auto actual = art_->FindRange(numbers[i], numbers[i + 1]);
 
             if (actual.size() != expected[i / 2].size())
-                std::cerr << "\033[1;31mART (EXP) RangeSearch size error: expected " << expected[i / 2].size() << " got " << actual.size() <<
+                std::cerr << "\033[1;31mART (SWMR) RangeSearch size error: expected " << expected[i / 2].size() << " got " << actual.size() <<
                     " at set " << i / 2 << "\033[0m" << std::endl;
 
             size_t j = 0;
             for (; j < std::min(actual.size(), expected[i / 2].size()); ++j)
                 if (actual[j] != expected[i / 2][j])
-                    std::cerr << "\033[1;31mART (EXP) RangeSearch error: expected " << std::hex << expected[i / 2][j] << " got " << actual[j] <<
+                    std::cerr << "\033[1;31mART (SWMR) RangeSearch error: expected " << std::hex << expected[i / 2][j] << " got " << actual[j] <<
                         " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
 
             if (actual.size() > expected[i / 2].size())
                 for (; j < actual.size(); ++j)
-                    std::cerr << "\033[1;31mART (EXP) RangeSearch error: actual left over " << std::hex << actual[j] <<
+                    std::cerr << "\033[1;31mART (SWMR) RangeSearch error: actual left over " << std::hex << actual[j] <<
                         " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
             else if (actual.size() < expected[i / 2].size())
                 for (; j < expected[i / 2].size(); ++j)
-                    std::cerr << "\033[1;31mART (EXP) RangeSearch error: expected left over " << std::hex << expected[i / 2][j] <<
+                    std::cerr << "\033[1;31mART (SWMR) RangeSearch error: expected left over " << std::hex << expected[i / 2][j] <<
                         " at position " << std::dec << j << " of set " << i / 2 << "\033[0m" << std::endl;
         }
     }
 
 private:
-    art_crtp::Art* art_ = nullptr;
+    art::Art<>* art_ = nullptr;
 };
\ No newline at end of file
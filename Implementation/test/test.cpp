@@ -14,9 +14,26 @@
 const std::vector<std::tuple<std::string, uint8_t, Benchmark*>> kIndexStructures{
     // Do Sorted List first as it's results will be used to test the other structures
     {"Sorted List", 1, new SortedListBenchmark()},
-    {"ART", 2, new ArtBenchmark()},
-    {"ART (Virt)", 1, new ArtVirtBenchmark()},
-    {"ART (CRTP)", 1, new ArtCRTPBenchmark()},
+    {"ART", 2, new ArtBenchmark<>()},
+    {"ART (Batch)", 1, new ArtBatchBenchmark<>()},
+    {"ART (Batch Virtual)", 1, new ArtBatchBenchmark<art::VirtualDispatch>()},
+    {"ART (Gather)", 1, new ArtGatherBenchmark()},
+    {"ART (Coro)", 1, new ArtCoroutineBenchmark()},
+    {"ART (Parallel)", 1, new ArtParallelBenchmark()},
+    {"ART (SWMR)", 1, new ArtSwmrBenchmark()},
+    {"ART (Static)", 1, new ArtBenchmark<art::StaticDispatch>()},
+    {"ART (Virtual)", 1, new ArtBenchmark<art::VirtualDispatch>()},
+    {"ART (Tagged)", 1, new ArtBenchmark<art::TaggedDispatch>()},
+    {"ART (16 bit)", 1, new ArtBenchmark<art::SwitchDispatch, uint16_t>()},
+    {"ART (64 bit)", 1, new ArtBenchmark<art::SwitchDispatch, uint64_t>()},
+    {"ART (Loaded)", 1, new ArtLoadedBenchmark()},
+    {"ART (Imported)", 1, new ArtImportedBenchmark()},
+    {"ART (Replica)", 1, new ArtReplicaBenchmark()},
+    {"ART (Mapped)", 1, new ArtMappedBenchmark()},
+    {"ART (Paged)", 1, new ArtPagedBenchmark()},
+    {"ART (Persistent)", 1, new ArtPersistentBenchmark()},
+    {"ART (Shared)", 1, new ArtSharedBenchmark()},
+    {"ART (Durable)", 1, new ArtDurableBenchmark()},
     {"ART (Leis)", 1, new ArtLeisBenchmark()},
     //{"Trie", 2, new TrieBenchmark()},
     //{"M-Trie", 2, new MTrieBenchmark()},
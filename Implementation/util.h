@@ -35,21 +35,69 @@ __forceinline __m128i _mm_cmplt_epu8(const __m128i a, const __m128i b)
 #endif
 
 /**
- * __ctz(uint16_t val)
+ * __target(isa)
  *
- * Counts trailing zeros.
+ * Compiles a function for a given instruction set (e.g. "avx2") independent of the global compiler flags.
+ * The caller has to make sure the CPU supports it. MSVC allows all intrinsics without any flags.
  */
 #ifdef __GNUC__ // GCC 4.8+, Clang, Intel and other compilers compatible with GCC (-std=c++0x or above)
-inline __attribute__((always_inline)) unsigned __ctz(uint16_t val) { return __builtin_ctz(val); }
+#define __target(isa) __attribute__((target(isa)))
 #elif defined(_MSC_VER) // MSVC
+#define __target(isa)
+#endif
+
+/**
+ * __noinline
+ *
+ * Prevents a function from being inlined into its callers.
+ */
+#ifdef __GNUC__ // GCC 4.8+, Clang, Intel and other compilers compatible with GCC (-std=c++0x or above)
+#define __noinline __attribute__((noinline))
+#elif defined(_MSC_VER) // MSVC
+#define __noinline __declspec(noinline)
+#endif
 
-__forceinline unsigned __ctz(const uint16_t val)
+/**
+ * __forceinline
+ *
+ * Inlines a function into its callers even if the compiler wouldn't do so on its own.
+ */
+#ifdef __GNUC__ // GCC 4.8+, Clang, Intel and other compilers compatible with GCC (-std=c++0x or above)
+#define __forceinline inline __attribute__((always_inline))
+#endif
+
+/**
+ * __ctz(uint32_t val)
+ *
+ * Counts trailing zeros (val must not be 0).
+ */
+#ifdef __GNUC__ // GCC 4.8+, Clang, Intel and other compilers compatible with GCC (-std=c++0x or above)
+inline __attribute__((always_inline)) unsigned __ctz(uint32_t val) { return __builtin_ctz(val); }
+#elif defined(_MSC_VER) // MSVC
+
+__forceinline unsigned __ctz(const uint32_t val)
 {
     return _tzcnt_u32(val);
 }
 
 #endif
 
+/**
+ * __ctz64(uint64_t val)
+ *
+ * Counts trailing zeros of a 64 bit integer (val must not be 0).
+ */
+#ifdef __GNUC__ // GCC 4.8+, Clang, Intel and other compilers compatible with GCC (-std=c++0x or above)
+inline __attribute__((always_inline)) unsigned __ctz64(uint64_t val) { return __builtin_ctzll(val); }
+#elif defined(_MSC_VER) // MSVC
+
+__forceinline unsigned __ctz64(const uint64_t val)
+{
+    return static_cast<unsigned>(_tzcnt_u64(val));
+}
+
+#endif
+
 /**
  * __unreachable()
  *